@@ -0,0 +1,74 @@
+/**
+ * @file core/math/lazy_regularization.hpp
+ *
+ * Utilities for computing gradients of linear models on sparse data, where
+ * only the coordinates touched by a batch of points are updated.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_MATH_LAZY_REGULARIZATION_HPP
+#define MLPACK_CORE_MATH_LAZY_REGULARIZATION_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace math {
+
+/**
+ * Compute the product of the given data points (one per column) and the
+ * transpose of the given dense coefficient matrix, storing the result as a
+ * sparse matrix.  When the data is sparse, the result has nonzeros only in the
+ * rows (features) that appear in the data, and the cost scales with the number
+ * of nonzeros in the data rather than its dimensionality.
+ *
+ * @param data Data points, one per column (d x n).
+ * @param coefficients Coefficients for each point (k x n).
+ * @param result Sparse output matrix (d x k).
+ */
+template<typename MatType, typename eT>
+void SparseGradientProduct(const MatType& data,
+                           const arma::Mat<eT>& coefficients,
+                           arma::SpMat<eT>& result)
+{
+  result = arma::SpMat<eT>(data) * arma::SpMat<eT>(coefficients.t());
+}
+
+/**
+ * Add an L2 penalty of lambda * parameters to the nonzero elements of the
+ * given sparse gradient, leaving every other coordinate untouched.  This is
+ * the usual lazy regularization used for SGD on sparse data: a coordinate is
+ * only shrunk in the steps where it receives a gradient from the data, so
+ * each step costs time proportional to the number of nonzeros in the batch.
+ *
+ * @param gradient Sparse gradient to regularize.
+ * @param parameters Current parameters (same size as the gradient).
+ * @param lambda Regularization strength.
+ */
+template<typename eT, typename MatType>
+void LazyL2Regularize(arma::SpMat<eT>& gradient,
+                      const MatType& parameters,
+                      const double lambda)
+{
+  if (lambda == 0.0)
+    return;
+
+  // Walk the CSC storage directly; going through the element proxies could
+  // remove elements that become zero and invalidate the iteration.
+  gradient.sync();
+  for (size_t c = 0; c < gradient.n_cols; ++c)
+  {
+    for (size_t i = gradient.col_ptrs[c]; i < gradient.col_ptrs[c + 1]; ++i)
+    {
+      arma::access::rw(gradient.values[i]) += lambda *
+          parameters(gradient.row_indices[i], c);
+    }
+  }
+}
+
+} // namespace math
+} // namespace mlpack
+
+#endif
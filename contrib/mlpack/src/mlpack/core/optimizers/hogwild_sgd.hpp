@@ -0,0 +1,169 @@
+/**
+ * @file core/optimizers/hogwild_sgd.hpp
+ *
+ * Lock-free parallel stochastic gradient descent (Hogwild!) for separable
+ * functions with sparse gradients, such as the objective functions of the
+ * linear classifiers.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_HOGWILD_SGD_HPP
+#define MLPACK_CORE_OPTIMIZERS_HOGWILD_SGD_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <ensmallen.hpp>
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * An implementation of the lock-free parallel stochastic gradient descent
+ * scheme known as Hogwild!.  Every thread repeatedly takes a single function
+ * (i.e. a single data point), computes its sparse gradient, and subtracts it
+ * from the shared iterate without taking any locks.  Because each point only
+ * touches a few coordinates of the iterate, collisions between threads are
+ * rare and the updates scale with the number of threads.  For more
+ * information, see the following:
+ *
+ * @code
+ * @inproceedings{niu2011hogwild,
+ *   title={Hogwild!: A lock-free approach to parallelizing stochastic gradient
+ *       descent},
+ *   author={Niu, Feng and Recht, Benjamin and R{\'e}, Christopher and
+ *       Wright, Stephen J.},
+ *   booktitle={Advances in Neural Information Processing Systems},
+ *   pages={693--701},
+ *   year={2011}
+ * }
+ * @endcode
+ *
+ * The functions are split into one contiguous shard per thread.  Each shard
+ * has its own random number generator, seeded from the given seed and the
+ * index of the shard, and is reshuffled with it at the start of every epoch.
+ * Therefore the order in which each thread visits its points is reproducible
+ * and does not depend on (or advance) mlpack's global random number
+ * generator; with a single thread the whole optimization is deterministic.
+ *
+ * The given function must implement the following methods:
+ *
+ * @code
+ * size_t NumFunctions();
+ * double Evaluate(const arma::mat& coordinates);
+ * void Gradient(const arma::mat& coordinates,
+ *               const size_t i,
+ *               arma::sp_mat& gradient,
+ *               const size_t batchSize);
+ * @endcode
+ *
+ * This is the case for LogisticRegressionFunction, SoftmaxRegressionFunction
+ * and LinearSVMFunction, so HogwildSGD can be passed to the Train() overloads
+ * of LogisticRegression, SoftmaxRegression and LinearSVM that take an
+ * instantiated optimizer:
+ *
+ * @code
+ * HogwildSGD hogwild(0.01, 50);
+ * LogisticRegression<arma::sp_mat> lr;
+ * lr.Train(data, labels, hogwild);
+ * @endcode
+ *
+ * ensmallen callbacks are supported, with the exception of those that modify
+ * the gradient (the gradient is never stored as a whole).
+ */
+class HogwildSGD
+{
+ public:
+  /**
+   * Construct the HogwildSGD optimizer with the given parameters.
+   *
+   * @param stepSize Step size for each update.
+   * @param maxEpochs Maximum number of passes over the data (0 means no limit).
+   * @param tolerance Maximum absolute change in the objective between two
+   *     epochs for the optimization to be considered converged.
+   * @param shuffle If true, each thread visits its points in a random order
+   *     that is redrawn every epoch.
+   * @param seed Seed for the per-thread random number generators.
+   * @param numThreads Number of threads to use (0 uses the OpenMP default).
+   */
+  HogwildSGD(const double stepSize = 0.01,
+             const size_t maxEpochs = 100,
+             const double tolerance = 1e-5,
+             const bool shuffle = true,
+             const size_t seed = 0,
+             const size_t numThreads = 0);
+
+  /**
+   * Optimize the given function, starting from (and storing the result in)
+   * the given iterate.
+   *
+   * @param function Function to optimize.
+   * @param iterate Starting point; overwritten with the final point.
+   * @param callbacks Callback functions.
+   * @return Objective value at the final point.
+   */
+  template<typename SparseFunctionType,
+           typename MatType,
+           typename... CallbackTypes>
+  typename MatType::elem_type Optimize(SparseFunctionType& function,
+                                       MatType& iterate,
+                                       CallbackTypes&&... callbacks);
+
+  //! Get the step size.
+  double StepSize() const { return stepSize; }
+  //! Modify the step size.
+  double& StepSize() { return stepSize; }
+
+  //! Get the maximum number of epochs (0 indicates no limit).
+  size_t MaxEpochs() const { return maxEpochs; }
+  //! Modify the maximum number of epochs (0 indicates no limit).
+  size_t& MaxEpochs() { return maxEpochs; }
+
+  //! Get the tolerance for termination.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance for termination.
+  double& Tolerance() { return tolerance; }
+
+  //! Get whether or not the points are shuffled every epoch.
+  bool Shuffle() const { return shuffle; }
+  //! Modify whether or not the points are shuffled every epoch.
+  bool& Shuffle() { return shuffle; }
+
+  //! Get the seed of the per-thread random number generators.
+  size_t Seed() const { return seed; }
+  //! Modify the seed of the per-thread random number generators.
+  size_t& Seed() { return seed; }
+
+  //! Get the number of threads (0 means the OpenMP default).
+  size_t NumThreads() const { return numThreads; }
+  //! Modify the number of threads (0 means the OpenMP default).
+  size_t& NumThreads() { return numThreads; }
+
+ private:
+  //! The step size for each update.
+  double stepSize;
+
+  //! The maximum number of epochs.
+  size_t maxEpochs;
+
+  //! The tolerance for termination.
+  double tolerance;
+
+  //! Whether or not to shuffle the points every epoch.
+  bool shuffle;
+
+  //! The seed of the per-thread random number generators.
+  size_t seed;
+
+  //! The number of threads to use.
+  size_t numThreads;
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+// Include implementation.
+#include "hogwild_sgd_impl.hpp"
+
+#endif
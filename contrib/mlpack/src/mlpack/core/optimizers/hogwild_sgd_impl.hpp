@@ -0,0 +1,143 @@
+/**
+ * @file core/optimizers/hogwild_sgd_impl.hpp
+ *
+ * Implementation of the HogwildSGD optimizer.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_HOGWILD_SGD_IMPL_HPP
+#define MLPACK_CORE_OPTIMIZERS_HOGWILD_SGD_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "hogwild_sgd.hpp"
+
+#include <random>
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+namespace mlpack {
+namespace optimization {
+
+inline HogwildSGD::HogwildSGD(const double stepSize,
+                              const size_t maxEpochs,
+                              const double tolerance,
+                              const bool shuffle,
+                              const size_t seed,
+                              const size_t numThreads) :
+    stepSize(stepSize),
+    maxEpochs(maxEpochs),
+    tolerance(tolerance),
+    shuffle(shuffle),
+    seed(seed),
+    numThreads(numThreads)
+{
+  // Nothing to do.
+}
+
+template<typename SparseFunctionType,
+         typename MatType,
+         typename... CallbackTypes>
+typename MatType::elem_type HogwildSGD::Optimize(
+    SparseFunctionType& function,
+    MatType& iterate,
+    CallbackTypes&&... callbacks)
+{
+  typedef typename MatType::elem_type ElemType;
+
+  const size_t numFunctions = function.NumFunctions();
+
+  size_t numShards = 1;
+  #ifdef HAS_OPENMP
+    numShards = (numThreads == 0) ? (size_t) omp_get_max_threads() :
+        numThreads;
+  #endif
+  numShards = std::max(size_t(1), std::min(numShards, numFunctions));
+
+  // Split the functions into one contiguous shard per thread, and give each
+  // shard its own generator.  The shards are independent of how OpenMP
+  // schedules them, so the visitation order only depends on the seed.
+  std::vector<arma::Col<size_t>> shards(numShards);
+  std::vector<std::mt19937_64> generators(numShards);
+  for (size_t s = 0; s < numShards; ++s)
+  {
+    const size_t begin = s * numFunctions / numShards;
+    const size_t end = (s + 1) * numFunctions / numShards;
+    if (end > begin)
+      shards[s] = arma::regspace<arma::Col<size_t>>(begin, end - 1);
+
+    std::seed_seq seq{ (uint32_t) seed, (uint32_t) (uint64_t(seed) >> 32),
+        (uint32_t) s };
+    generators[s].seed(seq);
+  }
+
+  bool terminate = ens::Callback::BeginOptimization(*this, function, iterate,
+      callbacks...);
+
+  ElemType overallObjective = function.Evaluate(iterate);
+  ElemType lastObjective = DBL_MAX;
+  for (size_t epoch = 1; (epoch <= maxEpochs || maxEpochs == 0) &&
+      !terminate; ++epoch)
+  {
+    #pragma omp parallel for schedule(static, 1) num_threads(numShards)
+    for (omp_size_t s = 0; s < (omp_size_t) numShards; ++s)
+    {
+      arma::Col<size_t>& shard = shards[s];
+      if (shuffle)
+        std::shuffle(shard.begin(), shard.end(), generators[s]);
+
+      arma::SpMat<ElemType> gradient;
+      for (size_t j = 0; j < shard.n_elem; ++j)
+      {
+        function.Gradient(iterate, shard[j], gradient, 1);
+
+        // Apply the update without any locks; the atomic only makes sure that
+        // no update to a single coordinate is lost.
+        typename arma::SpMat<ElemType>::const_iterator it = gradient.begin();
+        for ( ; it != gradient.end(); ++it)
+        {
+          ElemType& value = iterate(it.row(), it.col());
+          const ElemType update = stepSize * (*it);
+          #pragma omp atomic
+          value -= update;
+        }
+      }
+    }
+
+    lastObjective = overallObjective;
+    overallObjective = function.Evaluate(iterate);
+
+    Log::Info << "Hogwild SGD: epoch " << epoch << ", objective "
+        << overallObjective << "." << std::endl;
+
+    terminate |= ens::Callback::EndEpoch(*this, function, iterate, epoch,
+        overallObjective, callbacks...);
+
+    if (std::isnan(overallObjective) || std::isinf(overallObjective))
+    {
+      Log::Warn << "Hogwild SGD: converged to " << overallObjective
+          << "; terminating with failure.  Try a smaller step size?"
+          << std::endl;
+      break;
+    }
+
+    if (std::abs(lastObjective - overallObjective) < tolerance)
+    {
+      Log::Info << "Hogwild SGD: minimized within tolerance " << tolerance
+          << "; terminating optimization." << std::endl;
+      break;
+    }
+  }
+
+  ens::Callback::EndOptimization(*this, function, iterate, callbacks...);
+  return overallObjective;
+}
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
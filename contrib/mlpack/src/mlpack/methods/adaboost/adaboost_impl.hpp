@@ -90,10 +90,6 @@ double AdaBoost<WeakLearnerType, MatType>::Train(
   // Use tempData to modify input data for incorporating weights.
   MatType tempData(data);
 
-  // This matrix is a helper matrix used to calculate the final hypothesis.
-  arma::mat sumFinalH = arma::zeros<arma::mat>(numClasses,
-      predictedLabels.n_cols);
-
   // Load the initial weights into a 2-D matrix.
   const double initWeight = 1.0 / double(data.n_cols * numClasses);
   arma::mat D(numClasses, data.n_cols);
@@ -102,20 +98,13 @@ double AdaBoost<WeakLearnerType, MatType>::Train(
   // Weights are stored in this row vector.
   arma::rowvec weights(predictedLabels.n_cols);
 
-  // This is the final hypothesis.
-  arma::Row<size_t> finalH(predictedLabels.n_cols);
+  // This holds +1 for each point the weak learner classified correctly and -1
+  // for each point it got wrong.
+  arma::rowvec agreement(predictedLabels.n_cols);
 
   // Now, start the boosting rounds.
   for (size_t i = 0; i < iterations; ++i)
   {
-    // Initialized to zero in every round.  rt is used for calculation of
-    // alphat; it is the weighted error.
-    // rt = (sum) D(i) y(i) ht(xi)
-    rt = 0.0;
-
-    // zt is used for weight normalization.
-    zt = 0.0;
-
     // Build the weight vectors.
     weights = arma::sum(D);
 
@@ -141,17 +130,12 @@ double AdaBoost<WeakLearnerType, MatType>::Train(
     // DecisionTree(DecisionTree&, MatType&, LabelsType&, size_t, WeightsType&, double = 0.0, double = 0.0, ...);
     w.Classify(tempData, predictedLabels);
 
-    // Now from predictedLabels, build ht, the weak hypothesis
-    // buildClassificationMatrix(ht, predictedLabels);
-
-    // Now, calculate alpha(t) using ht.
-    for (size_t j = 0; j < D.n_cols; ++j) // instead of D, ht
-    {
-      if (predictedLabels(j) == labels(j))
-        rt += arma::accu(D.col(j));
-      else
-        rt -= arma::accu(D.col(j));
-    }
+    // Now, calculate alpha(t) using ht.  rt is used for calculation of alphat;
+    // it is the weighted error.
+    // rt = (sum) D(i) y(i) ht(xi)
+    agreement = 2.0 * arma::conv_to<arma::rowvec>::from(
+        predictedLabels == labels) - 1.0;
+    rt = arma::dot(weights, agreement);
 
     if ((i > 0) && (std::abs(rt - crt) < tolerance))
       break;
@@ -174,44 +158,12 @@ double AdaBoost<WeakLearnerType, MatType>::Train(
     alpha.push_back(alphat);
     wl.push_back(w);
 
-    // Now start modifying the weights.
-    for (size_t j = 0; j < D.n_cols; ++j)
-    {
-      const double expo = exp(alphat);
-      if (predictedLabels(j) == labels(j))
-      {
-        for (size_t k = 0; k < D.n_rows; ++k)
-        {
-          // We calculate zt, the normalization constant.
-          D(k, j) /= expo;
-          zt += D(k, j); // * exp(-1 * alphat * yt(j,k) * ht(j,k));
-
-          // Add to the final hypothesis matrix.
-          // sumFinalH(k, j) += (alphat * ht(k, j));
-          if (k == labels(j))
-            sumFinalH(k, j) += (alphat); // * ht(k, j));
-          else
-            sumFinalH(k, j) -= (alphat);
-        }
-      }
-      else
-      {
-        for (size_t k = 0; k < D.n_rows; ++k)
-        {
-          // We calculate zt, the normalization constant.
-          D(k, j) *= expo;
-          zt += D(k, j);
-
-          // Add to the final hypothesis matrix.
-          if (k == labels(j))
-            sumFinalH(k, j) += alphat; // * ht(k, j));
-          else
-            sumFinalH(k, j) -= alphat;
-        }
-      }
-    }
+    // Now modify the weights: points that were classified correctly are scaled
+    // down by exp(alphat), and the others are scaled up by the same factor.
+    D.each_row() %= arma::exp(-alphat * agreement);
 
-    // Normalize D.
+    // zt is the normalization constant.
+    zt = arma::accu(D);
     D /= zt;
 
     // Accumulate the value of zt for the Hamming loss bound.
@@ -228,7 +180,6 @@ void AdaBoost<WeakLearnerType, MatType>::Classify(
     const MatType& test,
     arma::Row<size_t>& predictedLabels)
 {
-  arma::Row<size_t> tempPredictedLabels(test.n_cols);
   arma::mat probabilities;
 
   Classify(test, predictedLabels, probabilities);
@@ -243,29 +194,32 @@ void AdaBoost<WeakLearnerType, MatType>::Classify(
     arma::Row<size_t>& predictedLabels,
     arma::mat& probabilities)
 {
-  arma::Row<size_t> tempPredictedLabels(test.n_cols);
-
   probabilities.zeros(numClasses, test.n_cols);
-  predictedLabels.set_size(test.n_cols);
 
-  for (size_t i = 0; i < wl.size(); ++i)
+  // Each weak learner classifies the whole test set at once; the learners are
+  // split across threads, and each thread accumulates its votes locally.
+  #pragma omp parallel
   {
-    wl[i].Classify(test, tempPredictedLabels);
+    arma::mat localProbabilities(numClasses, test.n_cols, arma::fill::zeros);
+    arma::Row<size_t> tempPredictedLabels(test.n_cols);
 
-    for (size_t j = 0; j < tempPredictedLabels.n_cols; ++j)
-      probabilities(tempPredictedLabels(j), j) += alpha[i];
-  }
+    #pragma omp for
+    for (omp_size_t i = 0; i < (omp_size_t) wl.size(); ++i)
+    {
+      wl[i].Classify(test, tempPredictedLabels);
 
-  arma::colvec pRow;
-  arma::uword maxIndex = 0;
+      for (size_t j = 0; j < tempPredictedLabels.n_cols; ++j)
+        localProbabilities(tempPredictedLabels(j), j) += alpha[i];
+    }
 
-  for (size_t i = 0; i < predictedLabels.n_cols; ++i)
-  {
-    probabilities.col(i) /= arma::accu(probabilities.col(i));
-    pRow = probabilities.unsafe_col(i);
-    pRow.max(maxIndex);
-    predictedLabels(i) = maxIndex;
+    // Combine the votes from each thread.
+    #pragma omp critical
+    probabilities += localProbabilities;
   }
+
+  probabilities.each_row() /= arma::sum(probabilities);
+  predictedLabels = arma::conv_to<arma::Row<size_t>>::from(
+      arma::index_max(probabilities));
 }
 
 /**
@@ -0,0 +1,282 @@
+/**
+ * @file methods/ann/activation_functions/fast_activation_functions.hpp
+ *
+ * Definition and implementation of approximations of the logistic, tanh,
+ * softplus, swish, GELU and Mish functions, computed with the polynomial
+ * approximations of fast_math.hpp.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_ACTIVATION_FUNCTIONS_FAST_ACTIVATION_FUNCTIONS_HPP
+#define MLPACK_METHODS_ANN_ACTIVATION_FUNCTIONS_FAST_ACTIVATION_FUNCTIONS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "fast_math.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Apply `f` to each element of `x`, storing the results in `y`.  The loop is
+ * written so that the compiler vectorizes it.
+ */
+template<typename InputVecType, typename OutputVecType, typename FunctionType>
+inline void FastApply(const InputVecType& x, OutputVecType& y, FunctionType f)
+{
+  typedef typename OutputVecType::elem_type ElemType;
+
+  y.set_size(arma::size(x));
+  const ElemType* in = x.memptr();
+  ElemType* out = y.memptr();
+  const size_t n = x.n_elem;
+
+  #pragma omp simd
+  for (size_t i = 0; i < n; ++i)
+    out[i] = f(in[i]);
+}
+
+/**
+ * An approximation of the logistic function; see `LogisticFunction`.  The
+ * relative error is below 1e-8.
+ */
+class FastLogisticFunction
+{
+ public:
+  //! Compute the logistic function.
+  static double Fn(const double x) { return FastLogistic(x); }
+
+  //! Compute the logistic function of each element of `x`.
+  template<typename InputVecType, typename OutputVecType>
+  static void Fn(const InputVecType& x, OutputVecType& y)
+  {
+    typedef typename OutputVecType::elem_type ElemType;
+    FastApply(x, y, [](const ElemType v) { return FastLogistic(v); });
+  }
+
+  //! Compute the first derivative of the logistic function, given f(x).
+  static double Deriv(const double y) { return y * (1.0 - y); }
+
+  //! Compute the first derivatives of the logistic function, given f(x).
+  template<typename InputVecType, typename OutputVecType>
+  static void Deriv(const InputVecType& y, OutputVecType& x)
+  {
+    typedef typename OutputVecType::elem_type ElemType;
+    FastApply(y, x, [](const ElemType v) { return v * (1 - v); });
+  }
+}; // class FastLogisticFunction
+
+/**
+ * An approximation of the tanh function; see `TanhFunction`.  The absolute
+ * error is below 1e-8.
+ */
+class FastTanhFunction
+{
+ public:
+  //! Compute the tanh function.
+  static double Fn(const double x) { return FastTanh(x); }
+
+  //! Compute the tanh function of each element of `x`.
+  template<typename InputVecType, typename OutputVecType>
+  static void Fn(const InputVecType& x, OutputVecType& y)
+  {
+    typedef typename OutputVecType::elem_type ElemType;
+    FastApply(x, y, [](const ElemType v) { return FastTanh(v); });
+  }
+
+  //! Compute the first derivative of the tanh function, given f(x).
+  static double Deriv(const double y) { return 1.0 - y * y; }
+
+  //! Compute the first derivatives of the tanh function, given f(x).
+  template<typename InputVecType, typename OutputVecType>
+  static void Deriv(const InputVecType& y, OutputVecType& x)
+  {
+    typedef typename OutputVecType::elem_type ElemType;
+    FastApply(y, x, [](const ElemType v) { return 1 - v * v; });
+  }
+}; // class FastTanhFunction
+
+/**
+ * An approximation of the softplus function; see `SoftplusFunction`.  The
+ * relative error is below 1e-8.
+ */
+class FastSoftplusFunction
+{
+ public:
+  //! Compute the softplus function.
+  static double Fn(const double x) { return FastSoftplus(x); }
+
+  //! Compute the softplus function of each element of `x`.
+  template<typename InputVecType, typename OutputVecType>
+  static void Fn(const InputVecType& x, OutputVecType& y)
+  {
+    typedef typename OutputVecType::elem_type ElemType;
+    FastApply(x, y, [](const ElemType v) { return FastSoftplus(v); });
+  }
+
+  //! Compute the first derivative of the softplus function, as
+  //! `SoftplusFunction` does.
+  static double Deriv(const double y) { return FastLogistic(y); }
+
+  //! Compute the first derivatives of the softplus function, as
+  //! `SoftplusFunction` does.
+  template<typename InputVecType, typename OutputVecType>
+  static void Deriv(const InputVecType& y, OutputVecType& x)
+  {
+    typedef typename OutputVecType::elem_type ElemType;
+    FastApply(y, x, [](const ElemType v) { return FastLogistic(v); });
+  }
+}; // class FastSoftplusFunction
+
+/**
+ * An approximation of the swish function, x / (1 + exp(-x)), which is also
+ * the SILU function; see `SwishFunction` and `SILUFunction`.
+ */
+class FastSwishFunction
+{
+ public:
+  //! Compute the swish function.
+  static double Fn(const double x) { return x * FastLogistic(x); }
+
+  //! Compute the swish function of each element of `x`.
+  template<typename InputVecType, typename OutputVecType>
+  static void Fn(const InputVecType& x, OutputVecType& y)
+  {
+    typedef typename OutputVecType::elem_type ElemType;
+    FastApply(x, y, [](const ElemType v) { return v * FastLogistic(v); });
+  }
+
+  //! Compute the first derivative of the swish function, as `SwishFunction`
+  //! does.
+  static double Deriv(const double y) { return Derivative(y); }
+
+  //! Compute the first derivatives of the swish function, as `SwishFunction`
+  //! does.
+  template<typename InputVecType, typename OutputVecType>
+  static void Deriv(const InputVecType& y, OutputVecType& x)
+  {
+    typedef typename OutputVecType::elem_type ElemType;
+    FastApply(y, x, [](const ElemType v) { return Derivative(v); });
+  }
+
+ private:
+  //! Compute s (1 + v (1 - s)) with s the logistic function of v.
+  template<typename eT>
+  static eT Derivative(const eT v)
+  {
+    const eT s = FastLogistic(v);
+    return s * (1 + v * (1 - s));
+  }
+}; // class FastSwishFunction
+
+/**
+ * An approximation of the GELU function; see `GELUFunction`.
+ */
+class FastGELUFunction
+{
+ public:
+  //! Compute the GELU function.
+  static double Fn(const double x) { return Function(x); }
+
+  //! Compute the GELU function of each element of `x`.
+  template<typename InputVecType, typename OutputVecType>
+  static void Fn(const InputVecType& x, OutputVecType& y)
+  {
+    typedef typename OutputVecType::elem_type ElemType;
+    FastApply(x, y, [](const ElemType v) { return Function(v); });
+  }
+
+  //! Compute the first derivative of the GELU function, as `GELUFunction`
+  //! does.
+  static double Deriv(const double y) { return Derivative(y); }
+
+  //! Compute the first derivatives of the GELU function, as `GELUFunction`
+  //! does.
+  template<typename InputVecType, typename OutputVecType>
+  static void Deriv(const InputVecType& y, OutputVecType& x)
+  {
+    typedef typename OutputVecType::elem_type ElemType;
+    FastApply(y, x, [](const ElemType v) { return Derivative(v); });
+  }
+
+ private:
+  //! Compute 0.5 v (1 + tanh(sqrt(2 / pi) (v + 0.044715 v^3))).
+  template<typename eT>
+  static eT Function(const eT v)
+  {
+    return eT(0.5) * v * (1 + FastTanh(eT(0.7978845608028654) *
+        (v + eT(0.044715) * v * v * v)));
+  }
+
+  //! Compute the derivative of Function() at v.
+  template<typename eT>
+  static eT Derivative(const eT v)
+  {
+    const eT v3 = v * v * v;
+    const eT t = FastTanh(eT(0.0356774) * v3 + eT(0.797885) * v);
+    return eT(0.5) * t + (eT(0.0535161) * v3 + eT(0.398942) * v) *
+        (1 - t * t) + eT(0.5);
+  }
+}; // class FastGELUFunction
+
+/**
+ * An approximation of the Mish function, x tanh(softplus(x)); see
+ * `MishFunction`.
+ */
+class FastMishFunction
+{
+ public:
+  //! Compute the Mish function.
+  static double Fn(const double x) { return Function(x); }
+
+  //! Compute the Mish function of each element of `x`.
+  template<typename InputVecType, typename OutputVecType>
+  static void Fn(const InputVecType& x, OutputVecType& y)
+  {
+    typedef typename OutputVecType::elem_type ElemType;
+    FastApply(x, y, [](const ElemType v) { return Function(v); });
+  }
+
+  //! Compute the first derivative of the Mish function, as `MishFunction`
+  //! does.
+  static double Deriv(const double y) { return Derivative(y); }
+
+  //! Compute the first derivatives of the Mish function, as `MishFunction`
+  //! does.
+  template<typename InputVecType, typename OutputVecType>
+  static void Deriv(const InputVecType& y, OutputVecType& x)
+  {
+    typedef typename OutputVecType::elem_type ElemType;
+    FastApply(y, x, [](const ElemType v) { return Derivative(v); });
+  }
+
+ private:
+  //! Compute v (e^2v + 2 e^v) / (e^2v + 2 e^v + 2).  Beyond v = 20 the ratio
+  //! is 1 in double precision, so e^v is clamped there to avoid overflow.
+  template<typename eT>
+  static eT Function(const eT v)
+  {
+    const eT e = FastExp((v > 20) ? eT(20) : v);
+    const eT n = e * (e + 2);
+    return v * n / (n + 2);
+  }
+
+  //! Compute the derivative of Function() at v (clamped to 20, where it is 1).
+  template<typename eT>
+  static eT Derivative(eT v)
+  {
+    v = (v > 20) ? eT(20) : v;
+    const eT e = FastExp(v);
+    const eT d = e * (e + 2) + 2;
+    return e * (4 * (v + 1) + e * (4 * v + 6) + 4 * e * e + e * e * e) /
+        (d * d);
+  }
+}; // class FastMishFunction
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
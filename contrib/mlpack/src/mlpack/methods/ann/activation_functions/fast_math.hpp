@@ -0,0 +1,187 @@
+/**
+ * @file methods/ann/activation_functions/fast_math.hpp
+ *
+ * Polynomial approximations of exp(), log() and tanh() with bounded error, used
+ * by the fast activation functions.  The functions have no branches, so that
+ * loops over them are vectorized by the compiler for the instruction set it
+ * targets (e.g. AVX2 or AVX-512 with -march=native).
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_ACTIVATION_FUNCTIONS_FAST_MATH_HPP
+#define MLPACK_METHODS_ANN_ACTIVATION_FUNCTIONS_FAST_MATH_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <cstring>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * The layout of the floating-point type `eT`, used to build and take apart
+ * numbers from their exponent and mantissa.
+ */
+template<typename eT>
+struct FastMathTraits;
+
+//! The layout of single-precision numbers.
+template<>
+struct FastMathTraits<float>
+{
+  typedef int32_t IntType;
+  static const int mantissaBits = 23;
+  static const int bias = 127;
+  //! Largest argument of FastExp() whose result is finite.
+  static constexpr float maxExp = 87.0f;
+};
+
+//! The layout of double-precision numbers.
+template<>
+struct FastMathTraits<double>
+{
+  typedef int64_t IntType;
+  static const int mantissaBits = 52;
+  static const int bias = 1023;
+  //! Largest argument of FastExp() whose result is finite.
+  static constexpr double maxExp = 708.0;
+};
+
+/**
+ * Compute 2^k for an integer-valued k that gives a normal number.
+ */
+template<typename eT>
+inline eT FastPow2(const eT k)
+{
+  typedef FastMathTraits<eT> Traits;
+  const typename Traits::IntType bits =
+      (typename Traits::IntType(k) + Traits::bias) << Traits::mantissaBits;
+  eT result;
+  std::memcpy(&result, &bits, sizeof(eT));
+  return result;
+}
+
+/**
+ * Compute an approximation of exp(x).  The argument is reduced to
+ * x = k ln(2) + r with |r| <= ln(2) / 2, and exp(r) is computed with its Taylor
+ * polynomial of degree 7, whose relative error is below 6e-9.  Arguments are
+ * clamped to +/- `FastMathTraits<eT>::maxExp`, so the result is never infinite
+ * or denormal.
+ */
+template<typename eT>
+inline eT FastExp(eT x)
+{
+  const eT maxExp = FastMathTraits<eT>::maxExp;
+  x = (x > maxExp) ? maxExp : ((x < -maxExp) ? -maxExp : x);
+
+  const eT k = std::floor(x * eT(1.4426950408889634) + eT(0.5));
+  // ln(2) is split in two parts so that k * ln2Hi is exact.
+  const eT r = (x - k * eT(0.693145751953125)) - k * eT(1.428606820309417e-6);
+
+  eT p = eT(1.0 / 5040.0);
+  p = p * r + eT(1.0 / 720.0);
+  p = p * r + eT(1.0 / 120.0);
+  p = p * r + eT(1.0 / 24.0);
+  p = p * r + eT(1.0 / 6.0);
+  p = p * r + eT(0.5);
+  p = p * r + eT(1.0);
+  p = p * r + eT(1.0);
+
+  return p * FastPow2(k);
+}
+
+/**
+ * Compute an approximation of log(x) for a normal, positive x.  The argument is
+ * split as x = m 2^e with sqrt(1/2) <= m < sqrt(2), and log(m) is computed from
+ * the series of 2 atanh(s) with s = (m - 1) / (m + 1), up to s^9; the absolute
+ * error of log(m) is below 1e-9.
+ */
+template<typename eT>
+inline eT FastLog(const eT x)
+{
+  typedef FastMathTraits<eT> Traits;
+  typedef typename Traits::IntType IntType;
+
+  IntType bits;
+  std::memcpy(&bits, &x, sizeof(eT));
+  eT e = eT((bits >> Traits::mantissaBits) - Traits::bias);
+
+  // Keep the mantissa and set the exponent to 0, so that 1 <= m < 2.
+  const IntType mantissaMask = (IntType(1) << Traits::mantissaBits) - 1;
+  bits = (bits & mantissaMask) |
+      (IntType(Traits::bias) << Traits::mantissaBits);
+  eT m;
+  std::memcpy(&m, &bits, sizeof(eT));
+
+  const bool large = (m > eT(1.4142135623730951));
+  m = large ? m * eT(0.5) : m;
+  e = large ? e + 1 : e;
+
+  const eT s = (m - 1) / (m + 1);
+  const eT s2 = s * s;
+  eT p = eT(1.0 / 9.0);
+  p = p * s2 + eT(1.0 / 7.0);
+  p = p * s2 + eT(1.0 / 5.0);
+  p = p * s2 + eT(1.0 / 3.0);
+  p = p * s2 + eT(1.0);
+
+  return e * eT(0.6931471805599453) + 2 * s * p;
+}
+
+/**
+ * Compute an approximation of log(1 + exp(x)), the softplus function, that is
+ * accurate for large negative x too.
+ */
+template<typename eT>
+inline eT FastSoftplus(const eT x)
+{
+  // softplus(x) = max(x, 0) + log(1 + exp(-|x|)).  log(1 + t) is computed as
+  // t log(u) / (u - 1) with u = 1 + t, which corrects for the rounding of u.
+  const eT t = FastExp(-std::abs(x));
+  const eT u = 1 + t;
+  const eT d = u - 1;
+  const eT log1p = (d == 0) ? t : FastLog(u) * (t / d);
+
+  return ((x > 0) ? x : eT(0)) + log1p;
+}
+
+/**
+ * Compute an approximation of tanh(x), with absolute error below 1e-8 (and
+ * relative error below 4e-9 for |x| < 1/8, where a Taylor polynomial is used).
+ */
+template<typename eT>
+inline eT FastTanh(const eT x)
+{
+  const eT a = std::abs(x);
+
+  // tanh(|x|) = (1 - exp(-2|x|)) / (1 + exp(-2|x|)).
+  const eT t = FastExp(-2 * a);
+  const eT large = (1 - t) / (1 + t);
+
+  const eT a2 = a * a;
+  eT p = eT(62.0 / 2835.0);
+  p = p * a2 - eT(17.0 / 315.0);
+  p = p * a2 + eT(2.0 / 15.0);
+  p = p * a2 - eT(1.0 / 3.0);
+  const eT small = a + a * a2 * p;
+
+  const eT result = (a < eT(0.125)) ? small : large;
+  return (x < 0) ? -result : result;
+}
+
+/**
+ * Compute an approximation of the logistic function 1 / (1 + exp(-x)).
+ */
+template<typename eT>
+inline eT FastLogistic(const eT x)
+{
+  return 1 / (1 + FastExp(-x));
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,384 @@
+/**
+ * @file methods/ann/convolution_rules/im2col_convolution.hpp
+ *
+ * Implementation of the convolution through the im2col transformation, which
+ * lowers the convolution to a single matrix multiplication.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_CONVOLUTION_RULES_IM2COL_CONVOLUTION_HPP
+#define MLPACK_METHODS_ANN_CONVOLUTION_RULES_IM2COL_CONVOLUTION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "border_modes.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Computes the two-dimensional convolution by lowering it to a matrix
+ * multiplication.  Every patch of the input that the filter is applied to is
+ * copied into one row of a "lowered" matrix (the im2col transformation), so
+ * that the convolution with any number of filters becomes a single product of
+ * the lowered matrix with the matrix of filters, which can be handed to BLAS.
+ *
+ * This class can be used as a drop-in replacement for NaiveConvolution, but
+ * the real benefit comes from the batch functions Im2Col() and Col2Im(): the
+ * ConvolutionType layer uses them to lower all of the input maps of all of the
+ * points in a batch at once, so that the forward pass, backward pass and
+ * gradient of the layer are each computed with one matrix multiplication.
+ *
+ * FullConvolution: returns the full two-dimensional convolution.
+ * ValidConvolution: returns only those parts of the convolution that are
+ * computed without the zero-padded edges.
+ *
+ * @tparam BorderMode Type of the border mode (FullConvolution or
+ * ValidConvolution).
+ */
+template<typename BorderMode = FullConvolution>
+class Im2ColConvolution
+{
+ public:
+  /**
+   * Lower a batch of (multi-map) inputs.  The input cube holds `maps`
+   * consecutive slices for each point; the slice of map m of point p is
+   * m + maps * p.  Row (i + outRows * j + outRows * outCols * p) of the
+   * lowered matrix holds the patch used to compute output element (i, j) of
+   * point p, ordered like a filter cube of size kernelRows x kernelCols x maps,
+   * i.e. element (ki, kj, m) of the patch is in column
+   * ki + kernelRows * kj + kernelRows * kernelCols * m.
+   *
+   * @param input Input cube (maps slices per point).
+   * @param maps Number of input maps per point.
+   * @param kernelRows Number of rows of the filter.
+   * @param kernelCols Number of columns of the filter.
+   * @param strideRows Stride of filter application along the rows.
+   * @param strideCols Stride of filter application along the columns.
+   * @param dilationRows Dilation factor of the filter along the rows.
+   * @param dilationCols Dilation factor of the filter along the columns.
+   * @param lowered Lowered matrix; it is only reallocated if its size changes,
+   *     so it can be reused as a workspace between calls.
+   */
+  template<typename eT>
+  static void Im2Col(const arma::Cube<eT>& input,
+                     const size_t maps,
+                     const size_t kernelRows,
+                     const size_t kernelCols,
+                     const size_t strideRows,
+                     const size_t strideCols,
+                     const size_t dilationRows,
+                     const size_t dilationCols,
+                     arma::Mat<eT>& lowered)
+  {
+    const size_t outRows = OutputSize(input.n_rows, kernelRows, strideRows,
+        dilationRows);
+    const size_t outCols = OutputSize(input.n_cols, kernelCols, strideCols,
+        dilationCols);
+    const size_t outSize = outRows * outCols;
+    const size_t points = input.n_slices / maps;
+
+    lowered.set_size(outSize * points, kernelRows * kernelCols * maps);
+
+    // Each (point, map) pair fills its own block of the lowered matrix, so the
+    // slices can be processed in parallel.
+    #pragma omp parallel for
+    for (omp_size_t s = 0; s < (omp_size_t) input.n_slices; ++s)
+    {
+      const size_t map = s % maps;
+      const size_t point = s / maps;
+      for (size_t kj = 0; kj < kernelCols; ++kj)
+      {
+        for (size_t ki = 0; ki < kernelRows; ++ki)
+        {
+          eT* loweredPtr = lowered.colptr(ki + kernelRows * (kj + kernelCols *
+              map)) + outSize * point;
+          for (size_t j = 0; j < outCols; ++j)
+          {
+            const eT* inputPtr = input.slice_colptr(s, j * strideCols +
+                kj * dilationCols) + ki * dilationRows;
+            for (size_t i = 0; i < outRows; ++i, inputPtr += strideRows)
+              *(loweredPtr++) = *inputPtr;
+          }
+        }
+      }
+    }
+  }
+
+  /**
+   * Add the lowered representation back into a batch of (multi-map) inputs;
+   * this is the adjoint of Im2Col(), so every element of the lowered matrix is
+   * added to the input element it was copied from.  The output cube must
+   * already have the right size.
+   *
+   * @param lowered Lowered matrix.
+   * @param maps Number of input maps per point.
+   * @param kernelRows Number of rows of the filter.
+   * @param kernelCols Number of columns of the filter.
+   * @param strideRows Stride of filter application along the rows.
+   * @param strideCols Stride of filter application along the columns.
+   * @param dilationRows Dilation factor of the filter along the rows.
+   * @param dilationCols Dilation factor of the filter along the columns.
+   * @param output Cube to accumulate into (maps slices per point).
+   */
+  template<typename eT>
+  static void Col2Im(const arma::Mat<eT>& lowered,
+                     const size_t maps,
+                     const size_t kernelRows,
+                     const size_t kernelCols,
+                     const size_t strideRows,
+                     const size_t strideCols,
+                     const size_t dilationRows,
+                     const size_t dilationCols,
+                     arma::Cube<eT>& output)
+  {
+    const size_t outRows = OutputSize(output.n_rows, kernelRows, strideRows,
+        dilationRows);
+    const size_t outCols = OutputSize(output.n_cols, kernelCols, strideCols,
+        dilationCols);
+    const size_t outSize = outRows * outCols;
+
+    // Overlapping patches only ever write into the same slice, so the slices
+    // can be processed in parallel.
+    #pragma omp parallel for
+    for (omp_size_t s = 0; s < (omp_size_t) output.n_slices; ++s)
+    {
+      const size_t map = s % maps;
+      const size_t point = s / maps;
+      for (size_t kj = 0; kj < kernelCols; ++kj)
+      {
+        for (size_t ki = 0; ki < kernelRows; ++ki)
+        {
+          const eT* loweredPtr = lowered.colptr(ki + kernelRows * (kj +
+              kernelCols * map)) + outSize * point;
+          for (size_t j = 0; j < outCols; ++j)
+          {
+            eT* outputPtr = output.slice_colptr(s, j * strideCols +
+                kj * dilationCols) + ki * dilationRows;
+            for (size_t i = 0; i < outRows; ++i, outputPtr += strideRows)
+              *outputPtr += *(loweredPtr++);
+          }
+        }
+      }
+    }
+  }
+
+  /*
+   * Perform a convolution (valid mode).
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT, typename Border = BorderMode>
+  static typename std::enable_if<
+      std::is_same<Border, ValidConvolution>::value, void>::type
+  Convolution(const arma::Mat<eT>& input,
+              const arma::Mat<eT>& filter,
+              arma::Mat<eT>& output,
+              const size_t dW = 1,
+              const size_t dH = 1,
+              const size_t dilationW = 1,
+              const size_t dilationH = 1)
+  {
+    const arma::Cube<eT> inputCube(const_cast<eT*>(input.memptr()),
+        input.n_rows, input.n_cols, 1, false, true);
+
+    arma::Mat<eT> lowered;
+    Im2Col(inputCube, 1, filter.n_rows, filter.n_cols, dH, dW, dilationH,
+        dilationW, lowered);
+
+    // Write the result through a vector alias, since the output may be a slice
+    // of a cube and can't be reshaped.
+    output.set_size(OutputSize(input.n_rows, filter.n_rows, dH, dilationH),
+        OutputSize(input.n_cols, filter.n_cols, dW, dilationW));
+    arma::Col<eT> outputVec(output.memptr(), output.n_elem, false, true);
+    outputVec = lowered * arma::vectorise(filter);
+  }
+
+  /*
+   * Perform a convolution (full mode).
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT, typename Border = BorderMode>
+  static typename std::enable_if<
+      std::is_same<Border, FullConvolution>::value, void>::type
+  Convolution(const arma::Mat<eT>& input,
+              const arma::Mat<eT>& filter,
+              arma::Mat<eT>& output,
+              const size_t dW = 1,
+              const size_t dH = 1,
+              const size_t dilationW = 1,
+              const size_t dilationH = 1)
+  {
+    // Pad the input so that the filter is applied at every position where it
+    // overlaps the input.
+    const size_t paddingRows = filter.n_rows * dilationH - dilationH;
+    const size_t paddingCols = filter.n_cols * dilationW - dilationW;
+
+    arma::Mat<eT> inputPadded(input.n_rows + 2 * paddingRows,
+        input.n_cols + 2 * paddingCols, arma::fill::zeros);
+    inputPadded.submat(paddingRows, paddingCols, paddingRows + input.n_rows - 1,
+        paddingCols + input.n_cols - 1) = input;
+
+    Im2ColConvolution<ValidConvolution>::Convolution(inputPadded, filter,
+        output, dW, dH, dilationW, dilationH);
+  }
+
+  /*
+   * Perform a convolution using 3rd order tensors.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Cube<eT>& input,
+                          const arma::Cube<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1)
+  {
+    arma::Mat<eT> convOutput;
+    Im2ColConvolution<BorderMode>::Convolution(input.slice(0), filter.slice(0),
+        convOutput, dW, dH, dilationW, dilationH);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        input.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < input.n_slices; ++i)
+    {
+      Im2ColConvolution<BorderMode>::Convolution(input.slice(i),
+          filter.slice(i), output.slice(i), dW, dH, dilationW, dilationH);
+    }
+  }
+
+  /*
+   * Perform a convolution using dense matrix as input and a 3rd order tensors
+   * as filter and output.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Mat<eT>& input,
+                          const arma::Cube<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1)
+  {
+    arma::Mat<eT> convOutput;
+    Im2ColConvolution<BorderMode>::Convolution(input, filter.slice(0),
+        convOutput, dW, dH, dilationW, dilationH);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        filter.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < filter.n_slices; ++i)
+    {
+      Im2ColConvolution<BorderMode>::Convolution(input, filter.slice(i),
+          output.slice(i), dW, dH, dilationW, dilationH);
+    }
+  }
+
+  /*
+   * Perform a convolution using a 3rd order tensors as input and output and a
+   * dense matrix as filter.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Cube<eT>& input,
+                          const arma::Mat<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1)
+  {
+    arma::Mat<eT> convOutput;
+    Im2ColConvolution<BorderMode>::Convolution(input.slice(0), filter,
+        convOutput, dW, dH, dilationW, dilationH);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        input.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < input.n_slices; ++i)
+    {
+      Im2ColConvolution<BorderMode>::Convolution(input.slice(i), filter,
+          output.slice(i), dW, dH, dilationW, dilationH);
+    }
+  }
+
+  /**
+   * Return the size of the (valid) convolution output along one dimension.
+   *
+   * @param size Size of the input along the dimension.
+   * @param k Size of the filter along the dimension.
+   * @param s Stride along the dimension.
+   * @param d Dilation along the dimension.
+   */
+  static size_t OutputSize(const size_t size,
+                           const size_t k,
+                           const size_t s,
+                           const size_t d)
+  {
+    return (size - (k * d - (d - 1)) + s) / s;
+  }
+};  // class Im2ColConvolution
+
+/**
+ * Whether or not the given convolution rule is an Im2ColConvolution, in which
+ * case the ConvolutionType layer lowers the whole batch at once.
+ */
+template<typename ConvolutionRuleType>
+struct IsIm2ColConvolution
+{
+  static const bool value = false;
+};
+
+template<typename BorderMode>
+struct IsIm2ColConvolution<Im2ColConvolution<BorderMode>>
+{
+  static const bool value = true;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -14,12 +14,16 @@
 #define MLPACK_METHODS_ANN_FFN_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/sfinae_utility.hpp>
 
 #include "forward_decls.hpp"
 #include "init_rules/network_init.hpp"
 
 #include <mlpack/methods/ann/layer/layer.hpp>
 #include <mlpack/methods/ann/layer/multi_layer.hpp>
+#include <mlpack/methods/ann/parallel_columns.hpp>
+#include <mlpack/methods/ann/inference_plan.hpp>
+#include <mlpack/methods/ann/memory_plan.hpp>
 #include <mlpack/methods/ann/init_rules/random_init.hpp>
 #include <mlpack/methods/ann/loss_functions/negative_log_likelihood.hpp>
 #include <ensmallen.hpp>
@@ -27,6 +31,14 @@
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
 
+//! This gives us a HasBatchSizeCheck object that we can use to tell whether an
+//! optimizer has a BatchSize() method.
+HAS_MEM_FUNC(BatchSize, HasBatchSizeCheck);
+
+//! This gives us a HasReductionCheck object that we can use to tell whether an
+//! output layer has a Reduction() method.
+HAS_MEM_FUNC(Reduction, HasReductionCheck);
+
 /**
  * Implementation of a standard feed forward network.  Any layer that inherits
  * from the base `Layer` class can be added to this model.  For recursive neural
@@ -93,6 +105,7 @@ class FFN
   {
     network.template Add<LayerType>(args...);
     inputDimensionsAreSet = false;
+    replicaWeights = nullptr;
   }
 
   /**
@@ -105,6 +118,7 @@ class FFN
   {
     network.Add(layer);
     inputDimensionsAreSet = false;
+    replicaWeights = nullptr;
   }
 
   //! Get the layers of the network.
@@ -125,6 +139,7 @@ class FFN
     // We can no longer make any assumptions... the user may change anything.
     inputDimensionsAreSet = false;
     layerMemoryIsSet = false;
+    replicaWeights = nullptr;
 
     return network.Network();
   }
@@ -199,6 +214,29 @@ class FFN
                MatType& results,
                const size_t batchSize = 128);
 
+  /**
+   * Compile the current network into an immutable plan for prediction only.
+   * Dropout layers are removed, and linear and convolution layers are fused
+   * with the activation that follows them; see `InferencePlan` for details.
+   * The plan holds a copy of the weights, and can be used from many threads at
+   * once (with one `InferencePlan::Workspace` per thread).
+   *
+   * The input dimensions of the network must be known, so the network must
+   * have been trained, or `Reset()` must have been called, or
+   * `InputDimensions()` must have been set.
+   *
+   * @param maxBatchSize Maximum number of points the plan processes at once;
+   *     this determines the size of the preallocated buffers.
+   */
+  InferencePlan<MatType> CompileForInference(const size_t maxBatchSize = 1);
+
+  /**
+   * Plan the activation memory of the network for training and prediction with
+   * the current `CheckpointInterval()`; see `MemoryPlan` for details.  The
+   * input dimensions of the network must be known.
+   */
+  MemoryPlan<MatType> PlanMemory();
+
   // Return the number of weights in the model.
   size_t WeightSize();
 
@@ -235,6 +273,45 @@ class FFN
   //! time a forward pass is done.
   MatType& Parameters() { return parameters; }
 
+  //! Get the number of threads used by the layers to process the points of a
+  //! batch in parallel (0 means the OpenMP default).
+  size_t NumThreads() const { return numThreads; }
+  //! Modify the number of threads used by the layers to process the points of
+  //! a batch in parallel (0 means the OpenMP default).
+  size_t& NumThreads() { return numThreads; }
+
+  /**
+   * Get the number of workers that process each batch during training.  Each
+   * worker passes its own shard of the batch through its own copy of the
+   * network (the copies share the parameters), and the gradients of the
+   * shards are then summed by all workers together.  The result is the same as
+   * for one worker, up to the order of floating-point additions, except that
+   * layers that draw random numbers (like `Dropout`) draw different ones, and
+   * the gradient of the regularizer of a layer is added once per shard.  1 (the
+   * default) disables this; 0 means the OpenMP default number of threads.
+   *
+   * Data parallelism helps most for networks of small layers, whose batches
+   * get little parallelism from the BLAS or from `NumThreads()`.
+   */
+  size_t NumWorkers() const { return numWorkers; }
+  //! Modify the number of workers that process each batch during training.
+  size_t& NumWorkers() { return numWorkers; }
+
+  /**
+   * Get the checkpoint interval used during training.  If it is not 0, only
+   * the outputs of every `CheckpointInterval()`-th layer are kept during the
+   * forward pass, and the outputs of the other layers are recomputed during the
+   * backward pass.  This trades computation for memory: an interval close to
+   * the square root of the number of layers gives the least memory.
+   */
+  size_t CheckpointInterval() const { return network.CheckpointInterval(); }
+  //! Modify the checkpoint interval used during training (0 keeps the outputs
+  //! of all layers).
+  void CheckpointInterval(const size_t interval)
+  {
+    network.CheckpointInterval(interval);
+  }
+
   /**
    * Reset the stored data of the network entirely.  This resets all weights of
    * each layer using `InitializationRuleType`, and prepares the network to
@@ -469,6 +546,46 @@ class FFN
   void UpdateDimensions(const std::string& functionName,
                         const size_t inputDimensionality = 0);
 
+  /**
+   * Evaluate the objective and gradient on the given batch like
+   * `EvaluateWithGradient()`, but split the batch into `workers` shards that
+   * are processed in parallel.
+   */
+  typename MatType::elem_type EvaluateWithGradientParallel(
+      const size_t begin,
+      MatType& gradient,
+      const size_t batchSize,
+      const size_t workers);
+
+  //! Return the number of workers to use for a batch of the given size.
+  size_t Workers(const size_t batchSize) const;
+
+  /**
+   * Make sure that there are `count` copies of the network, whose weights
+   * point to `parameters` and which are in the same mode as the network.
+   */
+  void SetReplicas(const size_t count);
+
+  /**
+   * Return whether the given output layer takes the mean over the points of a
+   * batch (rather than the sum), if it has a Reduction() method.
+   */
+  template<typename LossType>
+  typename std::enable_if<
+      HasReductionCheck<LossType, bool(LossType::*)() const>::value, bool
+  >::type
+  MeanReduction(const LossType& loss) const;
+
+  /**
+   * Return false (output layers without a Reduction() method are assumed to
+   * sum over the points of a batch).
+   */
+  template<typename LossType>
+  typename std::enable_if<
+      !HasReductionCheck<LossType, bool(LossType::*)() const>::value, bool
+  >::type
+  MeanReduction(const LossType& loss) const;
+
   /**
    * Check if the optimizer has MaxIterations() parameter, if it does then check
    * if its value is less than the number of datapoints in the dataset.
@@ -497,6 +614,32 @@ class FFN
   >::type
   WarnMessageMaxIterations(OptimizerType& optimizer, size_t samples) const;
 
+  /**
+   * Return the batch size of the optimizer, if it has a BatchSize() method.
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @param optimizer optimizer used in the training process.
+   */
+  template<typename OptimizerType>
+  typename std::enable_if<
+      HasBatchSizeCheck<OptimizerType, size_t(OptimizerType::*)() const>::value,
+      size_t
+  >::type
+  OptimizerBatchSize(OptimizerType& optimizer) const;
+
+  /**
+   * Return 1 if the optimizer has no BatchSize() method.
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @param optimizer optimizer used in the training process.
+   */
+  template<typename OptimizerType>
+  typename std::enable_if<
+      !HasBatchSizeCheck<OptimizerType, size_t(OptimizerType::*)() const>::value,
+      size_t
+  >::type
+  OptimizerBatchSize(OptimizerType& optimizer) const;
+
   //! Instantiated output layer used to evaluate the network.
   OutputLayerType outputLayer;
 
@@ -531,6 +674,31 @@ class FFN
   //! except during training.
   MatType responses;
 
+  //! The number of threads used for the forward and backward passes (0 means
+  //! the OpenMP default).
+  size_t numThreads;
+
+  //! The number of workers that process each batch during training (0 means
+  //! the OpenMP default).
+  size_t numWorkers;
+
+  //! Copies of the network used by every worker but the first; their weights
+  //! are aliases of `parameters`.
+  std::vector<MultiLayer<MatType>> replicas;
+  //! Output layers used by every worker but the first.
+  std::vector<OutputLayerType> replicaOutputLayers;
+  //! Output of the network for every worker but the first.
+  std::vector<MatType> replicaOutputs;
+  //! Error of the output layer for every worker but the first.
+  std::vector<MatType> replicaErrors;
+  //! Output of the backward pass for every worker but the first.
+  std::vector<MatType> replicaDeltas;
+  //! Gradient of the shard of every worker but the first.
+  std::vector<MatType> replicaGradients;
+  //! Memory that the weights of the replicas point to, or nullptr if the replicas
+  //! must be created again.
+  const typename MatType::elem_type* replicaWeights;
+
   //! Locally-stored output of the network from a forward pass; used by the
   //! backward pass.
   MatType networkOutput;
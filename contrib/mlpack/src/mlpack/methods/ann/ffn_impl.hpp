@@ -30,6 +30,9 @@ FFN<
 >::FFN(OutputLayerType outputLayer, InitializationRuleType initializeRule) :
     outputLayer(std::move(outputLayer)),
     initializeRule(std::move(initializeRule)),
+    numThreads(0),
+    numWorkers(1),
+    replicaWeights(nullptr),
     layerMemoryIsSet(false),
     inputDimensionsAreSet(false)
 {
@@ -51,6 +54,10 @@ FFN<
     inputDimensions(network.inputDimensions),
     predictors(network.predictors),
     responses(network.responses),
+    numThreads(network.numThreads),
+    numWorkers(network.numWorkers),
+    // The replicas are created again when they are first needed.
+    replicaWeights(nullptr),
     // These will be set correctly in the first Forward() call.
     layerMemoryIsSet(false),
     inputDimensionsAreSet(false)
@@ -73,6 +80,9 @@ FFN<
     inputDimensions(std::move(network.inputDimensions)),
     predictors(std::move(network.predictors)),
     responses(std::move(network.responses)),
+    numThreads(network.numThreads),
+    numWorkers(network.numWorkers),
+    replicaWeights(nullptr),
     // Aliases will not be correct after a std::move(), so we will manually
     // reset them.
     layerMemoryIsSet(false),
@@ -99,6 +109,9 @@ FFN<OutputLayerType, InitializationRuleType, MatType>& FFN<
     inputDimensions = other.inputDimensions;
     predictors = other.predictors;
     responses = other.responses;
+    numThreads = other.numThreads;
+    numWorkers = other.numWorkers;
+    replicaWeights = nullptr;
     networkOutput = other.networkOutput;
     networkDelta = other.networkDelta;
     error = other.error;
@@ -130,6 +143,9 @@ FFN<OutputLayerType, InitializationRuleType, MatType>& FFN<
     inputDimensions = std::move(other.inputDimensions);
     predictors = std::move(other.predictors);
     responses = std::move(other.responses);
+    numThreads = other.numThreads;
+    numWorkers = other.numWorkers;
+    replicaWeights = nullptr;
     networkOutput = std::move(other.networkOutput);
     networkDelta = std::move(other.networkDelta);
     error = std::move(other.error);
@@ -153,12 +169,27 @@ typename MatType::elem_type FFN<
          OptimizerType& optimizer,
          CallbackTypes&&... callbacks)
 {
+  // Use the requested number of threads for the layers' parallel loops.
+  ScopedNumThreads threads(numThreads);
+
   ResetData(std::move(predictors), std::move(responses));
 
   WarnMessageMaxIterations<OptimizerType>(optimizer, this->predictors.n_cols);
 
-  // Ensure that the network can be used.
+  // Ensure that the network can be used.  The workers get new copies of it,
+  // in case its layers were changed since the last call.
   CheckNetwork("FFN::Train()", this->predictors.n_rows, true, true);
+  replicaWeights = nullptr;
+
+  // Report how much activation memory each batch will need.
+  const MemoryPlan<MatType> plan(network.Network(), this->predictors.n_rows,
+      network.CheckpointInterval());
+  const size_t batchSize = OptimizerBatchSize(optimizer);
+  Log::Info << "FFN::Train(): peak activation memory is "
+      << plan.PeakBytes(batchSize) << " bytes per batch of " << batchSize
+      << " points (" << plan.UnplannedBytes(batchSize) << " bytes without "
+      << "reuse; " << plan.NumRecomputed() << " layer outputs recomputed)."
+      << std::endl;
 
   // Train the model.
   Timer::Start("ffn_optimization");
@@ -197,6 +228,9 @@ void FFN<
     MatType
 >::Predict(MatType predictors, MatType& results, const size_t batchSize)
 {
+  // Use the requested number of threads for the layers' parallel loops.
+  ScopedNumThreads threads(numThreads);
+
   // Ensure that the network is configured correctly.
   CheckNetwork("FFN::Predict()", predictors.n_rows, true, false);
 
@@ -212,10 +246,58 @@ void FFN<
     MatType resultAlias(results.colptr(i), results.n_rows,
         effectiveBatchSize, false, true);
 
-    network.Forward(predictorAlias, resultAlias);
+    network.ForwardOnly(predictorAlias, resultAlias);
   }
 }
 
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+InferencePlan<MatType> FFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::CompileForInference(const size_t maxBatchSize)
+{
+  if (inputDimensions.empty())
+  {
+    throw std::logic_error("FFN::CompileForInference(): input dimensions are "
+        "not known; set InputDimensions() or call Reset() first!");
+  }
+
+  // Ensure that the network is configured correctly, with all weights set.
+  const size_t inputSize = std::accumulate(inputDimensions.begin(),
+      inputDimensions.end(), size_t(1), std::multiplies<size_t>());
+  CheckNetwork("FFN::CompileForInference()", inputSize, true, false);
+
+  return InferencePlan<MatType>(network.Network(), inputDimensions,
+      maxBatchSize);
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+MemoryPlan<MatType> FFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::PlanMemory()
+{
+  if (inputDimensions.empty())
+  {
+    throw std::logic_error("FFN::PlanMemory(): input dimensions are not known; "
+        "set InputDimensions() or call Reset() first!");
+  }
+
+  // Ensure that the dimensions of all layers are known.
+  const size_t inputSize = std::accumulate(inputDimensions.begin(),
+      inputDimensions.end(), size_t(1), std::multiplies<size_t>());
+  CheckNetwork("FFN::PlanMemory()", inputSize);
+
+  return MemoryPlan<MatType>(network.Network(), inputSize,
+      network.CheckpointInterval());
+}
+
 template<typename OutputLayerType,
          typename InitializationRuleType,
          typename MatType>
@@ -251,8 +333,9 @@ void FFN<
   }
   else
   {
-    const size_t inputDims = std::accumulate(inputDimensions.begin(),
-        inputDimensions.end(), 0);
+    const size_t inputDims = inputDimensions.empty() ? 0 :
+        std::accumulate(inputDimensions.begin(), inputDimensions.end(),
+        size_t(1), std::multiplies<size_t>());
     CheckNetwork("FFN::Reset()", inputDims, true, false);
   }
 }
@@ -293,6 +376,8 @@ void FFN<
            const size_t begin,
            const size_t end)
 {
+  ScopedNumThreads threads(numThreads);
+
   // Sanity checking...
   if (end < begin)
     return;
@@ -322,19 +407,22 @@ typename MatType::elem_type FFN<
             const MatType& targets,
             MatType& gradients)
 {
+  ScopedNumThreads threads(numThreads);
+
   const typename MatType::elem_type res =
       outputLayer.Forward(networkOutput, targets) + network.Loss();
 
   // Compute the error of the output layer.
   outputLayer.Backward(networkOutput, targets, error);
 
-  // Perform the backward pass.
-  network.Backward(networkOutput, error, networkDelta);
-
-  // Now compute the gradients.
-  // The gradient should have the same size as the parameters.
+  // Perform the backward pass.  The delta should have the same size as the
+  // input.
+  // The gradients of the layers are computed during the backward pass, and
+  // should have the same size as the parameters.
+  networkDelta.set_size(inputs.n_rows, inputs.n_cols);
   gradients.set_size(parameters.n_rows, parameters.n_cols);
-  network.Gradient(inputs, error, gradients);
+  network.BackwardWithGradient(inputs, networkOutput, error, networkDelta,
+      gradients);
 
   return res;
 }
@@ -348,12 +436,15 @@ typename MatType::elem_type FFN<
     MatType
 >::Evaluate(const MatType& predictors, const MatType& responses)
 {
+  ScopedNumThreads threads(numThreads);
+
   // Sanity check: ensure network is valid.
   CheckNetwork("FFN::Evaluate()", predictors.n_rows);
 
   // Set networkOutput to the right size if needed, then perform the forward
-  // pass.
-  network.Forward(predictors, networkOutput);
+  // pass.  No backward pass follows, so the outputs of the layers are not kept.
+  networkOutput.set_size(network.OutputSize(), predictors.n_cols);
+  network.ForwardOnly(predictors, networkOutput);
 
   return outputLayer.Forward(networkOutput, responses) + network.Loss();
 }
@@ -392,6 +483,7 @@ void FFN<
 
     layerMemoryIsSet = false;
     inputDimensionsAreSet = false;
+    replicaWeights = nullptr;
 
     // The weights in `parameters` will be correctly set for each layer in the
     // first call to Forward().
@@ -425,12 +517,15 @@ typename MatType::elem_type FFN<
             const size_t begin,
             const size_t batchSize)
 {
+  ScopedNumThreads threads(numThreads);
+
   CheckNetwork("FFN::Evaluate()", predictors.n_rows);
 
   // Set networkOutput to the right size if needed, then perform the forward
-  // pass.
+  // pass.  No backward pass follows, so the outputs of the layers are not kept.
   networkOutput.set_size(network.OutputSize(), batchSize);
-  network.Forward(predictors.cols(begin, begin + batchSize - 1), networkOutput);
+  network.ForwardOnly(predictors.cols(begin, begin + batchSize - 1),
+      networkOutput);
 
   return outputLayer.Forward(networkOutput,
       responses.cols(begin, begin + batchSize - 1)) + network.Loss();
@@ -449,7 +544,7 @@ typename MatType::elem_type FFN<
   res += EvaluateWithGradient(parameters, 0, gradient, 1);
   for (size_t i = 1; i < predictors.n_cols; ++i)
   {
-    arma::mat tmpGradient(gradient.n_rows, gradient.n_cols);
+    MatType tmpGradient(gradient.n_rows, gradient.n_cols);
     res += EvaluateWithGradient(parameters, i, tmpGradient, 1);
     gradient += tmpGradient;
   }
@@ -469,8 +564,15 @@ typename MatType::elem_type FFN<
                         MatType& gradient,
                         const size_t batchSize)
 {
+  ScopedNumThreads threads(numThreads);
+
   CheckNetwork("FFN::EvaluateWithGradient()", predictors.n_rows);
 
+  // Split the batch across workers, if requested.
+  const size_t workers = Workers(batchSize);
+  if (workers > 1)
+    return EvaluateWithGradientParallel(begin, gradient, batchSize, workers);
+
   // Set networkOutput to the right size if needed, then perform the forward
   // pass.
   networkOutput.set_size(network.OutputSize(), batchSize);
@@ -485,18 +587,144 @@ typename MatType::elem_type FFN<
       responses.cols(begin, begin + batchSize - 1), error);
 
   // The delta should have the same size as the input.
+  // The gradients of the layers are computed during the backward pass, and
+  // should have the same size as the parameters.
   networkDelta.set_size(predictors.n_rows, batchSize);
-  network.Backward(networkOutput, error, networkDelta);
-
-  // Now compute the gradients.
-  // The gradient should have the same size as the parameters.
   gradient.set_size(parameters.n_rows, parameters.n_cols);
-  network.Gradient(predictors.cols(begin, begin + batchSize - 1), error,
-      gradient);
+  network.BackwardWithGradient(predictors.cols(begin, begin + batchSize - 1),
+      networkOutput, error, networkDelta, gradient);
 
   return obj;
 }
 
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+typename MatType::elem_type FFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::EvaluateWithGradientParallel(const size_t begin,
+                                MatType& gradient,
+                                const size_t batchSize,
+                                const size_t workers)
+{
+  typedef typename MatType::elem_type ElemType;
+
+  SetReplicas(workers - 1);
+  gradient.set_size(parameters.n_rows, parameters.n_cols);
+
+  // If the output layer takes the mean over the points of a batch, the shards
+  // must be weighted by their size.
+  const bool mean = MeanReduction(outputLayer);
+  std::vector<ElemType> objectives(workers), weights(workers, 1);
+
+  // Each worker passes its shard of the batch through its copy of the network.
+  // (The layers don't start parallel regions of their own inside this one.)
+  #pragma omp parallel for schedule(static, 1) num_threads(workers)
+  for (omp_size_t w = 0; w < (omp_size_t) workers; ++w)
+  {
+    const size_t shardBegin = begin + w * batchSize / workers;
+    const size_t shardEnd = begin + (w + 1) * batchSize / workers;
+    const size_t shardSize = shardEnd - shardBegin;
+
+    MultiLayer<MatType>& shardNetwork = (w == 0) ? network : replicas[w - 1];
+    OutputLayerType& shardOutputLayer = (w == 0) ? outputLayer :
+        replicaOutputLayers[w - 1];
+    MatType& shardOutput = (w == 0) ? networkOutput : replicaOutputs[w - 1];
+    MatType& shardError = (w == 0) ? error : replicaErrors[w - 1];
+    MatType& shardDelta = (w == 0) ? networkDelta : replicaDeltas[w - 1];
+    MatType& shardGradient = (w == 0) ? gradient : replicaGradients[w - 1];
+
+    const MatType shardPredictors = predictors.cols(shardBegin, shardEnd - 1);
+    const MatType shardResponses = responses.cols(shardBegin, shardEnd - 1);
+
+    shardOutput.set_size(network.OutputSize(), shardSize);
+    shardNetwork.Forward(shardPredictors, shardOutput);
+    objectives[w] = shardOutputLayer.Forward(shardOutput, shardResponses);
+    shardOutputLayer.Backward(shardOutput, shardResponses, shardError);
+
+    shardDelta.set_size(predictors.n_rows, shardSize);
+    shardGradient.set_size(parameters.n_rows, parameters.n_cols);
+    shardNetwork.BackwardWithGradient(shardPredictors, shardOutput, shardError,
+        shardDelta, shardGradient);
+
+    if (mean)
+      weights[w] = ElemType(shardSize) / ElemType(batchSize);
+  }
+
+  // Now sum the gradients of all shards into `gradient`.  Each thread sums one
+  // slice of the parameters over all shards, so every element is only touched
+  // by one thread, and the sum is always taken in the same order.
+  ParallelColumns(gradient.n_elem, 1, [&](const size_t first,
+                                          const size_t last)
+  {
+    MatType slice(gradient.memptr() + first, last - first, 1, false, true);
+    slice *= weights[0];
+    for (size_t w = 1; w < workers; ++w)
+    {
+      slice += weights[w] * MatType(replicaGradients[w - 1].memptr() + first,
+          last - first, 1, false, true);
+    }
+  });
+
+  ElemType objective = 0;
+  for (size_t w = 0; w < workers; ++w)
+    objective += weights[w] * objectives[w];
+
+  return objective + network.Loss();
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+size_t FFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::Workers(const size_t batchSize) const
+{
+  size_t workers = 1;
+  #ifdef HAS_OPENMP
+    workers = (numWorkers == 0) ? (size_t) omp_get_max_threads() : numWorkers;
+  #endif
+
+  return std::min(workers, batchSize);
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+void FFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::SetReplicas(const size_t count)
+{
+  if (replicaWeights != parameters.memptr() || replicas.size() < count)
+  {
+    replicas.clear();
+    replicaOutputLayers.clear();
+    replicas.reserve(count);
+    replicaOutputLayers.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+      replicas.push_back(network);
+      replicas.back().SetWeights(parameters.memptr());
+      replicaOutputLayers.push_back(outputLayer);
+    }
+
+    replicaOutputs.resize(count);
+    replicaErrors.resize(count);
+    replicaDeltas.resize(count);
+    replicaGradients.resize(count);
+    replicaWeights = parameters.memptr();
+  }
+
+  for (size_t i = 0; i < replicas.size(); ++i)
+    replicas[i].Training() = network.Training();
+}
+
 template<typename OutputLayerType,
          typename InitializationRuleType,
          typename MatType>
@@ -703,6 +931,72 @@ FFN<
   // Nothing to do here.
 }
 
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+template<typename OptimizerType>
+typename std::enable_if<
+    HasBatchSizeCheck<OptimizerType, size_t(OptimizerType::*)() const>::value,
+    size_t
+>::type
+FFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::OptimizerBatchSize(OptimizerType& optimizer) const
+{
+  return optimizer.BatchSize();
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+template<typename OptimizerType>
+typename std::enable_if<
+    !HasBatchSizeCheck<OptimizerType, size_t(OptimizerType::*)() const>::value,
+    size_t
+>::type
+FFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::OptimizerBatchSize(OptimizerType& /* optimizer */) const
+{
+  return 1;
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+template<typename LossType>
+typename std::enable_if<
+    HasReductionCheck<LossType, bool(LossType::*)() const>::value, bool
+>::type
+FFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::MeanReduction(const LossType& loss) const
+{
+  return !loss.Reduction();
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+template<typename LossType>
+typename std::enable_if<
+    !HasReductionCheck<LossType, bool(LossType::*)() const>::value, bool
+>::type
+FFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::MeanReduction(const LossType& /* loss */) const
+{
+  return false;
+}
+
 } // namespace ann
 } // namespace mlpack
 
@@ -0,0 +1,253 @@
+/**
+ * @file methods/ann/inference_plan.hpp
+ *
+ * Definition of the InferencePlan class, an immutable and fused version of a
+ * trained feedforward network that only supports the forward pass.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_INFERENCE_PLAN_HPP
+#define MLPACK_METHODS_ANN_INFERENCE_PLAN_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <mlpack/methods/ann/make_alias.hpp>
+#include <mlpack/methods/ann/layer/layer.hpp>
+#include <mlpack/methods/ann/layer/base_layer.hpp>
+#include <mlpack/methods/ann/layer/convolution.hpp>
+#include <mlpack/methods/ann/layer/dropout.hpp>
+#include <mlpack/methods/ann/layer/leaky_relu.hpp>
+#include <mlpack/methods/ann/layer/linear.hpp>
+#include <mlpack/methods/ann/layer/linear_no_bias.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * An InferencePlan is a snapshot of the layers of a trained network, compiled
+ * for prediction only.  It is usually created with
+ * `FFN::CompileForInference()`.  While compiling,
+ *
+ *  - `Dropout` layers are removed, since they are the identity at prediction
+ *    time;
+ *  - `Linear` and `LinearNoBias` layers are fused with a following `ReLU`,
+ *    `LeakyReLU`, `Sigmoid` or `TanH` layer, so that the bias and the
+ *    activation are applied in the same pass over the output;
+ *  - `Convolution` layers are fused with the same activations, and are computed
+ *    with the padding, im2col lowering, matrix multiplication, bias and
+ *    activation of the whole batch in preallocated memory;
+ *  - every other layer is kept as it is, and evaluated with its `Forward()`.
+ *
+ * The weights are copied, so the plan is not affected by later changes to the
+ * network.  The plan itself is never modified by `Predict()`: all memory used
+ * during a prediction lives in a `Workspace`, which holds a ping-pong pair of
+ * activation buffers sized for `MaxBatchSize()` points, the scratch space of
+ * the convolutions and private copies of the layers that are not fused.  So,
+ * one plan can be shared by any number of threads, as long as each thread uses
+ * its own workspace:
+ *
+ * @code
+ * FFN<> model;
+ * // ... build and train the model ...
+ * const InferencePlan<> plan = model.CompileForInference(64);
+ *
+ * #pragma omp parallel
+ * {
+ *   InferencePlan<>::Workspace workspace = plan.CreateWorkspace();
+ *   // ... plan.Predict(input, output, workspace) for any number of inputs ...
+ * }
+ * @endcode
+ *
+ * Inputs with more points than `MaxBatchSize()` are processed in blocks of
+ * `MaxBatchSize()` points, so no memory is allocated during `Predict()` once a
+ * workspace exists (besides the output, if it does not have the right size).
+ *
+ * @tparam MatType Matrix representation to accept as input and use for
+ *    computation.
+ */
+template<typename MatType = arma::mat>
+class InferencePlan
+{
+ public:
+  //! The element-wise activations that can be fused into a step (IDENTITY
+  //! means that no activation follows).
+  enum class Activation
+  {
+    IDENTITY,
+    RELU,
+    LEAKY_RELU,
+    SIGMOID,
+    TANH
+  };
+
+  /**
+   * The memory used by one prediction at a time.  Create it with
+   * `CreateWorkspace()`; it can then be reused for any number of calls to
+   * `Predict()` on the plan that created it (but not on other plans).
+   */
+  class Workspace
+  {
+   public:
+    //! Create an empty workspace; it must be assigned before use.
+    Workspace() { }
+
+   private:
+    //! Two activation buffers, each of maxSize x maxBatchSize elements.
+    MatType arena;
+    //! Memory for the lowered input of the largest convolution.
+    MatType lowered;
+    //! Memory for the result of the largest convolution.
+    MatType convolved;
+    //! Memory for the padded input of the largest convolution.
+    MatType padded;
+    //! Copies of the layers that are evaluated with their `Forward()`.
+    std::vector<std::unique_ptr<Layer<MatType>>> layers;
+
+    friend class InferencePlan;
+  };
+
+  //! Create an empty plan, which passes its input through unchanged.
+  InferencePlan();
+
+  /**
+   * Compile the given layers, which must already have their input dimensions
+   * and weights set (e.g. after a forward pass or `Reset()` of the network).
+   *
+   * @param network Layers to compile, in order.
+   * @param inputDimensions Dimensions of the input of the first layer.
+   * @param maxBatchSize Maximum number of points processed at once.
+   */
+  InferencePlan(const std::vector<Layer<MatType>*>& network,
+                const std::vector<size_t>& inputDimensions,
+                const size_t maxBatchSize = 1);
+
+  //! Create a new workspace for use with `Predict()`.
+  Workspace CreateWorkspace() const;
+
+  /**
+   * Compute the output of the network for the given points, using the given
+   * workspace for all temporary storage.
+   *
+   * @param input Points to predict, one per column.
+   * @param output Matrix to store the output of the network in.
+   * @param workspace Workspace created by `CreateWorkspace()` on this plan.
+   */
+  void Predict(const MatType& input,
+               MatType& output,
+               Workspace& workspace) const;
+
+  /**
+   * Compute the output of the network for the given points, with a temporary
+   * workspace.  Use the overload that takes a workspace to avoid allocating
+   * memory for each call.
+   *
+   * @param input Points to predict, one per column.
+   * @param output Matrix to store the output of the network in.
+   */
+  void Predict(const MatType& input, MatType& output) const;
+
+  //! Get the number of steps of the plan (after fusion).
+  size_t NumSteps() const { return steps.size(); }
+  //! Get the number of steps that are evaluated with a layer's `Forward()`.
+  size_t NumLayerSteps() const { return numLayerSteps; }
+  //! Get the maximum number of points processed at once.
+  size_t MaxBatchSize() const { return maxBatchSize; }
+  //! Get the number of elements of each input point.
+  size_t InputSize() const { return inputSize; }
+  //! Get the number of elements of each output point.
+  size_t OutputSize() const { return outputSize; }
+
+ private:
+  //! The kind of computation performed by a step.
+  enum class StepType
+  {
+    DENSE,
+    CONVOLUTION,
+    LAYER
+  };
+
+  //! One step of the plan.
+  struct Step
+  {
+    //! The kind of computation.
+    StepType type;
+    //! Number of input elements of each point.
+    size_t inSize;
+    //! Number of output elements of each point.
+    size_t outSize;
+    //! Activation applied to the output.
+    Activation activation;
+    //! Slope of the LeakyReLU activation.
+    double alpha;
+    //! Dense weights (outSize x inSize), convolution filters (one column per
+    //! output map), or the weights of the layer of a LAYER step.
+    MatType weight;
+    //! Bias (one element per output row or output map); may be empty.
+    arma::Col<typename MatType::elem_type> bias;
+
+    //! Convolution: rows and columns of each input map.
+    size_t inRows, inCols;
+    //! Convolution: number of input maps, and number of independent images
+    //! per point (the product of the dimensions higher than the third).
+    size_t inMaps, higherDimensions;
+    //! Convolution: kernel size and stride.
+    size_t kernelRows, kernelCols, strideRows, strideCols;
+    //! Convolution: padding on each side of the rows and columns.
+    size_t padTop, padBottom, padLeft, padRight;
+    //! Convolution: rows and columns of each output map, and the number of
+    //! output maps.
+    size_t outRows, outCols, maps;
+
+    //! Layer evaluated with `Forward()`; copied into each workspace.
+    std::shared_ptr<const Layer<MatType>> layer;
+    //! Index of the copy of the layer in a workspace.
+    size_t layerIndex;
+  };
+
+  /**
+   * If the given layer is an activation that can be fused, store it in the
+   * step and return true.
+   */
+  static bool FuseActivation(Layer<MatType>* layer, Step& step);
+
+  //! Apply the given step to a block of points.
+  void Forward(const Step& step,
+               const MatType& input,
+               MatType& output,
+               Workspace& workspace) const;
+
+  //! Apply the activation of the step to one element.
+  static typename MatType::elem_type Activate(
+      const Step& step,
+      const typename MatType::elem_type x);
+
+  //! The steps of the plan.
+  std::vector<Step> steps;
+  //! The number of steps evaluated with a layer's `Forward()`.
+  size_t numLayerSteps;
+  //! The maximum number of points processed at once.
+  size_t maxBatchSize;
+  //! The number of elements of each input point.
+  size_t inputSize;
+  //! The number of elements of each output point.
+  size_t outputSize;
+  //! The largest output of any step, per point.
+  size_t maxSize;
+  //! The largest lowered input of any convolution, per point.
+  size_t maxLoweredSize;
+  //! The largest result of any convolution, per point.
+  size_t maxConvolvedSize;
+  //! The largest padded input of any convolution, per point.
+  size_t maxPaddedSize;
+}; // class InferencePlan
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "inference_plan_impl.hpp"
+
+#endif
@@ -0,0 +1,395 @@
+/**
+ * @file methods/ann/inference_plan_impl.hpp
+ *
+ * Implementation of the InferencePlan class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_INFERENCE_PLAN_IMPL_HPP
+#define MLPACK_METHODS_ANN_INFERENCE_PLAN_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "inference_plan.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename MatType>
+InferencePlan<MatType>::InferencePlan() :
+    numLayerSteps(0),
+    maxBatchSize(1),
+    inputSize(0),
+    outputSize(0),
+    maxSize(0),
+    maxLoweredSize(0),
+    maxConvolvedSize(0),
+    maxPaddedSize(0)
+{
+  // Nothing to do here.
+}
+
+template<typename MatType>
+InferencePlan<MatType>::InferencePlan(
+    const std::vector<Layer<MatType>*>& network,
+    const std::vector<size_t>& inputDimensions,
+    const size_t maxBatchSize) :
+    numLayerSteps(0),
+    maxBatchSize(std::max(maxBatchSize, size_t(1))),
+    inputSize(std::accumulate(inputDimensions.begin(), inputDimensions.end(),
+        size_t(1), std::multiplies<size_t>())),
+    outputSize(0),
+    maxSize(0),
+    maxLoweredSize(0),
+    maxConvolvedSize(0),
+    maxPaddedSize(0)
+{
+  typedef ConvolutionType<
+      Im2ColConvolution<ValidConvolution>,
+      Im2ColConvolution<FullConvolution>,
+      Im2ColConvolution<ValidConvolution>,
+      MatType
+  > Im2ColConvolutionLayer;
+
+  size_t currentSize = inputSize;
+  size_t i = 0;
+  while (i < network.size())
+  {
+    Layer<MatType>* layer = network[i++];
+
+    // Dropout does nothing at prediction time.
+    if (dynamic_cast<DropoutType<MatType>*>(layer) != nullptr)
+      continue;
+
+    Step step;
+    step.type = StepType::LAYER;
+    step.inSize = currentSize;
+    step.outSize = layer->OutputSize();
+    step.activation = Activation::IDENTITY;
+    step.alpha = 0.0;
+
+    if (LinearType<MatType, NoRegularizer>* linear =
+        dynamic_cast<LinearType<MatType, NoRegularizer>*>(layer))
+    {
+      step.type = StepType::DENSE;
+      step.weight = linear->Weight();
+      step.bias = arma::vectorise(linear->Bias());
+    }
+    else if (LinearNoBiasType<MatType, NoRegularizer>* linearNoBias =
+        dynamic_cast<LinearNoBiasType<MatType, NoRegularizer>*>(layer))
+    {
+      step.type = StepType::DENSE;
+      step.weight = linearNoBias->Parameters();
+    }
+    else if (Im2ColConvolutionLayer* conv =
+        dynamic_cast<Im2ColConvolutionLayer*>(layer))
+    {
+      const std::vector<size_t>& inDims = conv->InputDimensions();
+      const std::vector<size_t>& outDims = conv->OutputDimensions();
+
+      step.inRows = inDims[0];
+      step.inCols = (inDims.size() > 1) ? inDims[1] : 1;
+      step.inMaps = (inDims.size() > 2) ? inDims[2] : 1;
+      step.higherDimensions = 1;
+      for (size_t d = 3; d < inDims.size(); ++d)
+        step.higherDimensions *= inDims[d];
+      step.kernelRows = conv->KernelWidth();
+      step.kernelCols = conv->KernelHeight();
+      step.strideRows = conv->StrideWidth();
+      step.strideCols = conv->StrideHeight();
+      // This is where the Padding layer used by the convolution puts the
+      // input.
+      step.padTop = conv->PadHTop();
+      step.padBottom = conv->PadHBottom();
+      step.padLeft = conv->PadWLeft();
+      step.padRight = conv->PadWRight();
+      step.outRows = outDims[0];
+      step.outCols = outDims[1];
+      step.maps = conv->Maps();
+
+      // Only fuse the convolution if the padded input has the size the layer
+      // expects; otherwise, fall back to the layer itself.
+      const size_t paddedRows = step.inRows + step.padTop + step.padBottom;
+      const size_t paddedCols = step.inCols + step.padLeft + step.padRight;
+      if (paddedRows >= step.kernelRows && paddedCols >= step.kernelCols &&
+          (paddedRows - step.kernelRows) / step.strideRows + 1 ==
+              step.outRows &&
+          (paddedCols - step.kernelCols) / step.strideCols + 1 == step.outCols)
+      {
+        step.type = StepType::CONVOLUTION;
+        const arma::Cube<typename MatType::elem_type>& weight = conv->Weight();
+        step.weight = MatType(
+            const_cast<typename MatType::elem_type*>(weight.memptr()),
+            weight.n_elem / step.maps, step.maps);
+        step.bias = arma::vectorise(conv->Bias());
+
+        const size_t images = step.inMaps * step.higherDimensions;
+        const size_t outSize = step.outRows * step.outCols;
+        maxLoweredSize = std::max(maxLoweredSize, outSize *
+            step.higherDimensions * (size_t) step.weight.n_rows);
+        maxConvolvedSize = std::max(maxConvolvedSize, outSize *
+            step.higherDimensions * step.maps);
+        if (paddedRows != step.inRows || paddedCols != step.inCols)
+        {
+          maxPaddedSize = std::max(maxPaddedSize, paddedRows * paddedCols *
+              images);
+        }
+      }
+    }
+
+    if (step.type == StepType::LAYER)
+    {
+      // The copy is always used in testing mode.  Copies of layers don't hold
+      // weights, so the step keeps its own copy of them; the copies of the
+      // layer in each workspace point to it.
+      Layer<MatType>* copy = layer->Clone();
+      copy->Training() = false;
+      if (layer->WeightSize() > 0)
+        step.weight = layer->Parameters();
+      step.layer.reset(copy);
+      step.layerIndex = numLayerSteps++;
+    }
+    else
+    {
+      // Fuse the activation that follows, if any (skipping dropout).
+      while (i < network.size() &&
+          dynamic_cast<DropoutType<MatType>*>(network[i]) != nullptr)
+      {
+        ++i;
+      }
+
+      if (i < network.size() && FuseActivation(network[i], step))
+        ++i;
+    }
+
+    currentSize = step.outSize;
+    maxSize = std::max(maxSize, step.outSize);
+    steps.push_back(std::move(step));
+  }
+
+  outputSize = currentSize;
+}
+
+template<typename MatType>
+bool InferencePlan<MatType>::FuseActivation(Layer<MatType>* layer, Step& step)
+{
+  if (dynamic_cast<ReLUType<MatType>*>(layer) != nullptr)
+  {
+    step.activation = Activation::RELU;
+  }
+  else if (LeakyReLUType<MatType>* leakyReLU =
+      dynamic_cast<LeakyReLUType<MatType>*>(layer))
+  {
+    step.activation = Activation::LEAKY_RELU;
+    step.alpha = leakyReLU->Alpha();
+  }
+  else if (dynamic_cast<SigmoidType<MatType>*>(layer) != nullptr)
+  {
+    step.activation = Activation::SIGMOID;
+  }
+  else if (dynamic_cast<TanHType<MatType>*>(layer) != nullptr)
+  {
+    step.activation = Activation::TANH;
+  }
+  else
+  {
+    return false;
+  }
+
+  return true;
+}
+
+template<typename MatType>
+typename InferencePlan<MatType>::Workspace
+InferencePlan<MatType>::CreateWorkspace() const
+{
+  Workspace workspace;
+  workspace.arena.set_size(maxSize, 2 * maxBatchSize);
+  workspace.lowered.set_size(maxLoweredSize * maxBatchSize, 1);
+  workspace.convolved.set_size(maxConvolvedSize * maxBatchSize, 1);
+  workspace.padded.set_size(maxPaddedSize * maxBatchSize, 1);
+
+  workspace.layers.resize(numLayerSteps);
+  for (const Step& step : steps)
+  {
+    if (step.type == StepType::LAYER)
+    {
+      Layer<MatType>* copy = step.layer->Clone();
+      if (!step.weight.is_empty())
+      {
+        copy->SetWeights(const_cast<typename MatType::elem_type*>(
+            step.weight.memptr()));
+      }
+      workspace.layers[step.layerIndex].reset(copy);
+    }
+  }
+
+  return workspace;
+}
+
+template<typename MatType>
+void InferencePlan<MatType>::Predict(const MatType& input,
+                                     MatType& output,
+                                     Workspace& workspace) const
+{
+  if (input.n_rows != inputSize)
+  {
+    std::ostringstream oss;
+    oss << "InferencePlan::Predict(): input has " << input.n_rows
+        << " dimensions, but the network expects " << inputSize << "!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (workspace.layers.size() != numLayerSteps ||
+      workspace.arena.n_cols != 2 * maxBatchSize ||
+      workspace.arena.n_rows != maxSize)
+  {
+    throw std::invalid_argument("InferencePlan::Predict(): workspace was not "
+        "created by this plan!");
+  }
+
+  output.set_size(outputSize, input.n_cols);
+  if (steps.empty())
+  {
+    output = input;
+    return;
+  }
+
+  for (size_t begin = 0; begin < input.n_cols; begin += maxBatchSize)
+  {
+    const size_t n = std::min(maxBatchSize, (size_t) input.n_cols - begin);
+
+    // Each step reads the output of the previous step from one half of the
+    // arena and writes to the other half; the last step writes directly into
+    // the output.
+    MatType current(const_cast<typename MatType::elem_type*>(
+        input.colptr(begin)), inputSize, n, false, true);
+    for (size_t s = 0; s < steps.size(); ++s)
+    {
+      typename MatType::elem_type* memory = (s + 1 == steps.size()) ?
+          output.colptr(begin) :
+          workspace.arena.colptr((s % 2) * maxBatchSize);
+      MatType next(memory, steps[s].outSize, n, false, true);
+
+      Forward(steps[s], current, next, workspace);
+
+      // Make `current` an alias of the output of this step.
+      current.~MatType();
+      new (&current) MatType(memory, steps[s].outSize, n, false, true);
+    }
+  }
+}
+
+template<typename MatType>
+void InferencePlan<MatType>::Predict(const MatType& input,
+                                     MatType& output) const
+{
+  Workspace workspace = CreateWorkspace();
+  Predict(input, output, workspace);
+}
+
+template<typename MatType>
+void InferencePlan<MatType>::Forward(const Step& step,
+                                     const MatType& input,
+                                     MatType& output,
+                                     Workspace& workspace) const
+{
+  typedef typename MatType::elem_type ElemType;
+
+  if (step.type == StepType::DENSE)
+  {
+    output = step.weight * input;
+
+    // Add the bias and apply the activation in a single pass.
+    const bool hasBias = !step.bias.is_empty();
+    for (size_t j = 0; j < output.n_cols; ++j)
+    {
+      ElemType* column = output.colptr(j);
+      for (size_t r = 0; r < output.n_rows; ++r)
+        column[r] = Activate(step, column[r] + (hasBias ? step.bias[r] : 0));
+    }
+  }
+  else if (step.type == StepType::CONVOLUTION)
+  {
+    const size_t images = step.inMaps * step.higherDimensions * input.n_cols;
+    const size_t paddedRows = step.inRows + step.padTop + step.padBottom;
+    const size_t paddedCols = step.inCols + step.padLeft + step.padRight;
+
+    const arma::Cube<ElemType> inputCube(const_cast<ElemType*>(
+        input.memptr()), step.inRows, step.inCols, images, false, true);
+
+    // Pad the input into the workspace, if needed.
+    arma::Cube<ElemType> paddedCube;
+    const bool usingPadding = (paddedRows != step.inRows ||
+        paddedCols != step.inCols);
+    if (usingPadding)
+    {
+      MakeAlias(paddedCube, workspace.padded.memptr(), paddedRows, paddedCols,
+          images);
+      paddedCube.zeros();
+      paddedCube.tube(step.padTop, step.padLeft,
+          step.padTop + step.inRows - 1, step.padLeft + step.inCols - 1) =
+          inputCube;
+    }
+
+    // Lower all maps of all images at once, and convolve them with all of the
+    // filters with one matrix multiplication.
+    const size_t outSize = step.outRows * step.outCols;
+    const size_t points = step.higherDimensions * input.n_cols;
+    MatType lowered(workspace.lowered.memptr(), outSize * points,
+        step.weight.n_rows, false, true);
+    Im2ColConvolution<ValidConvolution>::Im2Col(
+        usingPadding ? paddedCube : inputCube, step.inMaps, step.kernelRows,
+        step.kernelCols, step.strideRows, step.strideCols, 1, 1, lowered);
+
+    MatType convolved(workspace.convolved.memptr(), outSize * points,
+        step.maps, false, true);
+    convolved = lowered * step.weight;
+
+    // The rows of the result are ordered by point; the output of each point
+    // is its maps one after another.  Copy each map, add its bias and apply
+    // the activation in a single pass.
+    for (size_t p = 0; p < points; ++p)
+    {
+      for (size_t m = 0; m < step.maps; ++m)
+      {
+        ElemType* out = output.memptr() + (p * step.maps + m) * outSize;
+        const ElemType* in = convolved.colptr(m) + p * outSize;
+        const ElemType bias = step.bias.is_empty() ? 0 : step.bias[m];
+        for (size_t e = 0; e < outSize; ++e)
+          out[e] = Activate(step, in[e] + bias);
+      }
+    }
+  }
+  else
+  {
+    workspace.layers[step.layerIndex]->Forward(input, output);
+  }
+}
+
+template<typename MatType>
+inline typename MatType::elem_type InferencePlan<MatType>::Activate(
+    const Step& step,
+    const typename MatType::elem_type x)
+{
+  switch (step.activation)
+  {
+    case Activation::RELU:
+      return (x > 0) ? x : 0;
+    case Activation::LEAKY_RELU:
+      return std::max(x, typename MatType::elem_type(step.alpha * x));
+    case Activation::SIGMOID:
+      return 1 / (1 + std::exp(-x));
+    case Activation::TANH:
+      return std::tanh(x);
+    default:
+      return x;
+  }
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
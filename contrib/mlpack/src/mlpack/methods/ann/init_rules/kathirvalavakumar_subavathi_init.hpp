@@ -70,7 +70,8 @@ class KathirvalavakumarSubavathiInitialization
   KathirvalavakumarSubavathiInitialization(const arma::Mat<eT>& data,
                                            const double s) : s(s)
   {
-    dataSum = arma::sum(data % data);
+    // The sums are kept in double precision, whatever the type of the data.
+    dataSum = arma::conv_to<arma::rowvec>::from(arma::sum(data % data));
   }
 
   /**
@@ -84,7 +85,7 @@ class KathirvalavakumarSubavathiInitialization
   template<typename eT>
   void Initialize(arma::Mat<eT>& W, const size_t rows, const size_t cols)
   {
-    arma::Row<eT> b = s * arma::sqrt(3 / (rows * dataSum));
+    const arma::rowvec b = s * arma::sqrt(3 / (rows * dataSum));
     const double theta = b.min();
     RandomInitialization randomInit(-theta, theta);
     randomInit.Initialize(W, rows, cols);
@@ -99,7 +100,7 @@ class KathirvalavakumarSubavathiInitialization
   template<typename eT>
   void Initialize(arma::Mat<eT>& W)
   {
-    arma::Row<eT> b = s * arma::sqrt(3 / (W.n_rows * dataSum));
+    const arma::rowvec b = s * arma::sqrt(3 / (W.n_rows * dataSum));
     const double theta = b.min();
     RandomInitialization randomInit(-theta, theta);
     randomInit.Initialize(W);
@@ -72,8 +72,8 @@ class NetworkInitialization
         // Initialize the layer with the specified parameter/weight
         // initialization rule.
         const size_t weight = network[i]->WeightSize();
-        arma::Mat<eT> tmp = arma::mat(parameters.memptr() + offset,
-            weight, 1, false, false);
+        arma::Mat<eT> tmp(parameters.memptr() + offset, weight, 1, false,
+            false);
         initializeRule.Initialize(tmp, tmp.n_elem, 1);
 
         // Increase the parameter/weight offset for the next layer.
@@ -88,7 +88,8 @@ void AddType<MatType>::Gradient(
     const MatType& error,
     MatType& gradient)
 {
-  gradient = error;
+  // The same weights are added to every point of the batch.
+  gradient = arma::sum(error, 1);
 }
 
 template<typename MatType>
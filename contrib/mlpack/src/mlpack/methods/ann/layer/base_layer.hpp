@@ -30,6 +30,8 @@
 #include <mlpack/methods/ann/activation_functions/hard_swish_function.hpp>
 #include <mlpack/methods/ann/activation_functions/tanh_exponential_function.hpp>
 #include <mlpack/methods/ann/activation_functions/silu_function.hpp>
+#include <mlpack/methods/ann/activation_functions/fast_activation_functions.hpp>
+#include <mlpack/methods/ann/parallel_columns.hpp>
 #include "layer.hpp"
 
 namespace mlpack {
@@ -91,7 +93,19 @@ class BaseLayer : public Layer<MatType>
    */
   void Forward(const MatType& input, MatType& output)
   {
-    ActivationFunction::Fn(input, output);
+    // The activation is applied to blocks of points in parallel, each written
+    // through an alias of the output.
+    output.set_size(arma::size(input));
+    ParallelColumns(input.n_cols, input.n_rows,
+        [&](const size_t begin, const size_t end)
+    {
+      const MatType inputBlock(
+          const_cast<typename MatType::elem_type*>(input.colptr(begin)),
+          input.n_rows, end - begin, false, true);
+      MatType outputBlock(output.colptr(begin), output.n_rows, end - begin,
+          false, true);
+      ActivationFunction::Fn(inputBlock, outputBlock);
+    });
   }
 
   /**
@@ -104,9 +118,17 @@ class BaseLayer : public Layer<MatType>
    */
   void Backward(const MatType& input, const MatType& gy, MatType& g)
   {
-    MatType derivative;
-    ActivationFunction::Deriv(input, derivative);
-    g = gy % derivative;
+    g.set_size(arma::size(gy));
+    ParallelColumns(input.n_cols, input.n_rows,
+        [&](const size_t begin, const size_t end)
+    {
+      const MatType inputBlock(
+          const_cast<typename MatType::elem_type*>(input.colptr(begin)),
+          input.n_rows, end - begin, false, true);
+      MatType derivative;
+      ActivationFunction::Deriv(inputBlock, derivative);
+      g.cols(begin, end - 1) = gy.cols(begin, end - 1) % derivative;
+    });
   }
 
   /**
@@ -242,6 +264,63 @@ typedef BaseLayer<SILUFunction, arma::mat> SILU;
 template<typename MatType = arma::mat>
 using SILUType = BaseLayer<SILUFunction, MatType>;
 
+// The layers below use approximations of the activation functions (see
+// fast_math.hpp) that are much cheaper to compute, with bounded error.  They
+// can replace the exact layers in any network.
+
+/**
+ * Sigmoid layer using an approximation of the logistic function.
+ */
+typedef BaseLayer<FastLogisticFunction, arma::mat> FastSigmoid;
+
+template<typename MatType = arma::mat>
+using FastSigmoidType = BaseLayer<FastLogisticFunction, MatType>;
+
+/**
+ * Hyperbolic tangent layer using an approximation of the tanh function.
+ */
+typedef BaseLayer<FastTanhFunction, arma::mat> FastTanH;
+
+template<typename MatType = arma::mat>
+using FastTanHType = BaseLayer<FastTanhFunction, MatType>;
+
+/**
+ * Softplus layer using an approximation of the softplus function.
+ */
+typedef BaseLayer<FastSoftplusFunction, arma::mat> FastSoftPlus;
+
+template<typename MatType = arma::mat>
+using FastSoftPlusType = BaseLayer<FastSoftplusFunction, MatType>;
+
+/**
+ * Swish (or SILU) layer using an approximation of the swish function.
+ */
+typedef BaseLayer<FastSwishFunction, arma::mat> FastSwish;
+
+template<typename MatType = arma::mat>
+using FastSwishType = BaseLayer<FastSwishFunction, MatType>;
+
+typedef BaseLayer<FastSwishFunction, arma::mat> FastSILU;
+
+template<typename MatType = arma::mat>
+using FastSILUType = BaseLayer<FastSwishFunction, MatType>;
+
+/**
+ * GELU layer using an approximation of the GELU function.
+ */
+typedef BaseLayer<FastGELUFunction, arma::mat> FastGELU;
+
+template<typename MatType = arma::mat>
+using FastGELUType = BaseLayer<FastGELUFunction, MatType>;
+
+/**
+ * Mish layer using an approximation of the Mish function.
+ */
+typedef BaseLayer<FastMishFunction, arma::mat> FastMish;
+
+template<typename MatType = arma::mat>
+using FastMishType = BaseLayer<FastMishFunction, MatType>;
+
 } // namespace ann
 } // namespace mlpack
 
@@ -18,6 +18,7 @@
 #include <mlpack/methods/ann/convolution_rules/naive_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/fft_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/svd_convolution.hpp>
+#include <mlpack/methods/ann/convolution_rules/im2col_convolution.hpp>
 #include <mlpack/core/util/to_lower.hpp>
 
 #include "layer.hpp"
@@ -59,6 +60,13 @@ namespace ann /** Artificial Neural Network. */ {
  * a 2-D image (or object) of the original 196x14 size, using this as the input
  * for the 14 filters of this example.
  *
+ * By default, the layer uses `Im2ColConvolution` for all three passes: all of
+ * the input maps of all of the points in the batch are lowered into one
+ * matrix, and the forward pass, the backward pass and the gradient are each
+ * computed with a single matrix multiplication.  Any other convolution rule
+ * (e.g. `NaiveConvolution`) is instead applied to each pair of input and
+ * output maps of each point separately.
+ *
  * @tparam ForwardConvolutionRule Convolution to perform forward process.
  * @tparam BackwardConvolutionRule Convolution to perform backward process.
  * @tparam GradientConvolutionRule Convolution to calculate gradient.
@@ -66,9 +74,9 @@ namespace ann /** Artificial Neural Network. */ {
  *    computation.
  */
 template <
-    typename ForwardConvolutionRule = NaiveConvolution<ValidConvolution>,
-    typename BackwardConvolutionRule = NaiveConvolution<FullConvolution>,
-    typename GradientConvolutionRule = NaiveConvolution<ValidConvolution>,
+    typename ForwardConvolutionRule = Im2ColConvolution<ValidConvolution>,
+    typename BackwardConvolutionRule = Im2ColConvolution<FullConvolution>,
+    typename GradientConvolutionRule = Im2ColConvolution<ValidConvolution>,
     typename MatType = arma::mat
 >
 class ConvolutionType : public Layer<MatType>
@@ -287,6 +295,79 @@ class ConvolutionType : public Layer<MatType>
    */
   void InitializeSamePadding();
 
+  /**
+   * Compute the convolution of the (padded) input with each filter, applying
+   * ForwardConvolutionRule to each pair of input and output maps.
+   */
+  template<typename RuleType = ForwardConvolutionRule>
+  void ForwardConvolution(
+      const arma::Cube<typename MatType::elem_type>& input,
+      MatType& output,
+      const std::enable_if_t<!IsIm2ColConvolution<RuleType>::value>* = 0);
+
+  /**
+   * Compute the convolution of the (padded) input with each filter, as a
+   * single product of the lowered input with the filters.
+   */
+  template<typename RuleType = ForwardConvolutionRule>
+  void ForwardConvolution(
+      const arma::Cube<typename MatType::elem_type>& input,
+      MatType& output,
+      const std::enable_if_t<IsIm2ColConvolution<RuleType>::value>* = 0);
+
+  /**
+   * Compute the error with respect to the input, applying
+   * BackwardConvolutionRule to each pair of input and output maps.
+   */
+  template<typename RuleType = BackwardConvolutionRule>
+  void BackwardConvolution(
+      const MatType& gy,
+      MatType& g,
+      const std::enable_if_t<!IsIm2ColConvolution<RuleType>::value>* = 0);
+
+  /**
+   * Compute the error with respect to the input by multiplying the error with
+   * the filters and adding the result back into the shape of the input
+   * (col2im).
+   */
+  template<typename RuleType = BackwardConvolutionRule>
+  void BackwardConvolution(
+      const MatType& gy,
+      MatType& g,
+      const std::enable_if_t<IsIm2ColConvolution<RuleType>::value>* = 0);
+
+  /**
+   * Compute the gradient of the filters and bias, applying
+   * GradientConvolutionRule to each pair of input and output maps.
+   */
+  template<typename RuleType = GradientConvolutionRule>
+  void GradientConvolution(
+      const MatType& input,
+      const MatType& error,
+      MatType& gradient,
+      const std::enable_if_t<!IsIm2ColConvolution<RuleType>::value>* = 0);
+
+  /**
+   * Compute the gradient of the filters and bias as a single product of the
+   * lowered input with the error.
+   */
+  template<typename RuleType = GradientConvolutionRule>
+  void GradientConvolution(
+      const MatType& input,
+      const MatType& error,
+      MatType& gradient,
+      const std::enable_if_t<IsIm2ColConvolution<RuleType>::value>* = 0);
+
+  /**
+   * Rearrange the given output (or error) of the layer so that each output map
+   * is one column, with the points stacked in the same order as the rows of
+   * the lowered input.
+   *
+   * @param output Output of the layer.
+   * @param stacked Matrix with one column per output map.
+   */
+  void StackMaps(const MatType& output, MatType& stacked);
+
   /**
    * Rotates a 3rd-order tensor counterclockwise by 180 degrees.
    *
@@ -367,8 +448,14 @@ class ConvolutionType : public Layer<MatType>
   //! Locally-stored transformed gradient parameter.
   arma::Cube<typename MatType::elem_type> gradientTemp;
 
+  //! Locally-stored lowered input (workspace of Im2ColConvolution).
+  MatType loweredInput;
+
+  //! Locally-stored lowered error (workspace of Im2ColConvolution).
+  MatType loweredError;
+
   //! Locally-stored padding layer.
-  ann::Padding padding;
+  PaddingType<MatType> padding;
 
   //! Type of padding.
   std::string paddingType;
@@ -381,9 +468,9 @@ class ConvolutionType : public Layer<MatType>
 
 // Standard Convolution layer.
 typedef ConvolutionType<
-    NaiveConvolution<ValidConvolution>,
-    NaiveConvolution<FullConvolution>,
-    NaiveConvolution<ValidConvolution>,
+    Im2ColConvolution<ValidConvolution>,
+    Im2ColConvolution<FullConvolution>,
+    Im2ColConvolution<ValidConvolution>,
     arma::mat
 > Convolution;
 
@@ -291,15 +291,68 @@ void ConvolutionType<
       const_cast<MatType&>(usingPadding ? inputPadded : input).memptr(),
       paddedRows, paddedCols, inMaps * higherInDimensions * batchSize);
 
+  ForwardConvolution(inputTemp, output);
+}
+
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename MatType
+>
+void ConvolutionType<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    MatType
+>::Backward(
+    const MatType& /* input */, const MatType& gy, MatType& g)
+{
+  BackwardConvolution(gy, g);
+}
+
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename MatType
+>
+void ConvolutionType<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    MatType
+>::Gradient(
+    const MatType& input,
+    const MatType& error,
+    MatType& gradient)
+{
+  GradientConvolution(input, error, gradient);
+}
+
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename MatType
+>
+template<typename RuleType>
+void ConvolutionType<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    MatType
+>::ForwardConvolution(
+    const arma::Cube<typename MatType::elem_type>& inputTemp,
+    MatType& output,
+    const std::enable_if_t<!IsIm2ColConvolution<RuleType>::value>*)
+{
   MakeAlias(outputTemp, output.memptr(), this->outputDimensions[0],
       this->outputDimensions[1], maps * higherInDimensions * batchSize);
   outputTemp.zeros();
 
   // We "ignore" dimensions higher than the third---that means that we just pass
   // them through and treat them like different input points.
-  //
-  // If we eventually have a way to do convolutions for a single kernel
-  // in-batch, then this strategy may not be the most efficient solution.
   for (size_t offset = 0; offset < (higherInDimensions * batchSize); ++offset)
   {
     const size_t fullInputOffset = offset * inMaps;
@@ -315,7 +368,7 @@ void ConvolutionType<
 
         ForwardConvolutionRule::Convolution(
             inputTemp.slice(inMap + fullInputOffset),
-            weight.slice(outMap),
+            weight.slice(outMap * inMaps + inMap),
             convOutput,
             strideWidth,
             strideHeight);
@@ -335,13 +388,56 @@ template<
     typename GradientConvolutionRule,
     typename MatType
 >
+template<typename RuleType>
 void ConvolutionType<
     ForwardConvolutionRule,
     BackwardConvolutionRule,
     GradientConvolutionRule,
     MatType
->::Backward(
-    const MatType& /* input */, const MatType& gy, MatType& g)
+>::ForwardConvolution(
+    const arma::Cube<typename MatType::elem_type>& inputTemp,
+    MatType& output,
+    const std::enable_if_t<IsIm2ColConvolution<RuleType>::value>*)
+{
+  // Lower all input maps of all points at once; the lowered input is kept, so
+  // that Gradient() can reuse it.
+  ForwardConvolutionRule::Im2Col(inputTemp, inMaps, kernelWidth, kernelHeight,
+      strideWidth, strideHeight, 1, 1, loweredInput);
+
+  // The filters of each output map form one column.
+  MatType filters;
+  MakeAlias(filters, weight.memptr(), weight.n_elem / maps, maps);
+  const MatType convolved = loweredInput * filters;
+
+  // The rows of the result are ordered by point, so each point's output maps
+  // are a block of rows of the result.
+  const size_t outSize = this->outputDimensions[0] * this->outputDimensions[1];
+  for (size_t offset = 0; offset < (higherInDimensions * batchSize); ++offset)
+  {
+    MatType outputMaps;
+    MakeAlias(outputMaps, output.memptr() + offset * outSize * maps, outSize,
+        maps);
+    outputMaps = convolved.rows(offset * outSize, (offset + 1) * outSize - 1);
+    outputMaps.each_row() += bias.t();
+  }
+}
+
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename MatType
+>
+template<typename RuleType>
+void ConvolutionType<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    MatType
+>::BackwardConvolution(
+    const MatType& gy,
+    MatType& g,
+    const std::enable_if_t<!IsIm2ColConvolution<RuleType>::value>*)
 {
   arma::Cube<typename MatType::elem_type> mappedError;
   MakeAlias(mappedError, ((MatType&) gy).memptr(), this->outputDimensions[0],
@@ -357,7 +453,7 @@ void ConvolutionType<
   // To perform the backward pass, we need to rotate all the filters.
   arma::Cube<typename MatType::elem_type> rotatedFilters(weight.n_cols,
       weight.n_rows, weight.n_slices);
-  for (size_t map = 0; map < maps; ++map)
+  for (size_t map = 0; map < weight.n_slices; ++map)
   {
     Rotate180(weight.slice(map), rotatedFilters.slice(map));
   }
@@ -378,7 +474,7 @@ void ConvolutionType<
 
         BackwardConvolutionRule::Convolution(
             mappedError.slice(outMap + fullOutputOffset),
-            rotatedFilters.slice(outMap),
+            rotatedFilters.slice(outMap * inMaps + inMap),
             output,
             strideHeight,
             strideWidth);
@@ -427,15 +523,69 @@ template<
     typename GradientConvolutionRule,
     typename MatType
 >
+template<typename RuleType>
 void ConvolutionType<
     ForwardConvolutionRule,
     BackwardConvolutionRule,
     GradientConvolutionRule,
     MatType
->::Gradient(
+>::BackwardConvolution(
+    const MatType& gy,
+    MatType& g,
+    const std::enable_if_t<IsIm2ColConvolution<RuleType>::value>*)
+{
+  MatType stackedError;
+  StackMaps(gy, stackedError);
+
+  // The error with respect to each lowered patch of the input.
+  MatType filters;
+  MakeAlias(filters, weight.memptr(), weight.n_elem / maps, maps);
+  loweredError = stackedError * filters.t();
+
+  // Add every patch back to where it came from in the (padded) input.
+  const bool usingPadding =
+      (padWLeft != 0 || padWRight != 0 || padHTop != 0 || padHBottom != 0);
+  const size_t paddedRows = this->inputDimensions[0] + padWLeft + padWRight;
+  const size_t paddedCols = this->inputDimensions[1] + padHTop + padHBottom;
+
+  MatType gPadded;
+  if (usingPadding)
+  {
+    gPadded.zeros(paddedRows * paddedCols * inMaps * higherInDimensions,
+        batchSize);
+  }
+  else
+  {
+    g.zeros();
+  }
+
+  MakeAlias(gTemp, (usingPadding ? gPadded : g).memptr(), paddedRows,
+      paddedCols, inMaps * higherInDimensions * batchSize);
+  BackwardConvolutionRule::Col2Im(loweredError, inMaps, kernelWidth,
+      kernelHeight, strideWidth, strideHeight, 1, 1, gTemp);
+
+  // Remove the padding.
+  if (usingPadding)
+    padding.Backward(gPadded, gPadded, g);
+}
+
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename MatType
+>
+template<typename RuleType>
+void ConvolutionType<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    MatType
+>::GradientConvolution(
     const MatType& input,
     const MatType& error,
-    MatType& gradient)
+    MatType& gradient,
+    const std::enable_if_t<!IsIm2ColConvolution<RuleType>::value>*)
 {
   arma::Cube<typename MatType::elem_type> mappedError;
   MakeAlias(mappedError, ((MatType&) error).memptr(),
@@ -451,7 +601,8 @@ void ConvolutionType<
 
   arma::Cube<typename MatType::elem_type> inputTemp(
       const_cast<MatType&>(usingPadding ? inputPadded : input).memptr(),
-      paddedRows, paddedCols, inMaps * batchSize, false, false);
+      paddedRows, paddedCols, inMaps * higherInDimensions * batchSize, false,
+      false);
 
   // We will make an alias for the gradient, but note that this is only for the
   // convolution map weights!  The bias will be handled by direct accesses into
@@ -479,21 +630,22 @@ void ConvolutionType<
             strideHeight);
 
         // TODO: understand this conditional.  Is it needed?
+        const size_t filter = outMap * inMaps + inMap;
         if (gradientTemp.n_rows < output.n_rows ||
             gradientTemp.n_cols < output.n_cols)
         {
-          gradientTemp.slice(outMap) += output.submat(0, 0,
+          gradientTemp.slice(filter) += output.submat(0, 0,
               gradientTemp.n_rows - 1, gradientTemp.n_cols - 1);
         }
         else if (gradientTemp.n_rows > output.n_rows ||
                  gradientTemp.n_cols > output.n_cols)
         {
-          gradientTemp.slice(outMap).submat(0, 0, output.n_rows - 1,
+          gradientTemp.slice(filter).submat(0, 0, output.n_rows - 1,
               output.n_cols - 1) += output;
         }
         else
         {
-          gradientTemp.slice(outMap) += output;
+          gradientTemp.slice(filter) += output;
         }
       }
 
@@ -503,6 +655,81 @@ void ConvolutionType<
   }
 }
 
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename MatType
+>
+template<typename RuleType>
+void ConvolutionType<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    MatType
+>::GradientConvolution(
+    const MatType& input,
+    const MatType& error,
+    MatType& gradient,
+    const std::enable_if_t<IsIm2ColConvolution<RuleType>::value>*)
+{
+  MatType stackedError;
+  StackMaps(error, stackedError);
+
+  // The lowered input is left over from Forward(), unless the forward pass
+  // used a different rule.
+  const size_t outSize = this->outputDimensions[0] * this->outputDimensions[1];
+  if (!IsIm2ColConvolution<ForwardConvolutionRule>::value ||
+      loweredInput.n_rows != outSize * higherInDimensions * batchSize)
+  {
+    const bool usingPadding =
+        (padWLeft != 0 || padWRight != 0 || padHTop != 0 || padHBottom != 0);
+    const size_t paddedRows = this->inputDimensions[0] + padWLeft + padWRight;
+    const size_t paddedCols = this->inputDimensions[1] + padHTop + padHBottom;
+
+    arma::Cube<typename MatType::elem_type> inputTemp;
+    MakeAlias(inputTemp,
+        const_cast<MatType&>(usingPadding ? inputPadded : input).memptr(),
+        paddedRows, paddedCols, inMaps * higherInDimensions * batchSize);
+    GradientConvolutionRule::Im2Col(inputTemp, inMaps, kernelWidth,
+        kernelHeight, strideWidth, strideHeight, 1, 1, loweredInput);
+  }
+
+  // The gradient of the filters of each output map forms one column, laid
+  // out like the filters themselves.
+  MatType filterGradient, biasGradient;
+  MakeAlias(filterGradient, gradient.memptr(), weight.n_elem / maps, maps);
+  MakeAlias(biasGradient, gradient.memptr() + weight.n_elem, maps, 1);
+  filterGradient = loweredInput.t() * stackedError;
+  biasGradient = arma::sum(stackedError, 0).t();
+}
+
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename MatType
+>
+void ConvolutionType<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    MatType
+>::StackMaps(const MatType& output, MatType& stacked)
+{
+  const size_t outSize = this->outputDimensions[0] * this->outputDimensions[1];
+  const size_t points = higherInDimensions * batchSize;
+
+  stacked.set_size(outSize * points, maps);
+  for (size_t offset = 0; offset < points; ++offset)
+  {
+    MatType outputMaps;
+    MakeAlias(outputMaps, const_cast<MatType&>(output).memptr() + offset *
+        outSize * maps, outSize, maps);
+    stacked.rows(offset * outSize, (offset + 1) * outSize - 1) = outputMaps;
+  }
+}
+
 template<
     typename ForwardConvolutionRule,
     typename BackwardConvolutionRule,
@@ -530,7 +757,7 @@ void ConvolutionType<
     InitializeSamePadding();
   }
 
-  padding = ann::Padding(padWLeft, padWRight, padHTop, padHBottom);
+  padding = PaddingType<MatType>(padWLeft, padWRight, padHTop, padHBottom);
   padding.InputDimensions() = this->inputDimensions;
   padding.ComputeOutputDimensions();
 
@@ -123,6 +123,11 @@ class DropConnectType : public Layer<MatType>
   // Set the weights to use the given memory `weightsPtr`.
   void SetWeights(typename MatType::elem_type* weightsPtr);
 
+  //! Get the parameters (the weights of the wrapped layer).
+  const MatType& Parameters() const { return baseLayer->Parameters(); }
+  //! Modify the parameters (the weights of the wrapped layer).
+  MatType& Parameters() { return baseLayer->Parameters(); }
+
   /**
    * Serialize the layer.
    */
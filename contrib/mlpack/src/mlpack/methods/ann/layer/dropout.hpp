@@ -15,6 +15,7 @@
 
 #include <mlpack/prereqs.hpp>
 
+#include <mlpack/methods/ann/parallel_columns.hpp>
 #include "layer.hpp"
 
 namespace mlpack {
@@ -86,9 +86,18 @@ void DropoutType<MatType>::Forward(const MatType& input, MatType& output)
   {
     // Scale with input / (1 - ratio) and set values to zero with probability
     // 'ratio'.
+    // The random numbers are drawn on the calling thread, so that the mask
+    // only depends on the random seed and not on the number of threads.
     mask = arma::randu<MatType>(input.n_rows, input.n_cols);
-    mask.transform([&](double val) { return (val > ratio); });
-    output = input % mask * scale;
+    output.set_size(arma::size(input));
+    ParallelColumns(input.n_cols, input.n_rows,
+        [&](const size_t begin, const size_t end)
+    {
+      mask.cols(begin, end - 1).transform(
+          [&](double val) { return (val > ratio); });
+      output.cols(begin, end - 1) = input.cols(begin, end - 1) %
+          mask.cols(begin, end - 1) * scale;
+    });
   }
 }
 
@@ -98,7 +107,13 @@ void DropoutType<MatType>::Backward(
     const MatType& gy,
     MatType& g)
 {
-  g = gy % mask * scale;
+  g.set_size(arma::size(gy));
+  ParallelColumns(gy.n_cols, gy.n_rows,
+      [&](const size_t begin, const size_t end)
+  {
+    g.cols(begin, end - 1) = gy.cols(begin, end - 1) %
+        mask.cols(begin, end - 1) * scale;
+  });
 }
 
 template<typename MatType>
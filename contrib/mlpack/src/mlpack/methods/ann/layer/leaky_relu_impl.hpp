@@ -74,19 +74,26 @@ LeakyReLUType<MatType>::operator=(LeakyReLUType&& other)
 template<typename MatType>
 void LeakyReLUType<MatType>::Forward(const MatType& input, MatType& output)
 {
-  output = arma::max(input, alpha * input);
+  output.set_size(arma::size(input));
+  ParallelColumns(input.n_cols, input.n_rows,
+      [&](const size_t begin, const size_t end)
+  {
+    output.cols(begin, end - 1) = arma::max(input.cols(begin, end - 1),
+        alpha * input.cols(begin, end - 1));
+  });
 }
 
 template<typename MatType>
 void LeakyReLUType<MatType>::Backward(
     const MatType& input, const MatType& gy, MatType& g)
 {
-  MatType derivative;
-  derivative.set_size(arma::size(input));
-  for (size_t i = 0; i < input.n_elem; ++i)
-    derivative(i) = (input(i) >= 0) ? 1 : alpha;
-
-  g = gy % derivative;
+  g.set_size(arma::size(gy));
+  ParallelColumns(input.n_cols, input.n_rows,
+      [&](const size_t begin, const size_t end)
+  {
+    for (size_t i = begin * input.n_rows; i < end * input.n_rows; ++i)
+      g(i) = (input(i) >= 0) ? gy(i) : alpha * gy(i);
+  });
 }
 
 template<typename MatType>
@@ -14,6 +14,7 @@
 
 #include <mlpack/prereqs.hpp>
 
+#include <mlpack/methods/ann/parallel_columns.hpp>
 #include "layer.hpp"
 
 namespace mlpack {
@@ -65,36 +65,50 @@ LogSoftMaxType<MatType>::operator=(LogSoftMaxType&& other)
 template<typename MatType>
 void LogSoftMaxType<MatType>::Forward(const MatType& input, MatType& output)
 {
-  MatType maxInput = arma::repmat(arma::max(input), input.n_rows, 1);
-  output = (maxInput - input);
-
-  // Approximation of the base-e exponential function. The acuracy however is
-  // about 0.00001 lower as using exp. Credits go to Leon Bottou.
-  output.transform([](double x)
+  // Each point is normalized independently, so blocks of points are handled in
+  // parallel, each written through an alias of the output.
+  output.set_size(arma::size(input));
+  ParallelColumns(input.n_cols, input.n_rows,
+      [&](const size_t begin, const size_t end)
   {
-    //! Fast approximation of exp(-x) for x positive.
-    static constexpr double A0 = 1.0;
-    static constexpr double A1 = 0.125;
-    static constexpr double A2 = 0.0078125;
-    static constexpr double A3 = 0.00032552083;
-    static constexpr double A4 = 1.0172526e-5;
-
-    if (x < 13.0)
+    const MatType inputBlock(
+        const_cast<typename MatType::elem_type*>(input.colptr(begin)),
+        input.n_rows, end - begin, false, true);
+    MatType outputBlock(output.colptr(begin), output.n_rows, end - begin,
+        false, true);
+
+    MatType maxInput = arma::repmat(arma::max(inputBlock), inputBlock.n_rows,
+        1);
+    outputBlock = (maxInput - inputBlock);
+
+    // Approximation of the base-e exponential function. The acuracy however is
+    // about 0.00001 lower as using exp. Credits go to Leon Bottou.
+    outputBlock.transform([](double x)
     {
-      double y = A0 + x * (A1 + x * (A2 + x * (A3 + x * A4)));
-      y *= y;
-      y *= y;
-      y *= y;
-      y = 1 / y;
-
-      return y;
-    }
-
-    return 0.0;
+      //! Fast approximation of exp(-x) for x positive.
+      static constexpr double A0 = 1.0;
+      static constexpr double A1 = 0.125;
+      static constexpr double A2 = 0.0078125;
+      static constexpr double A3 = 0.00032552083;
+      static constexpr double A4 = 1.0172526e-5;
+
+      if (x < 13.0)
+      {
+        double y = A0 + x * (A1 + x * (A2 + x * (A3 + x * A4)));
+        y *= y;
+        y *= y;
+        y *= y;
+        y = 1 / y;
+
+        return y;
+      }
+
+      return 0.0;
+    });
+
+    maxInput.each_row() += arma::log(arma::sum(outputBlock));
+    outputBlock = inputBlock - maxInput;
   });
-
-  maxInput.each_row() += arma::log(arma::sum(output));
-  output = input - maxInput;
 }
 
 template<typename MatType>
@@ -103,7 +117,13 @@ void LogSoftMaxType<MatType>::Backward(
     const MatType& gy,
     MatType& g)
 {
-  g = arma::exp(input) + gy;
+  g.set_size(arma::size(gy));
+  ParallelColumns(input.n_cols, input.n_rows,
+      [&](const size_t begin, const size_t end)
+  {
+    g.cols(begin, end - 1) = arma::exp(input.cols(begin, end - 1)) +
+        gy.cols(begin, end - 1);
+  });
 }
 
 } // namespace ann
@@ -16,6 +16,7 @@
 #include <limits>
 
 #include "layer.hpp"
+#include "recurrent_layer.hpp"
 
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
@@ -33,6 +34,15 @@ namespace ann /** Artificial Neural Network. */ {
  * h &=& o \odot tanh(c)
  * @f}
  *
+ * The four gates are computed together: the input weights, recurrent weights
+ * and biases of all gates are stacked into one matrix each, so that each time
+ * step needs a single matrix product with the previous output, and the
+ * activations are applied in place in a single pass.  When a whole sequence is
+ * given to `ForwardSequence()` (as `RNN` does), the time steps are processed in
+ * blocks whose gates fit in the cache: the products with the input are
+ * computed for a whole block at once, and `BackwardSequence()` computes the
+ * gradients of a block with one matrix product per weight matrix.
+ *
  * Note that if an LSTM layer is desired as the first layer of a neural network,
  * an IdentityLayer should be added to the network as the first layer, and then
  * the LSTM layer should be added.
@@ -49,9 +59,6 @@ namespace ann /** Artificial Neural Network. */ {
  * }
  * @endcode
  *
- * \see FastLSTM for a faster LSTM version which combines the calculation of the
- * input, forget, output gates and hidden state in a single step.
- *
  * @tparam MatType Matrix representation to accept as input and use for
  *    computation.
  */
@@ -66,7 +73,6 @@ class LSTMType : public RecurrentLayer<MatType>
    * Create the LSTM layer object using the specified parameters.
    *
    * @param outSize The number of output units.
-   * @param rho Maximum number of steps to backpropagate through time (BPTT).
    */
   LSTMType(const size_t outSize);
 
@@ -121,6 +127,28 @@ class LSTMType : public RecurrentLayer<MatType>
                 const MatType& error,
                 MatType& gradient);
 
+  /**
+   * Pass `steps` consecutive time steps forward through the layer; see
+   * `RecurrentLayer::ForwardSequence()`.  The input projections are computed
+   * with one matrix product per block of steps.
+   */
+  void ForwardSequence(const MatType& input,
+                       MatType& output,
+                       const size_t steps,
+                       const bool storeSteps);
+
+  /**
+   * Backpropagate through the last `steps` stored time steps; see
+   * `RecurrentLayer::BackwardSequence()`.  The error of the input and the
+   * gradients of the weights are computed once per block of steps.
+   */
+  void BackwardSequence(const MatType& input,
+                        const MatType& output,
+                        const MatType& gy,
+                        MatType& g,
+                        MatType& gradient,
+                        const size_t steps);
+
   /**
    * Reset the recurrent state of the LSTM layer, and allocate enough space to
    * hold `bpttSteps` of previous passes with a batch size of `batchSize`.
@@ -135,6 +163,9 @@ class LSTMType : public RecurrentLayer<MatType>
   //! Modify the parameters.
   MatType& Parameters() { return weights; }
 
+  //! Get the number of output units.
+  size_t OutSize() const { return outSize; }
+
   //! Get the total number of trainable parameters.
   size_t WeightSize() const
   {
@@ -145,7 +176,7 @@ class LSTMType : public RecurrentLayer<MatType>
   void ComputeOutputDimensions()
   {
     inSize = std::accumulate(this->inputDimensions.begin(),
-        this->inputDimensions.end(), 0);
+        this->inputDimensions.end(), size_t(1), std::multiplies<size_t>());
     this->outputDimensions = std::vector<size_t>(this->inputDimensions.size(),
         1);
 
@@ -160,6 +191,45 @@ class LSTMType : public RecurrentLayer<MatType>
   void serialize(Archive& ar, const uint32_t /* version */);
 
  private:
+  /**
+   * Compute one time step from its input projection (the product of the input
+   * weights with the input, plus the biases), storing the step in `step` and
+   * using the state in `previousStep` (if it is not `size_t(-1)`).
+   */
+  void ForwardStep(const MatType& projection,
+                   const size_t step,
+                   const size_t previousStep,
+                   MatType& output);
+
+  /**
+   * Compute the error of the gates of the time step stored in `step`, given the
+   * error `outputError` of its output.  `cellError` holds the error of the cell
+   * that comes from the next time step (or zeros), and is replaced by the error
+   * to pass to the previous time step.
+   */
+  void BackwardStep(const size_t step,
+                    const MatType& outputError,
+                    MatType& cellError,
+                    MatType& stepGateError);
+
+  /**
+   * Add the gradient of the weights for `steps` consecutive stored time steps
+   * starting at `firstStep`, given their input and the error of their gates, to
+   * `gradient`.
+   */
+  void ComputeGradient(const MatType& input,
+                       const MatType& error,
+                       const size_t firstStep,
+                       const size_t steps,
+                       MatType& gradient);
+
+  /**
+   * Return the number of time steps to process together in `ForwardSequence()`
+   * and `BackwardSequence()`, so that the gates of a block of steps stay in the
+   * cache.
+   */
+  size_t BlockSteps(const size_t batchSize, const size_t steps) const;
+
   //! Locally-stored number of input units.
   size_t inSize;
 
@@ -169,102 +239,48 @@ class LSTMType : public RecurrentLayer<MatType>
   //! Locally-stored weight object.
   MatType weights;
 
-  //! Weights between the output and input gate.
-  MatType output2GateInputWeight;
-
-  //! Weights between the input and gate.
-  MatType input2GateInputWeight;
-
-  //! Bias between the input and input gate.
-  MatType input2GateInputBias;
-
-  //! Weights between the cell and input gate.
-  MatType cell2GateInputWeight;
-
-  //! Weights between the output and forget gate.
-  MatType output2GateForgetWeight;
+  //! Weights between the input and the gates, stacked in the order input gate,
+  //! forget gate, cell input and output gate.
+  MatType inputWeight;
 
-  //! Weights between the input and gate.
-  MatType input2GateForgetWeight;
+  //! Weights between the previous output and the gates, in the same order.
+  MatType recurrentWeight;
 
-  //! Bias between the input and gate.
-  MatType input2GateForgetBias;
+  //! Bias of the gates, in the same order.
+  MatType bias;
 
-  //! Bias between the input and gate.
-  MatType cell2GateForgetWeight;
-
-  //! Weights between the output and gate.
-  MatType output2GateOutputWeight;
-
-  //! Weights between the input and gate.
-  MatType input2GateOutputWeight;
-
-  //! Bias between the input and gate.
-  MatType input2GateOutputBias;
-
-  //! Weights between cell and output gate.
-  MatType cell2GateOutputWeight;
+  //! Weights between the cell and the input, forget and output gates (one
+  //! column each).
+  MatType peepholeWeight;
 
   // Below here are recurrent state matrices.
 
-  //! Locally-stored input gate parameter.
-  MatType inputGate;
-
-  //! Locally-stored forget gate parameter.
-  MatType forgetGate;
+  //! Activations of the gates of each stored step.
+  arma::Cube<typename MatType::elem_type> gates;
 
-  //! Locally-stored hidden layer parameter.
-  MatType hiddenLayer;
-
-  //! Locally-stored output gate parameter.
-  MatType outputGate;
-
-  //! Locally-stored input to hidden weight.
-  MatType input2HiddenWeight;
-
-  //! Locally-stored input to hidden bias.
-  MatType input2HiddenBias;
-
-  //! Locally-stored output to hidden weight.
-  MatType output2HiddenWeight;
-
-  //! Locally-stored cell parameter.
+  //! Cell of each stored step.
   arma::Cube<typename MatType::elem_type> cell;
 
-  // These members store recurrent state.
-
-  //! Locally-stored input gate activation.
-  arma::Cube<typename MatType::elem_type> inputGateActivation;
-
-  //! Locally-stored forget gate activation.
-  arma::Cube<typename MatType::elem_type> forgetGateActivation;
-
-  //! Locally-stored output gate activation.
-  arma::Cube<typename MatType::elem_type> outputGateActivation;
-
-  //! Locally-stored hidden layer activation.
-  arma::Cube<typename MatType::elem_type> hiddenLayerActivation;
-
-  //! Locally-stored cell activation error.
+  //! Activation of the cell of each stored step.
   arma::Cube<typename MatType::elem_type> cellActivation;
 
-  //! Locally-stored forget gate error.
-  MatType forgetGateError;
+  //! Output of each stored step.
+  arma::Cube<typename MatType::elem_type> outputs;
 
-  //! Locally-stored output gate error.
-  MatType outputGateError;
+  //! The step before each stored step (or size_t(-1)).
+  std::vector<size_t> previousSteps;
 
-  //! Locally-stored output parameters.
-  arma::Cube<typename MatType::elem_type> outParameter;
+  //! Locally-stored input projections of the current block of steps.
+  MatType projection;
 
-  //! Locally-stored input cell error parameter.
-  MatType inputCellError;
+  //! Locally-stored error of the gates.
+  MatType gateError;
 
-  //! Locally-stored input gate error.
-  MatType inputGateError;
+  //! Locally-stored error of the cell, passed to the previous time step.
+  MatType cellError;
 
-  //! Locally-stored hidden layer error.
-  MatType hiddenError;
+  //! Locally-stored error of the output of a time step.
+  MatType outputError;
 }; // class LSTMType
 
 // Convenience typedefs.
@@ -21,6 +21,7 @@ namespace ann /** Artificial Neural Network. */ {
 template<typename MatType>
 LSTMType<MatType>::LSTMType() :
     RecurrentLayer<MatType>(),
+    inSize(0),
     outSize(0)
 {
   // Nothing to do here.
@@ -29,6 +30,7 @@ LSTMType<MatType>::LSTMType() :
 template<typename MatType>
 LSTMType<MatType>::LSTMType(const size_t outSize) :
     RecurrentLayer<MatType>(),
+    inSize(0),
     outSize(outSize)
 {
   // Nothing to do here.
@@ -36,14 +38,18 @@ LSTMType<MatType>::LSTMType(const size_t outSize) :
 
 template<typename MatType>
 LSTMType<MatType>::LSTMType(const LSTMType& layer) :
-    RecurrentLayer<MatType>(layer)
+    RecurrentLayer<MatType>(layer),
+    inSize(layer.inSize),
+    outSize(layer.outSize)
 {
   // Nothing to do here.
 }
 
 template<typename MatType>
 LSTMType<MatType>::LSTMType(LSTMType&& layer) :
-    RecurrentLayer<MatType>(std::move(layer))
+    RecurrentLayer<MatType>(std::move(layer)),
+    inSize(std::move(layer.inSize)),
+    outSize(std::move(layer.outSize))
 {
   // Nothing to do here.
 }
@@ -54,6 +60,8 @@ LSTMType<MatType>& LSTMType<MatType>::operator=(const LSTMType& layer)
   if (this != &layer)
   {
     RecurrentLayer<MatType>::operator=(layer);
+    inSize = layer.inSize;
+    outSize = layer.outSize;
   }
 
   return *this;
@@ -65,6 +73,8 @@ LSTMType<MatType>& LSTMType<MatType>::operator=(LSTMType&& layer)
   if (this != &layer)
   {
     RecurrentLayer<MatType>::operator=(std::move(layer));
+    inSize = std::move(layer.inSize);
+    outSize = std::move(layer.outSize);
   }
 
   return *this;
@@ -74,320 +84,363 @@ template<typename MatType>
 void LSTMType<MatType>::ClearRecurrentState(
     const size_t bpttSteps, const size_t batchSize)
 {
-  // Make sure all of the different matrices we will use to hold parameters are
-  // at least as large as we need.
-  inputGate.set_size(outSize, batchSize);
-  forgetGate.set_size(outSize, batchSize);
-  hiddenLayer.set_size(outSize, batchSize);
-  outputGate.set_size(outSize, batchSize);
-
-  inputGateActivation.set_size(outSize, batchSize, bpttSteps);
-  forgetGateActivation.set_size(outSize, batchSize, bpttSteps);
-  outputGateActivation.set_size(outSize, batchSize, bpttSteps);
-  hiddenLayerActivation.set_size(outSize, batchSize, bpttSteps);
-
+  gates.set_size(4 * outSize, batchSize, bpttSteps);
   cellActivation.set_size(outSize, batchSize, bpttSteps);
-  outParameter.set_size(outSize, batchSize, bpttSteps);
 
   // Now reset recurrent values to 0.
   cell.zeros(outSize, batchSize, bpttSteps);
+  outputs.zeros(outSize, batchSize, bpttSteps);
+  previousSteps.assign(bpttSteps, size_t(-1));
 }
 
 template<typename MatType>
 void LSTMType<MatType>::SetWeights(
     typename MatType::elem_type* weightsPtr)
 {
-  // Set the weight parameter for the output gate.
-  MakeAlias(input2GateOutputWeight, weightsPtr, outSize, inSize);
-  size_t offset = input2GateOutputWeight.n_elem;
-  MakeAlias(input2GateOutputBias, weightsPtr + offset, outSize, 1);
-  offset += input2GateOutputBias.n_elem;
-
-  // Set the weight parameter for the forget gate.
-  MakeAlias(input2GateForgetWeight, weightsPtr + offset, outSize, inSize);
-  offset += input2GateForgetWeight.n_elem;
-  MakeAlias(input2GateForgetBias, weightsPtr + offset, outSize, 1);
-  offset += input2GateForgetBias.n_elem;
-
-  // Set the weight parameter for the input gate.
-  MakeAlias(input2GateInputWeight, weightsPtr + offset, outSize, inSize);
-  offset += input2GateInputWeight.n_elem;
-  MakeAlias(input2GateInputBias, weightsPtr + offset, outSize, 1);
-  offset += input2GateInputBias.n_elem;
-
-  // Set the weight parameter for the hidden gate.
-  MakeAlias(input2HiddenWeight, weightsPtr + offset, outSize, inSize);
-  offset += input2HiddenWeight.n_elem;
-  MakeAlias(input2HiddenBias, weightsPtr + offset, outSize, 1);
-  offset += input2HiddenBias.n_elem;
-
-  // Set the weight parameter for the output multiplication.
-  MakeAlias(output2GateOutputWeight, weightsPtr + offset, outSize, outSize);
-  offset += output2GateOutputWeight.n_elem;
-
-  // Set the weight parameter for the output multiplication.
-  MakeAlias(output2GateForgetWeight, weightsPtr + offset, outSize, outSize);
-  offset += output2GateForgetWeight.n_elem;
-
-  // Set the weight parameter for the input multiplication.
-  MakeAlias(output2GateInputWeight, weightsPtr + offset, outSize, outSize);
-  offset += output2GateInputWeight.n_elem;
-
-  // Set the weight parameter for the hidden multiplication.
-  MakeAlias(output2HiddenWeight, weightsPtr + offset, outSize, outSize);
-  offset += output2HiddenWeight.n_elem;
-
-  // Set the weight parameter for the cell multiplication.
-  MakeAlias(cell2GateOutputWeight, weightsPtr + offset, outSize, 1);
-  offset += cell2GateOutputWeight.n_elem;
-
-  // Set the weight parameter for the cell - forget gate multiplication.
-  MakeAlias(cell2GateForgetWeight, weightsPtr + offset, outSize, 1);
-  offset += cell2GateOutputWeight.n_elem;
-
-  // Set the weight parameter for the cell - input gate multiplication.
-  MakeAlias(cell2GateInputWeight, weightsPtr + offset, outSize, 1);
+  MakeAlias(weights, weightsPtr, WeightSize(), 1);
+
+  MakeAlias(inputWeight, weightsPtr, 4 * outSize, inSize);
+  size_t offset = inputWeight.n_elem;
+  MakeAlias(recurrentWeight, weightsPtr + offset, 4 * outSize, outSize);
+  offset += recurrentWeight.n_elem;
+  MakeAlias(bias, weightsPtr + offset, 4 * outSize, 1);
+  offset += bias.n_elem;
+  MakeAlias(peepholeWeight, weightsPtr + offset, outSize, 3);
 }
 
-// Forward when cellState is not needed.
 template<typename MatType>
 void LSTMType<MatType>::Forward(const MatType& input, MatType& output)
 {
-  // Convenience alias.
-  const size_t batchSize = input.n_cols;
+  projection = inputWeight * input;
+  projection.each_col() += bias;
 
-  inputGate = input2GateInputWeight * input;
-  if (this->HasPreviousStep())
-  {
-    inputGate +=
-        output2GateInputWeight * outParameter.slice(this->PreviousStep());
-  }
-  inputGate.each_col() += input2GateInputBias;
+  ForwardStep(projection, this->CurrentStep(), this->HasPreviousStep() ?
+      this->PreviousStep() : size_t(-1), output);
+}
 
-  forgetGate = input2GateForgetWeight * input;
-  if (this->HasPreviousStep())
-  {
-    forgetGate += output2GateForgetWeight * outParameter.slice(
-        this->PreviousStep());
-  }
-  forgetGate.each_col() += input2GateForgetBias;
+template<typename MatType>
+void LSTMType<MatType>::ForwardSequence(const MatType& input,
+                                        MatType& output,
+                                        const size_t steps,
+                                        const bool storeSteps)
+{
+  const size_t batchSize = input.n_cols / steps;
+  const size_t blockSteps = BlockSteps(batchSize, steps);
 
-  if (this->HasPreviousStep())
+  size_t previousStep = this->HasPreviousStep() ? this->PreviousStep() :
+      size_t(-1);
+  MatType blockInput, stepProjection, stepOutput;
+  for (size_t s0 = 0; s0 < steps; s0 += blockSteps)
   {
-    inputGate += arma::repmat(cell2GateInputWeight, 1, batchSize) %
-        cell.slice(this->PreviousStep());
-
-    forgetGate += arma::repmat(cell2GateForgetWeight, 1, batchSize) %
-        cell.slice(this->PreviousStep());
+    const size_t s1 = std::min(s0 + blockSteps, steps);
+
+    // The input projections don't depend on the recurrent state, so they are
+    // computed for a whole block of steps with one matrix product, just before
+    // the steps are computed.
+    MakeAlias(blockInput, (typename MatType::elem_type*)
+        input.colptr(s0 * batchSize), input.n_rows, (s1 - s0) * batchSize);
+    projection = inputWeight * blockInput;
+    projection.each_col() += bias;
+
+    for (size_t s = s0; s < s1; ++s)
+    {
+      const size_t step = storeSteps ? this->CurrentStep() + s :
+          this->CurrentStep();
+
+      MakeAlias(stepProjection, projection.colptr((s - s0) * batchSize),
+          projection.n_rows, batchSize);
+      MakeAlias(stepOutput, output.colptr(s * batchSize), outSize, batchSize);
+      ForwardStep(stepProjection, step, previousStep, stepOutput);
+
+      previousStep = step;
+    }
   }
 
-  inputGateActivation.slice(this->CurrentStep()) =
-      1.0 / (1.0 + arma::exp(-inputGate));
-  forgetGateActivation.slice(this->CurrentStep()) =
-      1.0 / (1.0 + arma::exp(-forgetGate));
+  this->PreviousStep() = previousStep;
+}
 
-  hiddenLayer = input2HiddenWeight * input;
-  if (this->HasPreviousStep())
-  {
-    hiddenLayer += output2HiddenWeight *
-        outParameter.slice(this->PreviousStep());
-  }
-  hiddenLayer.each_col() += input2HiddenBias;
+template<typename MatType>
+void LSTMType<MatType>::ForwardStep(const MatType& stepProjection,
+                                    const size_t step,
+                                    const size_t previousStep,
+                                    MatType& output)
+{
+  typedef typename MatType::elem_type ElemType;
 
-  hiddenLayerActivation.slice(this->CurrentStep()) = arma::tanh(hiddenLayer);
+  const size_t batchSize = stepProjection.n_cols;
+  const bool hasPrevious = (previousStep != size_t(-1));
+  previousSteps[step] = previousStep;
 
-  if (!this->HasPreviousStep())
-  {
-    cell.slice(this->CurrentStep()) =
-        inputGateActivation.slice(this->CurrentStep()) %
-        hiddenLayerActivation.slice(this->CurrentStep());
-  }
+  // Compute the inputs of all four gates with one matrix product.
+  MatType stepGates;
+  MakeAlias(stepGates, gates.slice_memptr(step), 4 * outSize, batchSize);
+  if (hasPrevious)
+    stepGates = stepProjection + recurrentWeight * outputs.slice(previousStep);
   else
+    stepGates = stepProjection;
+
+  // Now apply the activations in place, and update the cell and the output.
+  // When the step is computed in place (`step == previousStep`), each element
+  // of the previous cell is read before it is overwritten.
+  const ElemType* inputPeephole = peepholeWeight.colptr(0);
+  const ElemType* forgetPeephole = peepholeWeight.colptr(1);
+  const ElemType* outputPeephole = peepholeWeight.colptr(2);
+  for (size_t j = 0; j < batchSize; ++j)
   {
-    cell.slice(this->CurrentStep()) =
-        forgetGateActivation.slice(this->CurrentStep()) %
-        cell.slice(this->PreviousStep()) +
-        inputGateActivation.slice(this->CurrentStep()) %
-        hiddenLayerActivation.slice(this->CurrentStep());
+    ElemType* g = stepGates.colptr(j);
+    const ElemType* previousCell = hasPrevious ?
+        cell.slice_colptr(previousStep, j) : nullptr;
+    ElemType* c = cell.slice_colptr(step, j);
+    ElemType* cActivation = cellActivation.slice_colptr(step, j);
+    ElemType* h = outputs.slice_colptr(step, j);
+    ElemType* out = output.colptr(j);
+
+    for (size_t r = 0; r < outSize; ++r)
+    {
+      const ElemType cPrevious = hasPrevious ? previousCell[r] : ElemType(0);
+      const ElemType i = 1 / (1 + std::exp(-(g[r] +
+          inputPeephole[r] * cPrevious)));
+      const ElemType f = 1 / (1 + std::exp(-(g[outSize + r] +
+          forgetPeephole[r] * cPrevious)));
+      const ElemType z = std::tanh(g[2 * outSize + r]);
+      const ElemType cNew = f * cPrevious + i * z;
+      const ElemType o = 1 / (1 + std::exp(-(g[3 * outSize + r] +
+          outputPeephole[r] * cNew)));
+      const ElemType cNewActivation = std::tanh(cNew);
+
+      g[r] = i;
+      g[outSize + r] = f;
+      g[2 * outSize + r] = z;
+      g[3 * outSize + r] = o;
+      c[r] = cNew;
+      cActivation[r] = cNewActivation;
+      h[r] = o * cNewActivation;
+      out[r] = h[r];
+    }
   }
-
-  outputGate = input2GateOutputWeight * input +
-      cell.slice(this->CurrentStep()).each_col() % cell2GateOutputWeight;
-  if (this->HasPreviousStep())
-  {
-    outputGate +=
-        output2GateOutputWeight * outParameter.slice(this->PreviousStep());
-  }
-  outputGate.each_col() += input2GateOutputBias;
-
-  outputGateActivation.slice(this->CurrentStep()) =
-      1.0 / (1.0 + arma::exp(-outputGate));
-
-  cellActivation.slice(this->CurrentStep()) =
-      arma::tanh(cell.slice(this->CurrentStep()));
-
-  // There's a bit of an issue here: we need to preserve the output for the next
-  // time step, but we also need to set `output` to that.  Unfortunately for now
-  // we make a copy, but it's possible that we could instead use an alias here,
-  // or have `outParameter` hold a collection of aliases.
-  outParameter.slice(this->CurrentStep()) =
-      cellActivation.slice(this->CurrentStep()) %
-      outputGateActivation.slice(this->CurrentStep());
-
-  output = outParameter.slice(this->CurrentStep());
 }
 
 template<typename MatType>
 void LSTMType<MatType>::Backward(
     const MatType& /* input */, const MatType& gy, MatType& g)
 {
-  MatType gyLocal;
+  // During the backward pass, the previous step is the one after the current
+  // step in time, whose gate error is still in `gateError`.
   if (this->HasPreviousStep())
   {
-    gyLocal = gy + output2GateOutputWeight.t() * outputGateError +
-      output2GateForgetWeight.t() * forgetGateError +
-      output2GateInputWeight.t() * inputGateError +
-      output2HiddenWeight.t() * hiddenError;
+    outputError = gy + recurrentWeight.t() * gateError;
   }
   else
   {
-    // Make an alias.
-    gyLocal = MatType(((MatType&) gy).memptr(), gy.n_rows, gy.n_cols,
-        false, false);
+    outputError = gy;
+    cellError.zeros(outSize, gy.n_cols);
   }
 
-  outputGateError = gyLocal % cellActivation.slice(this->CurrentStep()) %
-      (outputGateActivation.slice(this->CurrentStep()) %
-      (1.0 - outputGateActivation.slice(this->CurrentStep())));
+  gateError.set_size(4 * outSize, gy.n_cols);
+  BackwardStep(this->CurrentStep(), outputError, cellError, gateError);
 
-  MatType cellError = gyLocal %
-      outputGateActivation.slice(this->CurrentStep()) %
-      (1 - arma::pow(cellActivation.slice(this->CurrentStep()), 2)) +
-      outputGateError.each_col() % cell2GateOutputWeight;
+  g = inputWeight.t() * gateError;
+}
 
-  if (this->HasPreviousStep())
-  {
-    cellError += inputCellError;
-  }
+template<typename MatType>
+void LSTMType<MatType>::Gradient(
+    const MatType& input,
+    const MatType& /* error */,
+    MatType& gradient)
+{
+  // This implementation depends on Gradient() being called just after
+  // Backward(), which is something we can safely assume.
+  gradient.zeros();
+  ComputeGradient(input, gateError, this->CurrentStep(), 1, gradient);
+}
 
-  if (this->HasPreviousStep())
-  {
-    forgetGateError = cell.slice(this->PreviousStep()) % cellError %
-        (forgetGateActivation.slice(this->CurrentStep()) %
-        (1.0 - forgetGateActivation.slice(this->CurrentStep())));
-  }
-  else
+template<typename MatType>
+void LSTMType<MatType>::BackwardSequence(const MatType& input,
+                                         const MatType& /* output */,
+                                         const MatType& gy,
+                                         MatType& g,
+                                         MatType& gradient,
+                                         const size_t steps)
+{
+  const size_t batchSize = input.n_cols / steps;
+  const size_t firstStep = this->CurrentStep();
+  const size_t blockSteps = BlockSteps(batchSize, steps);
+
+  gradient.zeros();
+  cellError.zeros(outSize, batchSize);
+  outputError = gy.cols((steps - 1) * batchSize, steps * batchSize - 1);
+
+  // The steps are processed from the last to the first, in blocks.  The error
+  // of the input and the gradient of the weights are computed for each block
+  // of steps at once, while the errors of its gates are still in the cache.
+  MatType blockInput, blockG, stepGateError;
+  for (size_t s1 = steps; s1 > 0; )
   {
-    forgetGateError.zeros(forgetGateActivation.n_rows,
-        forgetGateActivation.n_cols);
+    const size_t s0 = (s1 > blockSteps) ? s1 - blockSteps : 0;
+
+    gateError.set_size(4 * outSize, (s1 - s0) * batchSize);
+    for (size_t s = s1; s > s0; --s)
+    {
+      MakeAlias(stepGateError, gateError.colptr((s - 1 - s0) * batchSize),
+          4 * outSize, batchSize);
+      BackwardStep(firstStep + s - 1, outputError, cellError, stepGateError);
+
+      // The error of the output of the previous step.
+      if (s > 1)
+      {
+        outputError = gy.cols((s - 2) * batchSize, (s - 1) * batchSize - 1);
+        outputError += recurrentWeight.t() * stepGateError;
+      }
+    }
+
+    MakeAlias(blockInput, (typename MatType::elem_type*)
+        input.colptr(s0 * batchSize), input.n_rows, (s1 - s0) * batchSize);
+    MakeAlias(blockG, g.colptr(s0 * batchSize), g.n_rows,
+        (s1 - s0) * batchSize);
+    blockG = inputWeight.t() * gateError;
+    ComputeGradient(blockInput, gateError, firstStep + s0, s1 - s0, gradient);
+
+    s1 = s0;
   }
+}
 
-  inputGateError = hiddenLayerActivation.slice(this->CurrentStep()) %
-      cellError % (inputGateActivation.slice(this->CurrentStep()) %
-      (1.0 - inputGateActivation.slice(this->CurrentStep())));
-
-  hiddenError = inputGateActivation.slice(this->CurrentStep()) % cellError %
-      (1 - arma::pow(hiddenLayerActivation.slice(this->CurrentStep()), 2));
+template<typename MatType>
+void LSTMType<MatType>::BackwardStep(const size_t step,
+                                     const MatType& stepOutputError,
+                                     MatType& stepCellError,
+                                     MatType& stepGateError)
+{
+  typedef typename MatType::elem_type ElemType;
 
-  inputCellError = forgetGateActivation.slice(this->CurrentStep()) % cellError +
-      forgetGateError.each_col() % cell2GateForgetWeight +
-      inputGateError.each_col() % cell2GateInputWeight;
+  const size_t batchSize = stepOutputError.n_cols;
+  const size_t previousStep = previousSteps[step];
+  const bool hasPrevious = (previousStep != size_t(-1));
 
-  g = input2GateInputWeight.t() * inputGateError +
-      input2HiddenWeight.t() * hiddenError +
-      input2GateForgetWeight.t() * forgetGateError +
-      input2GateOutputWeight.t() * outputGateError;
+  const ElemType* inputPeephole = peepholeWeight.colptr(0);
+  const ElemType* forgetPeephole = peepholeWeight.colptr(1);
+  const ElemType* outputPeephole = peepholeWeight.colptr(2);
+  for (size_t j = 0; j < batchSize; ++j)
+  {
+    const ElemType* gy = stepOutputError.colptr(j);
+    const ElemType* g = gates.slice_colptr(step, j);
+    const ElemType* cActivation = cellActivation.slice_colptr(step, j);
+    const ElemType* previousCell = hasPrevious ?
+        cell.slice_colptr(previousStep, j) : nullptr;
+    ElemType* cError = stepCellError.colptr(j);
+    ElemType* gError = stepGateError.colptr(j);
+
+    for (size_t r = 0; r < outSize; ++r)
+    {
+      const ElemType i = g[r];
+      const ElemType f = g[outSize + r];
+      const ElemType z = g[2 * outSize + r];
+      const ElemType o = g[3 * outSize + r];
+      const ElemType cPrevious = hasPrevious ? previousCell[r] : ElemType(0);
+
+      const ElemType oError = gy[r] * cActivation[r] * o * (1 - o);
+      const ElemType cellStepError = gy[r] * o *
+          (1 - cActivation[r] * cActivation[r]) + outputPeephole[r] * oError +
+          cError[r];
+      const ElemType iError = cellStepError * z * i * (1 - i);
+      const ElemType fError = cellStepError * cPrevious * f * (1 - f);
+      const ElemType zError = cellStepError * i * (1 - z * z);
+
+      gError[r] = iError;
+      gError[outSize + r] = fError;
+      gError[2 * outSize + r] = zError;
+      gError[3 * outSize + r] = oError;
+
+      // The error that flows into the cell of the previous step.
+      cError[r] = cellStepError * f + inputPeephole[r] * iError +
+          forgetPeephole[r] * fError;
+    }
+  }
 }
 
 template<typename MatType>
-void LSTMType<MatType>::Gradient(
-    const MatType& input,
-    const MatType& /* error */,
-    MatType& gradient)
+void LSTMType<MatType>::ComputeGradient(const MatType& input,
+                                        const MatType& error,
+                                        const size_t firstStep,
+                                        const size_t steps,
+                                        MatType& gradient)
 {
-  // This implementation depends on Gradient() being called just after
-  // Backward(), which is something we can safely assume.
+  typedef typename MatType::elem_type ElemType;
+
+  const size_t batchSize = input.n_cols / steps;
+  const size_t previousStep = previousSteps[firstStep];
+
+  MatType inputWeightGrad, recurrentWeightGrad, biasGrad, peepholeGrad;
+  MakeAlias(inputWeightGrad, gradient.memptr(), 4 * outSize, inSize);
+  size_t offset = inputWeightGrad.n_elem;
+  MakeAlias(recurrentWeightGrad, gradient.memptr() + offset, 4 * outSize,
+      outSize);
+  offset += recurrentWeightGrad.n_elem;
+  MakeAlias(biasGrad, gradient.memptr() + offset, 4 * outSize, 1);
+  offset += biasGrad.n_elem;
+  MakeAlias(peepholeGrad, gradient.memptr() + offset, outSize, 3);
+
+  inputWeightGrad += error * input.t();
+  biasGrad += arma::sum(error, 1);
+
+  // The stored steps are consecutive, so the previous outputs of every step
+  // but the first are held in one block of memory.
+  if (steps > 1)
+  {
+    MatType laterError, previousOutputs;
+    MakeAlias(laterError, (ElemType*) error.colptr(batchSize), error.n_rows,
+        error.n_cols - batchSize);
+    MakeAlias(previousOutputs, outputs.slice_memptr(firstStep), outSize,
+        input.n_cols - batchSize);
+    recurrentWeightGrad += laterError * previousOutputs.t();
+  }
 
-  // Input2GateOutputWeight and input2GateOutputBias gradients.
-  gradient.submat(0, 0, input2GateOutputWeight.n_elem - 1, 0) =
-      arma::vectorise(outputGateError * input.t());
-  gradient.submat(input2GateOutputWeight.n_elem, 0,
-      input2GateOutputWeight.n_elem + input2GateOutputBias.n_elem - 1, 0) =
-      arma::sum(outputGateError, 1);
-  size_t offset = input2GateOutputWeight.n_elem + input2GateOutputBias.n_elem;
-
-  // input2GateForgetWeight and input2GateForgetBias gradients.
-  gradient.submat(offset, 0, offset + input2GateForgetWeight.n_elem - 1, 0) =
-      arma::vectorise(forgetGateError * input.t());
-  gradient.submat(offset + input2GateForgetWeight.n_elem, 0,
-      offset + input2GateForgetWeight.n_elem +
-      input2GateForgetBias.n_elem - 1, 0) = arma::sum(forgetGateError, 1);
-  offset += input2GateForgetWeight.n_elem + input2GateForgetBias.n_elem;
-
-  // input2GateInputWeight and input2GateInputBias gradients.
-  gradient.submat(offset, 0, offset + input2GateInputWeight.n_elem - 1, 0) =
-      arma::vectorise(inputGateError * input.t());
-  gradient.submat(offset + input2GateInputWeight.n_elem, 0,
-      offset + input2GateInputWeight.n_elem +
-      input2GateInputBias.n_elem - 1, 0) = arma::sum(inputGateError, 1);
-  offset += input2GateInputWeight.n_elem + input2GateInputBias.n_elem;
-
-  // input2HiddenWeight and input2HiddenBias gradients.
-  gradient.submat(offset, 0, offset + input2HiddenWeight.n_elem - 1, 0) =
-      arma::vectorise(hiddenError * input.t());
-  gradient.submat(offset + input2HiddenWeight.n_elem, 0,
-      offset + input2HiddenWeight.n_elem + input2HiddenBias.n_elem - 1, 0) =
-      arma::sum(hiddenError, 1);
-  offset += input2HiddenWeight.n_elem + input2HiddenBias.n_elem;
-
-  // output2GateOutputWeight gradients.
-  gradient.submat(offset, 0, offset + output2GateOutputWeight.n_elem - 1, 0) =
-      arma::vectorise(outputGateError *
-      outParameter.slice(this->CurrentStep()).t());
-  offset += output2GateOutputWeight.n_elem;
-
-  // output2GateForgetWeight gradients.
-  gradient.submat(offset, 0, offset + output2GateForgetWeight.n_elem - 1, 0) =
-      arma::vectorise(forgetGateError *
-      outParameter.slice(this->CurrentStep()).t());
-  offset += output2GateForgetWeight.n_elem;
-
-  // output2GateInputWeight gradients.
-  gradient.submat(offset, 0, offset + output2GateInputWeight.n_elem - 1, 0) =
-      arma::vectorise(inputGateError *
-      outParameter.slice(this->CurrentStep()).t());
-  offset += output2GateInputWeight.n_elem;
-
-  // output2HiddenWeight gradients.
-  gradient.submat(offset, 0, offset + output2HiddenWeight.n_elem - 1, 0) =
-      arma::vectorise(hiddenError *
-      outParameter.slice(this->CurrentStep()).t());
-  offset += output2HiddenWeight.n_elem;
-
-  // cell2GateOutputWeight gradients.
-  gradient.submat(offset, 0, offset + cell2GateOutputWeight.n_elem - 1, 0) =
-      arma::sum(outputGateError % cell.slice(this->CurrentStep()), 1);
-  offset += cell2GateOutputWeight.n_elem;
-
-  // cell2GateForgetWeight and cell2GateInputWeight gradients.
-  if (this->HasPreviousStep())
+  if (previousStep != size_t(-1))
   {
-    gradient.submat(offset, 0, offset + cell2GateForgetWeight.n_elem - 1, 0) =
-        arma::sum(forgetGateError % cell.slice(this->PreviousStep()), 1);
-    gradient.submat(offset + cell2GateForgetWeight.n_elem, 0, offset +
-        cell2GateForgetWeight.n_elem + cell2GateInputWeight.n_elem - 1, 0) =
-        arma::sum(inputGateError % cell.slice(this->PreviousStep()), 1);
+    MatType firstError;
+    MakeAlias(firstError, (ElemType*) error.memptr(), error.n_rows, batchSize);
+    recurrentWeightGrad += firstError * outputs.slice(previousStep).t();
   }
-  else
+
+  // The gradient of the peephole weights.
+  ElemType* inputPeepholeGrad = peepholeGrad.colptr(0);
+  ElemType* forgetPeepholeGrad = peepholeGrad.colptr(1);
+  ElemType* outputPeepholeGrad = peepholeGrad.colptr(2);
+  for (size_t s = 0; s < steps; ++s)
   {
-    gradient.submat(offset, 0, offset +
-        cell2GateForgetWeight.n_elem - 1, 0).zeros();
-    gradient.submat(offset + cell2GateForgetWeight.n_elem, 0, offset +
-        cell2GateForgetWeight.n_elem +
-        cell2GateInputWeight.n_elem - 1, 0).zeros();
+    const size_t step = firstStep + s;
+    const size_t stepPrevious = previousSteps[step];
+    for (size_t j = 0; j < batchSize; ++j)
+    {
+      const ElemType* e = error.colptr(s * batchSize + j);
+      const ElemType* c = cell.slice_colptr(step, j);
+      for (size_t r = 0; r < outSize; ++r)
+        outputPeepholeGrad[r] += e[3 * outSize + r] * c[r];
+
+      if (stepPrevious == size_t(-1))
+        continue;
+
+      const ElemType* previousCell = cell.slice_colptr(stepPrevious, j);
+      for (size_t r = 0; r < outSize; ++r)
+      {
+        inputPeepholeGrad[r] += e[r] * previousCell[r];
+        forgetPeepholeGrad[r] += e[outSize + r] * previousCell[r];
+      }
+    }
   }
 }
 
+template<typename MatType>
+size_t LSTMType<MatType>::BlockSteps(const size_t batchSize,
+                                     const size_t steps) const
+{
+  // Aim for blocks whose gates (4 * outSize * batchSize elements per step) fit
+  // in the L2 cache.
+  const size_t blockElements = (256 * 1024) /
+      sizeof(typename MatType::elem_type);
+  const size_t stepElements = std::max(4 * outSize * batchSize, size_t(1));
+  return std::max(size_t(1), std::min(steps, blockElements / stepElements));
+}
+
 template<typename MatType>
 template<typename Archive>
 void LSTMType<MatType>::serialize(Archive& ar, const uint32_t /* version */)
@@ -400,17 +453,15 @@ void LSTMType<MatType>::serialize(Archive& ar, const uint32_t /* version */)
   // Clear recurrent state if we are loading.
   if (Archive::is_loading::value)
   {
-    inputGateActivation.clear();
-    forgetGateActivation.clear();
-    outputGateActivation.clear();
-    hiddenLayerActivation.clear();
+    gates.clear();
+    cell.clear();
     cellActivation.clear();
-    forgetGateError.clear();
-    outputGateError.clear();
-    outParameter.clear();
-    inputCellError.clear();
-    inputGateError.clear();
-    hiddenError.clear();
+    outputs.clear();
+    previousSteps.clear();
+    projection.clear();
+    gateError.clear();
+    cellError.clear();
+    outputError.clear();
   }
 }
 
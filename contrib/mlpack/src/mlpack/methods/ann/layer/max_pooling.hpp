@@ -15,6 +15,7 @@
 
 #include <mlpack/prereqs.hpp>
 
+#include <mlpack/methods/ann/parallel_columns.hpp>
 #include "layer.hpp"
 
 namespace mlpack {
@@ -162,36 +163,42 @@ class MaxPoolingType : public Layer<MatType>
       arma::Cube<typename MatType::elem_type>& output,
       arma::Cube<size_t>& poolingIndices)
   {
-    // Iterate over all slices individually.
-    for (size_t s = 0; s < input.n_slices; ++s)
+    // Iterate over all slices individually; blocks of slices (that is, of
+    // channels of points) are pooled in parallel.
+    ParallelColumns(input.n_slices, input.n_rows * input.n_cols,
+        [&](const size_t sBegin, const size_t sEnd)
     {
-      for (size_t j = 0, colidx = 0; j < output.n_cols;
-          ++j, colidx += strideHeight)
+      for (size_t s = sBegin; s < sEnd; ++s)
       {
-        for (size_t i = 0, rowidx = 0; i < output.n_rows;
-            ++i, rowidx += strideWidth)
+        for (size_t j = 0, colidx = 0; j < output.n_cols;
+            ++j, colidx += strideHeight)
         {
-          const std::tuple<size_t, typename MatType::elem_type> poolResult =
-              pooling.PoolingWithIndex(input.slice(s).submat(
-                  rowidx,
-                  colidx,
-                  rowidx + kernelWidth - 1 - offset,
-                  colidx + kernelHeight - 1 - offset));
-
-          // Now map the returned pooling index, which corresponds to the
-          // submatrix we gave, back to its position in the (linearized) input.
-          const size_t poolIndex = std::get<0>(poolResult);
-          const size_t poolingCol = poolIndex / (kernelWidth - offset);
-          const size_t poolingRow = poolIndex % (kernelWidth - offset);
-          const size_t unmappedPoolingIndex = (rowidx + poolingRow) +
-              input.n_rows * (colidx + poolingCol) +
-              input.n_rows * input.n_cols * s;
-
-          poolingIndices(i, j, s) = unmappedPoolingIndex;
-          output(i, j, s) = std::get<1>(poolResult);
+          for (size_t i = 0, rowidx = 0; i < output.n_rows;
+              ++i, rowidx += strideWidth)
+          {
+            const std::tuple<size_t, typename MatType::elem_type> poolResult =
+                pooling.PoolingWithIndex(input.slice(s).submat(
+                    rowidx,
+                    colidx,
+                    rowidx + kernelWidth - 1 - offset,
+                    colidx + kernelHeight - 1 - offset));
+
+            // Now map the returned pooling index, which corresponds to the
+            // submatrix we gave, back to its position in the (linearized)
+            // input.
+            const size_t poolIndex = std::get<0>(poolResult);
+            const size_t poolingCol = poolIndex / (kernelWidth - offset);
+            const size_t poolingRow = poolIndex % (kernelWidth - offset);
+            const size_t unmappedPoolingIndex = (rowidx + poolingRow) +
+                input.n_rows * (colidx + poolingCol) +
+                input.n_rows * input.n_cols * s;
+
+            poolingIndices(i, j, s) = unmappedPoolingIndex;
+            output(i, j, s) = std::get<1>(poolResult);
+          }
         }
       }
-    }
+    });
   }
 
   /**
@@ -205,23 +212,27 @@ class MaxPoolingType : public Layer<MatType>
       const arma::Cube<typename MatType::elem_type>& input,
       arma::Cube<typename MatType::elem_type>& output)
   {
-    // Iterate over all slices individually.
-    for (size_t s = 0; s < input.n_slices; ++s)
+    // Iterate over all slices individually, in parallel blocks.
+    ParallelColumns(input.n_slices, input.n_rows * input.n_cols,
+        [&](const size_t sBegin, const size_t sEnd)
     {
-      for (size_t j = 0, colidx = 0; j < output.n_cols;
-          ++j, colidx += strideHeight)
+      for (size_t s = sBegin; s < sEnd; ++s)
       {
-        for (size_t i = 0, rowidx = 0; i < output.n_rows;
-            ++i, rowidx += strideWidth)
+        for (size_t j = 0, colidx = 0; j < output.n_cols;
+            ++j, colidx += strideHeight)
         {
-          output(i, j, s) = pooling.Pooling(input.slice(s).submat(
-              rowidx,
-              colidx,
-              rowidx + kernelWidth - 1 - offset,
-              colidx + kernelHeight - 1 - offset));
+          for (size_t i = 0, rowidx = 0; i < output.n_rows;
+              ++i, rowidx += strideWidth)
+          {
+            output(i, j, s) = pooling.Pooling(input.slice(s).submat(
+                rowidx,
+                colidx,
+                rowidx + kernelWidth - 1 - offset,
+                colidx + kernelHeight - 1 - offset));
+          }
         }
       }
-    }
+    });
   }
 
   /**
@@ -238,10 +249,15 @@ class MaxPoolingType : public Layer<MatType>
   {
     output.zeros();
 
-    for (size_t i = 0; i < poolingIndices.n_elem; ++i)
+    // The pooling indices of a slice always point into the same slice of the
+    // output, so blocks of slices can be unpooled in parallel without races.
+    const size_t sliceElems = poolingIndices.n_rows * poolingIndices.n_cols;
+    ParallelColumns(poolingIndices.n_slices, sliceElems,
+        [&](const size_t sBegin, const size_t sEnd)
     {
-      output(poolingIndices(i)) += error(i);
-    }
+      for (size_t i = sBegin * sliceElems; i < sEnd * sliceElems; ++i)
+        output(poolingIndices(i)) += error(i);
+    });
   }
 
   //! Locally-stored width of the pooling window.
@@ -13,6 +13,7 @@
 #define MLPACK_METHODS_ANN_LAYER_MULTI_LAYER_HPP
 
 #include "../make_alias.hpp"
+#include "../memory_plan.hpp"
 #include "layer.hpp"
 
 namespace mlpack {
@@ -85,6 +86,39 @@ class MultiLayer : public Layer<MatType>
                const size_t start,
                const size_t end);
 
+  /**
+   * Perform a forward pass with the given input data, when no backward pass
+   * will follow (e.g. for prediction).  The outputs of the layers are not kept,
+   * so only two buffers for intermediate outputs are used, whatever the number
+   * of layers.  `output` is expected to have the correct size.
+   *
+   * @param input Input data to pass through the MultiLayer.
+   * @param output Matrix to store output in.
+   */
+  void ForwardOnly(const MatType& input, MatType& output);
+
+  /**
+   * Perform the backward pass and compute the gradients of each layer at once,
+   * after a call to `Forward()` with the same `input` that gave `output`.  The
+   * gradient of each layer is computed as soon as the error of its output is
+   * known, so the errors of the layers share two buffers.  If the last forward
+   * pass dropped some outputs (see `CheckpointInterval()`), they are recomputed
+   * from the previous checkpoint here.
+   *
+   * `g` and `gradient` are expected to have the correct size already.
+   *
+   * @param input Original input data provided to Forward().
+   * @param output Output of Forward().
+   * @param gy Propagated error from next layer.
+   * @param g Matrix to store propagated error in for previous layer.
+   * @param gradient Matrix to store the gradients in.
+   */
+  void BackwardWithGradient(const MatType& input,
+                            const MatType& output,
+                            const MatType& gy,
+                            MatType& g,
+                            MatType& gradient);
+
   /**
    * Perform a backward pass with the given data.  `gy` is expected to be the
    * propagated error from the subsequent layer (or output), `input` is expected
@@ -176,7 +210,7 @@ class MultiLayer : public Layer<MatType>
   }
 
   //! Get the network (series of layers) held by this MultiLayer.
-  const std::vector<Layer<MatType>*> Network() const
+  const std::vector<Layer<MatType>*>& Network() const
   {
     return network;
   }
@@ -184,6 +218,19 @@ class MultiLayer : public Layer<MatType>
   //! careful!
   std::vector<Layer<MatType>*>& Network() { return network; }
 
+  /**
+   * Get the checkpoint interval: if it is not 0, then a forward pass in
+   * training mode only keeps the output of every `CheckpointInterval()`-th
+   * layer, and `BackwardWithGradient()` recomputes the others.  See
+   * `MemoryPlan`.
+   */
+  size_t CheckpointInterval() const { return checkpointInterval; }
+  //! Modify the checkpoint interval.
+  void CheckpointInterval(const size_t interval)
+  {
+    checkpointInterval = interval;
+  }
+
   //! Serialize the MultiLayer.
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t /* version */);
@@ -207,6 +254,26 @@ class MultiLayer : public Layer<MatType>
    */
   void InitializeBackwardPassMemory(const size_t batchSize);
 
+  /**
+   * Initialize memory for the forward pass as given by `memoryPlan`: the
+   * outputs that are not kept share memory.
+   */
+  void InitializeForwardPassMemory(const size_t batchSize,
+                                   const MemoryPlan<MatType>& memoryPlan);
+
+  /**
+   * Initialize memory for `ForwardOnly()`: the outputs of the layers alternate
+   * between two buffers.
+   */
+  void InitializePredictionMemory(const size_t batchSize);
+
+  /**
+   * Initialize memory for `BackwardWithGradient()`: the errors of the layers
+   * alternate between two buffers, as given by `memoryPlan`.
+   */
+  void InitializeBackwardPassMemory(const size_t batchSize,
+                                    const MemoryPlan<MatType>& memoryPlan);
+
   /**
    * Initialize memory for the gradient pass.  This sets the internal aliases
    * `layerGradients` appropriately using the memory from the given `gradient`,
@@ -225,6 +292,16 @@ class MultiLayer : public Layer<MatType>
   // Total number of output elements for *every* layer.
   size_t totalOutputSize;
 
+  // Keep only the output of every `checkpointInterval`-th layer when training
+  // (or of all layers if 0).
+  size_t checkpointInterval;
+  // Whether the last forward pass did not keep the outputs of all layers.
+  bool outputsDropped;
+  // First layer of the segment whose dropped outputs are currently stored.
+  size_t segmentInBuffer;
+  // The memory plan of the last forward pass.
+  MemoryPlan<MatType> plan;
+
   //! This matrix stores all of the outputs of each layer when Forward() is
   //! called.  See `InitializeForwardPassMemory()`.
   MatType layerOutputMatrix;
@@ -22,7 +22,10 @@ template<typename MatType>
 MultiLayer<MatType>::MultiLayer() :
     inSize(0),
     totalInputSize(0),
-    totalOutputSize(0)
+    totalOutputSize(0),
+    checkpointInterval(0),
+    outputsDropped(false),
+    segmentInBuffer(size_t(-1))
 {
   // Nothing to do.
 }
@@ -33,6 +36,9 @@ MultiLayer<MatType>::MultiLayer(const MultiLayer& other) :
     inSize(other.inSize),
     totalInputSize(other.totalInputSize),
     totalOutputSize(other.totalOutputSize),
+    checkpointInterval(other.checkpointInterval),
+    outputsDropped(false),
+    segmentInBuffer(size_t(-1)),
     layerOutputMatrix(other.layerOutputMatrix),
     layerDeltaMatrix(other.layerDeltaMatrix)
 {
@@ -56,6 +62,9 @@ MultiLayer<MatType>::MultiLayer(MultiLayer&& other) :
     inSize(std::move(other.inSize)),
     totalInputSize(std::move(other.totalInputSize)),
     totalOutputSize(std::move(other.totalOutputSize)),
+    checkpointInterval(std::move(other.checkpointInterval)),
+    outputsDropped(false),
+    segmentInBuffer(size_t(-1)),
     layerOutputMatrix(std::move(other.layerOutputMatrix)),
     layerDeltaMatrix(std::move(other.layerDeltaMatrix))
 {
@@ -87,6 +96,9 @@ MultiLayer<MatType>& MultiLayer<MatType>::operator=(const MultiLayer& other)
     inSize = other.inSize;
     totalInputSize = other.totalInputSize;
     totalOutputSize = other.totalOutputSize;
+    checkpointInterval = other.checkpointInterval;
+    outputsDropped = false;
+    segmentInBuffer = size_t(-1);
 
     layerOutputMatrix = other.layerOutputMatrix;
     layerDeltaMatrix = other.layerDeltaMatrix;
@@ -117,6 +129,9 @@ MultiLayer<MatType>& MultiLayer<MatType>::operator=(MultiLayer&& other)
     inSize = std::move(other.inSize);
     totalInputSize = std::move(other.totalInputSize);
     totalOutputSize = std::move(other.totalOutputSize);
+    checkpointInterval = std::move(other.checkpointInterval);
+    outputsDropped = false;
+    segmentInBuffer = size_t(-1);
 
     network = std::move(other.network);
 
@@ -152,15 +167,38 @@ void MultiLayer<MatType>::Forward(
 
   // Note that we use `output` for the last layer; layerOutputs is only used for
   // intermediate values between layers.
+  outputsDropped = false;
   if ((end - start) > 0)
   {
-    // Initialize memory for the forward pass (if needed).
-    InitializeForwardPassMemory(input.n_cols);
+    // Initialize memory for the forward pass (if needed).  When training the
+    // whole network with checkpoints, only some of the outputs are kept.
+    if (start == 0 && end == network.size() - 1)
+    {
+      plan = MemoryPlan<MatType>(network, inSize,
+          this->training ? checkpointInterval : 0);
+      outputsDropped = (plan.NumRecomputed() > 0);
+    }
+
+    if (outputsDropped)
+      InitializeForwardPassMemory(input.n_cols, plan);
+    else
+      InitializeForwardPassMemory(input.n_cols);
 
     network[start]->Forward(input, layerOutputs[start]);
     for (size_t i = start + 1; i < end; ++i)
       network[i]->Forward(layerOutputs[i - 1], layerOutputs[i]);
     network[end]->Forward(layerOutputs[end - 1], output);
+
+    // Remember which segment's outputs are still in the shared region.
+    segmentInBuffer = size_t(-1);
+    for (size_t i = end; i > 0 && outputsDropped; --i)
+    {
+      if (!plan.Kept()[i - 1])
+      {
+        segmentInBuffer = plan.SegmentStarts()[i - 1];
+        break;
+      }
+    }
   }
   else if ((end - start) == 0 && network.size() > 0)
   {
@@ -173,10 +211,111 @@ void MultiLayer<MatType>::Forward(
   }
 }
 
+template<typename MatType>
+void MultiLayer<MatType>::ForwardOnly(const MatType& input, MatType& output)
+{
+  if (network.size() <= 1)
+  {
+    Forward(input, output);
+    return;
+  }
+
+  // Make sure training/testing mode is set right in each layer.
+  for (size_t i = 0; i < network.size(); ++i)
+    network[i]->Training() = this->training;
+
+  // Since no backward pass follows, the outputs of the layers alternate between
+  // two buffers.
+  InitializePredictionMemory(input.n_cols);
+
+  network.front()->Forward(input, layerOutputs.front());
+  for (size_t i = 1; i < network.size() - 1; ++i)
+    network[i]->Forward(layerOutputs[i - 1], layerOutputs[i]);
+  network.back()->Forward(layerOutputs[network.size() - 2], output);
+
+  // The outputs can't be recomputed for a backward pass.
+  outputsDropped = true;
+  segmentInBuffer = size_t(-1);
+  plan = MemoryPlan<MatType>();
+}
+
+template<typename MatType>
+void MultiLayer<MatType>::BackwardWithGradient(const MatType& input,
+                                               const MatType& output,
+                                               const MatType& gy,
+                                               MatType& g,
+                                               MatType& gradient)
+{
+  if (network.size() == 1)
+  {
+    network[0]->Backward(output, gy, g);
+    network[0]->Gradient(input, gy, gradient);
+    return;
+  }
+  else if (network.size() == 0)
+  {
+    // Empty network?
+    g = gy;
+    return;
+  }
+
+  // Initialize memory for the backward and gradient passes.  The error of each
+  // layer is only needed until the previous layer has used it, so the errors
+  // alternate between two buffers.
+  if (plan.Kept().size() != network.size())
+  {
+    if (outputsDropped)
+    {
+      throw std::logic_error("MultiLayer::BackwardWithGradient(): the outputs "
+          "of the layers were not kept by the last forward pass; call "
+          "Forward() instead of ForwardOnly() before the backward pass!");
+    }
+
+    plan = MemoryPlan<MatType>(network, inSize, 0);
+  }
+  InitializeBackwardPassMemory(input.n_cols, plan);
+  InitializeGradientPassMemory(gradient);
+
+  const MatType* error = &gy;
+  for (size_t i = network.size(); i > 0; --i)
+  {
+    const size_t l = i - 1;
+
+    // If this is the last layer of a segment whose outputs were dropped,
+    // compute them again from the output of the previous segment.
+    const size_t segmentStart = plan.SegmentStarts()[l];
+    if (outputsDropped && segmentStart < l && segmentStart != segmentInBuffer)
+    {
+      for (size_t j = segmentStart; j < l; ++j)
+      {
+        network[j]->Forward((j == 0) ? input : layerOutputs[j - 1],
+            layerOutputs[j]);
+      }
+      segmentInBuffer = segmentStart;
+    }
+
+    const MatType& layerOutput = (l == network.size() - 1) ? output :
+        layerOutputs[l];
+    MatType& delta = (l == 0) ? g : layerDeltas[l];
+    network[l]->Backward(layerOutput, *error, delta);
+    network[l]->Gradient((l == 0) ? input : layerOutputs[l - 1], *error,
+        layerGradients[l]);
+
+    error = &delta;
+  }
+}
+
 template<typename MatType>
 void MultiLayer<MatType>::Backward(
     const MatType& input, const MatType& gy, MatType& g)
 {
+  if (outputsDropped)
+  {
+    throw std::logic_error("MultiLayer::Backward(): the outputs of the layers "
+        "were not kept by the last forward pass; use BackwardWithGradient() "
+        "instead!");
+  }
+
   if (network.size() > 1)
   {
     // Initialize memory for the backward pass (if needed).
@@ -325,6 +464,9 @@ void MultiLayer<MatType>::serialize(
     layerOutputMatrix.clear();
     layerDeltaMatrix.clear();
     layerGradients.clear();
+    outputsDropped = false;
+    segmentInBuffer = size_t(-1);
+    plan = MemoryPlan<MatType>();
     layerOutputs.resize(network.size(), MatType());
     layerDeltas.resize(network.size(), MatType());
     layerGradients.resize(network.size(), MatType());
@@ -393,6 +535,71 @@ void MultiLayer<MatType>::InitializeBackwardPassMemory(
   }
 }
 
+template<typename MatType>
+void MultiLayer<MatType>::InitializeForwardPassMemory(
+    const size_t batchSize,
+    const MemoryPlan<MatType>& memoryPlan)
+{
+  // The plan gives the offset of the output of each layer, per point.
+  const size_t size = batchSize * memoryPlan.OutputSize();
+  if (size > layerOutputMatrix.n_elem ||
+      size < std::floor(0.1 * layerOutputMatrix.n_elem))
+  {
+    layerOutputMatrix = MatType(1, size);
+  }
+
+  for (size_t i = 0; i + 1 < layerOutputs.size(); ++i)
+  {
+    MakeAlias(layerOutputs[i], layerOutputMatrix.colptr(batchSize *
+        memoryPlan.Offsets()[i]), network[i]->OutputSize(), batchSize);
+  }
+}
+
+template<typename MatType>
+void MultiLayer<MatType>::InitializePredictionMemory(const size_t batchSize)
+{
+  // The outputs of the layers alternate between two buffers, each large enough
+  // for the largest output.
+  size_t maxSize = 0;
+  for (size_t i = 0; i + 1 < network.size(); ++i)
+    maxSize = std::max(maxSize, network[i]->OutputSize());
+
+  const size_t size = 2 * batchSize * maxSize;
+  if (size > layerOutputMatrix.n_elem ||
+      size < std::floor(0.1 * layerOutputMatrix.n_elem))
+  {
+    layerOutputMatrix = MatType(1, size);
+  }
+
+  for (size_t i = 0; i + 1 < layerOutputs.size(); ++i)
+  {
+    MakeAlias(layerOutputs[i], layerOutputMatrix.colptr((i % 2) * batchSize *
+        maxSize), network[i]->OutputSize(), batchSize);
+  }
+}
+
+template<typename MatType>
+void MultiLayer<MatType>::InitializeBackwardPassMemory(
+    const size_t batchSize,
+    const MemoryPlan<MatType>& memoryPlan)
+{
+  // The errors of the layers (but the first, whose error is stored by the
+  // caller) alternate between two buffers.
+  const size_t size = batchSize * memoryPlan.DeltaSize();
+  if (size > layerDeltaMatrix.n_elem ||
+      size < std::floor(0.1 * layerDeltaMatrix.n_elem))
+  {
+    layerDeltaMatrix = MatType(1, size);
+  }
+
+  const size_t bufferSize = batchSize * memoryPlan.DeltaSize() / 2;
+  for (size_t i = 1; i < layerDeltas.size(); ++i)
+  {
+    MakeAlias(layerDeltas[i], layerDeltaMatrix.colptr((i % 2) * bufferSize),
+        network[i - 1]->OutputSize(), batchSize);
+  }
+}
+
 template<typename MatType>
 void MultiLayer<MatType>::InitializeGradientPassMemory(MatType& gradient)
 {
@@ -0,0 +1,334 @@
+/**
+ * @file methods/ann/layer/multihead_attention.hpp
+ * @author Mrityunjay Tripathi
+ *
+ * Definition of the MultiheadAttention class.
+ *
+ * @code
+ * @article{NIPS'17,
+ *   author  = {Ashish Vaswani, Llion Jones, Noam Shazeer, Niki Parmar,
+ *              Aidan N. Gomez, Jakob Uszkoreit, Łukasz Kaiser,
+ *              Illia Polosukhin},
+ *   title   = {Attention Is All You Need},
+ *   year    = {2017},
+ *   url     = {http://arxiv.org/abs/1706.03762v5}
+ * }
+ * @endcode
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_MULTIHEAD_ATTENTION_HPP
+#define MLPACK_METHODS_ANN_LAYER_MULTIHEAD_ATTENTION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/ann/regularizer/no_regularizer.hpp>
+
+#include "layer.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Multihead Attention allows the model to jointly attend to information from
+ * different representation subspaces at different positions. With a single
+ * attention head, averaging inhibits this. [arxiv.org:1706.03762v5]
+ *
+ * The MultiheadAttention class takes concatenated form of query, key and value.
+ * The query, key and value are concatenated into single matrix and fed to the
+ * Forward function as input.
+ *
+ * The query, key and value are matrices of shapes
+ * `(embedDim * tgtSeqLen, batchSize)`, `(embedDim * srcSeqLen, batchSize)`
+ * and `(embedDim * srcSeqLen, batchSize)` respectively. The output is a matrix
+ * of shape `(embedDim * tgtSeqLen, batchSize)`. The embeddings are stored
+ * consequently.
+ *
+ * The attention weights are never stored as a `tgtSeqLen x srcSeqLen` matrix.
+ * Instead, the scores are computed one tile of queries and keys at a time, and
+ * the softmax is accumulated over the tiles of keys as in FlashAttention (Dao
+ * et al., 2022): for each query, the running maximum and sum of the
+ * exponentials of its scores are kept and used to rescale the partial output.
+ * Only the log-sum-exp of the scores of each query is kept for the backward
+ * pass, which recomputes the scores tile by tile.  So, besides the projections
+ * of the query, key and value, the memory used grows linearly with the
+ * sequence lengths.  The projections of all heads and all points of a batch
+ * are computed with one matrix multiplication each, and the heads of the
+ * points of a batch are processed in parallel when OpenMP is enabled.
+ *
+ * Three masks can be used; none of them is expanded to a matrix:
+ *
+ *  - If `Causal()` is true, query `i` only attends to keys `j <= i`; tiles of
+ *    keys that are entirely masked are skipped.
+ *  - `KeyPaddingMask()`, of shape `(1, srcSeqLen)`, is added to the scores of
+ *    all queries for each key (use `-inf` or a large negative value to mask a
+ *    key out).
+ *  - `AttentionMask()`, of shape `(tgtSeqLen, srcSeqLen)`, is added to the
+ *    scores.
+ *
+ * @tparam MatType Matrix representation to accept as input and use for
+ *    computation.
+ * @tparam RegularizerType Type of the regularizer to be used.
+ */
+template <
+    typename MatType = arma::mat,
+    typename RegularizerType = NoRegularizer
+>
+class MultiheadAttentionType : public Layer<MatType>
+{
+ public:
+  //! Create the MultiheadAttention object.
+  MultiheadAttentionType();
+
+  /**
+   * Create the MultiheadAttention object using the specified modules.
+   *
+   * @param tgtSeqLen Target sequence length.
+   * @param srcSeqLen Source sequence length.
+   * @param embedDim Total dimension of the model.
+   * @param numHeads Number of parallel attention heads.
+   * @param attnMask Two dimensional Attention Mask.
+   * @param keyPaddingMask Key Padding Mask.
+   * @param causal Whether each query only attends to the keys at the same or
+   *     earlier positions.
+   * @param regularizer The regularizer to use, optional.
+   */
+  MultiheadAttentionType(const size_t tgtSeqLen,
+                         const size_t srcSeqLen,
+                         const size_t embedDim,
+                         const size_t numHeads,
+                         const MatType& attnMask = MatType(),
+                         const MatType& keyPaddingMask = MatType(),
+                         const bool causal = false,
+                         RegularizerType regularizer = RegularizerType());
+
+  //! Clone the MultiheadAttentionType object. This handles polymorphism
+  //! correctly.
+  MultiheadAttentionType* Clone() const
+  {
+    return new MultiheadAttentionType(*this);
+  }
+
+  // Virtual destructor.
+  virtual ~MultiheadAttentionType() { }
+
+  //! Copy the given MultiheadAttentionType (but not weights).
+  MultiheadAttentionType(const MultiheadAttentionType& other);
+  //! Take ownership of the given MultiheadAttentionType (but not weights).
+  MultiheadAttentionType(MultiheadAttentionType&& other);
+  //! Copy the given MultiheadAttentionType (but not weights).
+  MultiheadAttentionType& operator=(const MultiheadAttentionType& other);
+  //! Take ownership of the given MultiheadAttentionType (but not weights).
+  MultiheadAttentionType& operator=(MultiheadAttentionType&& other);
+
+  /**
+   * Reset the layer parameters.
+   */
+  void SetWeights(typename MatType::elem_type* weightsPtr);
+
+  /**
+   * Ordinary feed forward pass of a neural network, evaluating the function
+   * f(x) by propagating the activity forward through f.
+   *
+   * @param input The concatenated query, key and value.
+   * @param output Resulting output activation.
+   */
+  void Forward(const MatType& input, MatType& output);
+
+  /**
+   * Ordinary feed backward pass of a neural network, calculating the function
+   * f(x) by propagating x backwards trough f. Using the results from the feed
+   * forward pass.
+   *
+   * @param * (input) The propagated input activation.
+   * @param gy The backpropagated error.
+   * @param g The calculated gradient.
+   */
+  void Backward(const MatType& /* input */,
+                const MatType& gy,
+                MatType& g);
+
+  /**
+   * Calculate the gradient using the output delta and the input activation.
+   *
+   * @param input The input data used for evaluating specified function.
+   * @param error The calculated error.
+   * @param gradient The calculated gradient.
+   */
+  void Gradient(const MatType& input,
+                const MatType& error,
+                MatType& gradient);
+
+  //! Get the parameters.
+  MatType const& Parameters() const { return weights; }
+  //! Modify the parameters.
+  MatType& Parameters() { return weights; }
+
+  //! Get the size of the weights.
+  size_t WeightSize() const { return 4 * (embedDim + 1) * embedDim; }
+
+  //! Compute the output dimensions of the layer, using `InputDimensions()`.
+  void ComputeOutputDimensions();
+
+  /**
+   * Serialize the layer.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+  //! Get the target sequence length.
+  size_t TgtSeqLen() const { return tgtSeqLen; }
+  //! Modify the target sequence length.
+  size_t& TgtSeqLen() { return tgtSeqLen; }
+
+  //! Get the source sequence length.
+  size_t SrcSeqLen() const { return srcSeqLen; }
+  //! Modify the source sequence length.
+  size_t& SrcSeqLen() { return srcSeqLen; }
+
+  //! Get the embedding dimension.
+  size_t EmbedDim() const { return embedDim; }
+  //! Modify the embedding dimension.
+  size_t& EmbedDim() { return embedDim; }
+
+  //! Get the number of attention heads.
+  size_t NumHeads() const { return numHeads; }
+  //! Modify the number of attention heads.
+  size_t& NumHeads() { return numHeads; }
+
+  //! Get the two dimensional Attention Mask.
+  MatType const& AttentionMask() const { return attnMask; }
+  //! Modify the two dimensional Attention Mask.
+  MatType& AttentionMask() { return attnMask; }
+
+  //! Get Key Padding Mask.
+  MatType const& KeyPaddingMask() const { return keyPaddingMask; }
+  //! Modify the Key Padding Mask.
+  MatType& KeyPaddingMask() { return keyPaddingMask; }
+
+  //! Get whether the attention is causal.
+  bool Causal() const { return causal; }
+  //! Modify whether the attention is causal.
+  bool& Causal() { return causal; }
+
+ private:
+  //! Element Type of the output.
+  typedef typename MatType::elem_type ElemType;
+
+  //! Number of queries and of keys in each tile of the scores.
+  static const size_t tileSize = 64;
+
+  /**
+   * Copy the query, key and value of each point of the input next to each
+   * other, so that each of them can be projected with one multiplication.
+   */
+  void SplitInput(const MatType& input,
+                  MatType& query,
+                  MatType& key,
+                  MatType& value) const;
+
+  /**
+   * Add the masks to the given tile of scores, whose rows are the keys
+   * `keyBegin`, ... and whose columns are the queries `queryBegin`, ...
+   */
+  void ApplyMasks(MatType& scores,
+                  const size_t keyBegin,
+                  const size_t queryBegin) const;
+
+  /**
+   * Compute the errors of the projected query, key and value from the error of
+   * the output, and store them in `qGrad`, `kGrad` and `vGrad`.
+   */
+  void AttentionBackward(const MatType& error);
+
+  //! Target sequence length.
+  size_t tgtSeqLen;
+
+  //! Source sequence length.
+  size_t srcSeqLen;
+
+  //! Locally-stored dimensionality of each embedding vector.
+  size_t embedDim;
+
+  //! Locally-stored number of parallel attention heads.
+  size_t numHeads;
+
+  //! Dimensionality of each head.
+  size_t headDim;
+
+  //! Two dimensional Attention Mask of shape (tgtSeqLen, srcSeqLen).
+  MatType attnMask;
+
+  //! Key Padding Mask of shape (1, srcSeqLen).
+  MatType keyPaddingMask;
+
+  //! Whether each query only attends to keys at earlier positions.
+  bool causal;
+
+  //! Locally-stored weights parameter.
+  MatType weights;
+
+  //! Locally-stored weight matrix associated with query.
+  MatType queryWt;
+
+  //! Locally-stored weight matrix associated with key.
+  MatType keyWt;
+
+  //! Locally-stored weight matrix associated with value.
+  MatType valueWt;
+
+  //! Locally-stored weight matrix associated with attnWt.
+  MatType outWt;
+
+  //! Locally-stored bias associated with query.
+  MatType qBias;
+
+  //! Locally-stored bias associated with key.
+  MatType kBias;
+
+  //! Locally-stored bias associated with value.
+  MatType vBias;
+
+  //! Locally-stored bias associated with attnWt.
+  MatType outBias;
+
+  //! Projected (and scaled) queries, of shape (embedDim, tgtSeqLen *
+  //! batchSize).
+  MatType qProj;
+
+  //! Projected keys, of shape (embedDim, srcSeqLen * batchSize).
+  MatType kProj;
+
+  //! Projected values, of shape (embedDim, srcSeqLen * batchSize).
+  MatType vProj;
+
+  //! Output of the heads before the output projection, of shape (embedDim,
+  //! tgtSeqLen * batchSize).
+  MatType attnOut;
+
+  //! Log-sum-exp of the scores of each query, of shape (tgtSeqLen * batchSize,
+  //! numHeads).
+  MatType logSumExp;
+
+  //! Errors of the projected queries, keys and values.
+  MatType qGrad, kGrad, vGrad;
+
+  //! Whether qGrad, kGrad and vGrad hold the errors for the last Forward().
+  bool backwardDone;
+
+  //! Locally-stored regularizer object.
+  RegularizerType regularizer;
+}; // class MultiheadAttentionType
+
+// Standard MultiheadAttention layer using no regularization.
+typedef MultiheadAttentionType<arma::mat, NoRegularizer> MultiheadAttention;
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "multihead_attention_impl.hpp"
+
+#endif
@@ -0,0 +1,566 @@
+/**
+ * @file methods/ann/layer/multihead_attention_impl.hpp
+ * @author Mrityunjay Tripathi
+ *
+ * Implementation of the MultiheadAttention class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_MULTIHEAD_ATTENTION_IMPL_HPP
+#define MLPACK_METHODS_ANN_LAYER_MULTIHEAD_ATTENTION_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "multihead_attention.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename MatType, typename RegularizerType>
+MultiheadAttentionType<MatType, RegularizerType>::MultiheadAttentionType() :
+    Layer<MatType>(),
+    tgtSeqLen(0),
+    srcSeqLen(0),
+    embedDim(0),
+    numHeads(0),
+    headDim(0),
+    causal(false),
+    backwardDone(false)
+{
+  // Nothing to do here.
+}
+
+template<typename MatType, typename RegularizerType>
+MultiheadAttentionType<MatType, RegularizerType>::MultiheadAttentionType(
+    const size_t tgtSeqLen,
+    const size_t srcSeqLen,
+    const size_t embedDim,
+    const size_t numHeads,
+    const MatType& attnMask,
+    const MatType& keyPaddingMask,
+    const bool causal,
+    RegularizerType regularizer) :
+    Layer<MatType>(),
+    tgtSeqLen(tgtSeqLen),
+    srcSeqLen(srcSeqLen),
+    embedDim(embedDim),
+    numHeads(numHeads),
+    attnMask(attnMask),
+    keyPaddingMask(keyPaddingMask),
+    causal(causal),
+    backwardDone(false),
+    regularizer(regularizer)
+{
+  if (numHeads == 0 || embedDim % numHeads != 0)
+  {
+    Log::Fatal << "Embedding dimension must be divisible by number of "
+        << "attention heads." << std::endl;
+  }
+
+  headDim = embedDim / numHeads;
+}
+
+template<typename MatType, typename RegularizerType>
+MultiheadAttentionType<MatType, RegularizerType>::MultiheadAttentionType(
+    const MultiheadAttentionType& other) :
+    Layer<MatType>(other),
+    tgtSeqLen(other.tgtSeqLen),
+    srcSeqLen(other.srcSeqLen),
+    embedDim(other.embedDim),
+    numHeads(other.numHeads),
+    headDim(other.headDim),
+    attnMask(other.attnMask),
+    keyPaddingMask(other.keyPaddingMask),
+    causal(other.causal),
+    backwardDone(false),
+    regularizer(other.regularizer)
+{
+  // Nothing to do.
+}
+
+template<typename MatType, typename RegularizerType>
+MultiheadAttentionType<MatType, RegularizerType>::MultiheadAttentionType(
+    MultiheadAttentionType&& other) :
+    Layer<MatType>(std::move(other)),
+    tgtSeqLen(std::move(other.tgtSeqLen)),
+    srcSeqLen(std::move(other.srcSeqLen)),
+    embedDim(std::move(other.embedDim)),
+    numHeads(std::move(other.numHeads)),
+    headDim(std::move(other.headDim)),
+    attnMask(std::move(other.attnMask)),
+    keyPaddingMask(std::move(other.keyPaddingMask)),
+    causal(std::move(other.causal)),
+    backwardDone(false),
+    regularizer(std::move(other.regularizer))
+{
+  // Nothing to do.
+}
+
+template<typename MatType, typename RegularizerType>
+MultiheadAttentionType<MatType, RegularizerType>&
+MultiheadAttentionType<MatType, RegularizerType>::operator=(
+    const MultiheadAttentionType& other)
+{
+  if (&other != this)
+  {
+    Layer<MatType>::operator=(other);
+    tgtSeqLen = other.tgtSeqLen;
+    srcSeqLen = other.srcSeqLen;
+    embedDim = other.embedDim;
+    numHeads = other.numHeads;
+    headDim = other.headDim;
+    attnMask = other.attnMask;
+    keyPaddingMask = other.keyPaddingMask;
+    causal = other.causal;
+    backwardDone = false;
+    regularizer = other.regularizer;
+  }
+
+  return *this;
+}
+
+template<typename MatType, typename RegularizerType>
+MultiheadAttentionType<MatType, RegularizerType>&
+MultiheadAttentionType<MatType, RegularizerType>::operator=(
+    MultiheadAttentionType&& other)
+{
+  if (&other != this)
+  {
+    Layer<MatType>::operator=(std::move(other));
+    tgtSeqLen = std::move(other.tgtSeqLen);
+    srcSeqLen = std::move(other.srcSeqLen);
+    embedDim = std::move(other.embedDim);
+    numHeads = std::move(other.numHeads);
+    headDim = std::move(other.headDim);
+    attnMask = std::move(other.attnMask);
+    keyPaddingMask = std::move(other.keyPaddingMask);
+    causal = std::move(other.causal);
+    backwardDone = false;
+    regularizer = std::move(other.regularizer);
+  }
+
+  return *this;
+}
+
+template<typename MatType, typename RegularizerType>
+void MultiheadAttentionType<MatType, RegularizerType>::SetWeights(
+    typename MatType::elem_type* weightsPtr)
+{
+  const size_t wtSize = embedDim * embedDim;
+  MakeAlias(weights, weightsPtr, WeightSize(), 1);
+
+  MakeAlias(queryWt, weightsPtr, embedDim, embedDim);
+  MakeAlias(keyWt, weightsPtr + wtSize, embedDim, embedDim);
+  MakeAlias(valueWt, weightsPtr + 2 * wtSize, embedDim, embedDim);
+  MakeAlias(outWt, weightsPtr + 3 * wtSize, embedDim, embedDim);
+
+  MakeAlias(qBias, weightsPtr + 4 * wtSize, embedDim, 1);
+  MakeAlias(kBias, weightsPtr + 4 * wtSize + embedDim, embedDim, 1);
+  MakeAlias(vBias, weightsPtr + 4 * wtSize + 2 * embedDim, embedDim, 1);
+  MakeAlias(outBias, weightsPtr + 4 * wtSize + 3 * embedDim, embedDim, 1);
+}
+
+template<typename MatType, typename RegularizerType>
+void MultiheadAttentionType<MatType, RegularizerType>::Forward(
+    const MatType& input, MatType& output)
+{
+  if (input.n_rows != embedDim * (tgtSeqLen + 2 * srcSeqLen))
+  {
+    Log::Fatal << "Incorrect input dimensions!" << std::endl;
+  }
+
+  if (!attnMask.is_empty() &&
+      (attnMask.n_rows != tgtSeqLen || attnMask.n_cols != srcSeqLen))
+  {
+    Log::Fatal << "The size of the 'attn_mask' is not correct." << std::endl;
+  }
+
+  if (!keyPaddingMask.is_empty() &&
+      (keyPaddingMask.n_rows != 1 || keyPaddingMask.n_cols != srcSeqLen))
+  {
+    Log::Fatal << "The size of the 'keyPaddingMask' is not correct."
+        << std::endl;
+  }
+
+  const size_t batchSize = input.n_cols;
+
+  // Project the queries, keys and values of all points and all heads at once.
+  // The scaling factor sqrt(headDim) is used to prevent exploding values
+  // after dot product i.e. when qProj is multiplied with kProj.
+  MatType query, key, value;
+  SplitInput(input, query, key, value);
+
+  qProj = queryWt * query;
+  qProj.each_col() += qBias;
+  qProj /= std::sqrt(ElemType(headDim));
+  kProj = keyWt * key;
+  kProj.each_col() += kBias;
+  vProj = valueWt * value;
+  vProj.each_col() += vBias;
+
+  attnOut.set_size(embedDim, tgtSeqLen * batchSize);
+  logSumExp.set_size(tgtSeqLen * batchSize, numHeads);
+
+  const ElemType inf = std::numeric_limits<ElemType>::infinity();
+
+  // Each head of each point is independent.
+  #pragma omp parallel for
+  for (omp_size_t t = 0; t < (omp_size_t) (batchSize * numHeads); ++t)
+  {
+    const size_t b = t / numHeads;
+    const size_t headBegin = (t % numHeads) * headDim;
+    const size_t headEnd = headBegin + headDim - 1;
+
+    for (size_t i0 = 0; i0 < tgtSeqLen; i0 += tileSize)
+    {
+      const size_t i1 = std::min(i0 + tileSize, tgtSeqLen);
+      const size_t nq = i1 - i0;
+      const MatType q = qProj.submat(headBegin, b * tgtSeqLen + i0, headEnd,
+          b * tgtSeqLen + i1 - 1);
+
+      // Running maximum and sum of the exponentials of the scores of each
+      // query, and the (unnormalized) output.
+      arma::Col<ElemType> maxScore(nq);
+      maxScore.fill(-inf);
+      arma::Col<ElemType> sumExp(nq, arma::fill::zeros);
+      MatType out(headDim, nq, arma::fill::zeros);
+
+      // With a causal mask, the queries of the tile attend to keys before i1.
+      const size_t keyEnd = causal ? std::min(i1, srcSeqLen) : srcSeqLen;
+      for (size_t j0 = 0; j0 < keyEnd; j0 += tileSize)
+      {
+        const size_t j1 = std::min(j0 + tileSize, keyEnd);
+        const size_t kBegin = b * srcSeqLen + j0;
+        const size_t kEnd = b * srcSeqLen + j1 - 1;
+
+        // The shape of scores : (nk, nq).
+        MatType scores = kProj.submat(headBegin, kBegin, headEnd, kEnd).t() * q;
+        ApplyMasks(scores, j0, i0);
+
+        for (size_t i = 0; i < nq; ++i)
+        {
+          const ElemType newMax = std::max(maxScore[i], scores.col(i).max());
+          if (newMax == -inf)
+          {
+            // Every key so far is masked out for this query.
+            scores.col(i).zeros();
+            continue;
+          }
+
+          const ElemType scale = std::exp(maxScore[i] - newMax);
+          scores.col(i) = arma::exp(scores.col(i) - newMax);
+          sumExp[i] = scale * sumExp[i] + arma::accu(scores.col(i));
+          maxScore[i] = newMax;
+          out.col(i) *= scale;
+        }
+
+        out += vProj.submat(headBegin, kBegin, headEnd, kEnd) * scores;
+      }
+
+      for (size_t i = 0; i < nq; ++i)
+      {
+        if (sumExp[i] > 0)
+        {
+          out.col(i) /= sumExp[i];
+          logSumExp(b * tgtSeqLen + i0 + i, t % numHeads) = maxScore[i] +
+              std::log(sumExp[i]);
+        }
+        else
+        {
+          // A query that attends to no key gives zero.
+          logSumExp(b * tgtSeqLen + i0 + i, t % numHeads) = inf;
+        }
+      }
+
+      attnOut.submat(headBegin, b * tgtSeqLen + i0, headEnd,
+          b * tgtSeqLen + i1 - 1) = out;
+    }
+  }
+
+  // The final output is the linear projection of attention output.  The
+  // columns of attnOut for each point are contiguous, so the output of all
+  // points is computed with one multiplication.
+  output.set_size(embedDim * tgtSeqLen, batchSize);
+  MatType outputAlias;
+  MakeAlias(outputAlias, output.memptr(), embedDim, tgtSeqLen * batchSize);
+  outputAlias = outWt * attnOut;
+  outputAlias.each_col() += outBias;
+
+  backwardDone = false;
+}
+
+template<typename MatType, typename RegularizerType>
+void MultiheadAttentionType<MatType, RegularizerType>::Backward(
+    const MatType& /* input */,
+    const MatType& gy,
+    MatType& g)
+{
+  if (gy.n_rows != tgtSeqLen * embedDim)
+  {
+    Log::Fatal << "Backpropagated error has incorrect dimensions!" << std::endl;
+  }
+
+  AttentionBackward(gy);
+
+  const size_t batchSize = gy.n_cols;
+  const MatType queryDelta = queryWt.t() * qGrad;
+  const MatType keyDelta = keyWt.t() * kGrad;
+  const MatType valueDelta = valueWt.t() * vGrad;
+
+  g.set_size(embedDim * (tgtSeqLen + 2 * srcSeqLen), batchSize);
+  for (size_t b = 0; b < batchSize; ++b)
+  {
+    MatType gAlias;
+    MakeAlias(gAlias, g.colptr(b), embedDim, tgtSeqLen + 2 * srcSeqLen);
+    gAlias.cols(0, tgtSeqLen - 1) = queryDelta.cols(b * tgtSeqLen,
+        (b + 1) * tgtSeqLen - 1);
+    gAlias.cols(tgtSeqLen, tgtSeqLen + srcSeqLen - 1) = keyDelta.cols(
+        b * srcSeqLen, (b + 1) * srcSeqLen - 1);
+    gAlias.cols(tgtSeqLen + srcSeqLen, tgtSeqLen + 2 * srcSeqLen - 1) =
+        valueDelta.cols(b * srcSeqLen, (b + 1) * srcSeqLen - 1);
+  }
+}
+
+template<typename MatType, typename RegularizerType>
+void MultiheadAttentionType<MatType, RegularizerType>::Gradient(
+    const MatType& input,
+    const MatType& error,
+    MatType& gradient)
+{
+  if (input.n_rows != embedDim * (tgtSeqLen + 2 * srcSeqLen))
+  {
+    Log::Fatal << "Incorrect input dimensions!" << std::endl;
+  }
+
+  if (error.n_rows != tgtSeqLen * embedDim)
+  {
+    Log::Fatal << "Backpropagated error has incorrect dimensions." << std::endl;
+  }
+
+  // The errors of the projections are shared with Backward(), if it was
+  // called.
+  if (!backwardDone)
+    AttentionBackward(error);
+
+  const size_t batchSize = input.n_cols;
+  const size_t wtSize = embedDim * embedDim;
+
+  MatType query, key, value;
+  SplitInput(input, query, key, value);
+
+  const MatType errorAlias(const_cast<ElemType*>(error.memptr()), embedDim,
+      tgtSeqLen * batchSize, false, true);
+
+  gradient.set_size(WeightSize(), 1);
+  gradient.rows(0, wtSize - 1) = arma::vectorise(qGrad * query.t());
+  gradient.rows(wtSize, 2 * wtSize - 1) = arma::vectorise(kGrad * key.t());
+  gradient.rows(2 * wtSize, 3 * wtSize - 1) =
+      arma::vectorise(vGrad * value.t());
+  gradient.rows(3 * wtSize, 4 * wtSize - 1) =
+      arma::vectorise(errorAlias * attnOut.t());
+
+  gradient.rows(4 * wtSize, 4 * wtSize + embedDim - 1) = arma::sum(qGrad, 1);
+  gradient.rows(4 * wtSize + embedDim, 4 * wtSize + 2 * embedDim - 1) =
+      arma::sum(kGrad, 1);
+  gradient.rows(4 * wtSize + 2 * embedDim, 4 * wtSize + 3 * embedDim - 1) =
+      arma::sum(vGrad, 1);
+  gradient.rows(4 * wtSize + 3 * embedDim, 4 * wtSize + 4 * embedDim - 1) =
+      arma::sum(errorAlias, 1);
+
+  // Regularize according to the given regularization rule.
+  regularizer.Evaluate(weights, gradient);
+
+  backwardDone = false;
+}
+
+template<typename MatType, typename RegularizerType>
+void MultiheadAttentionType<
+    MatType, RegularizerType
+>::ComputeOutputDimensions()
+{
+  size_t inputSize = this->inputDimensions[0];
+  for (size_t i = 1; i < this->inputDimensions.size(); ++i)
+    inputSize *= this->inputDimensions[i];
+
+  if (inputSize != embedDim * (tgtSeqLen + 2 * srcSeqLen))
+  {
+    Log::Fatal << "MultiheadAttention::ComputeOutputDimensions(): input size ("
+        << inputSize << ") must be embedDim * (tgtSeqLen + 2 * srcSeqLen) ("
+        << embedDim * (tgtSeqLen + 2 * srcSeqLen) << ")!" << std::endl;
+  }
+
+  // The output is a 2-dimensional (embedDim x tgtSeqLen) matrix.
+  this->outputDimensions = std::vector<size_t>({ embedDim, tgtSeqLen });
+}
+
+template<typename MatType, typename RegularizerType>
+template<typename Archive>
+void MultiheadAttentionType<MatType, RegularizerType>::serialize(
+    Archive& ar, const uint32_t /* version */)
+{
+  ar(cereal::base_class<Layer<MatType>>(this));
+
+  ar(CEREAL_NVP(tgtSeqLen));
+  ar(CEREAL_NVP(srcSeqLen));
+  ar(CEREAL_NVP(embedDim));
+  ar(CEREAL_NVP(numHeads));
+  ar(CEREAL_NVP(headDim));
+  ar(CEREAL_NVP(attnMask));
+  ar(CEREAL_NVP(keyPaddingMask));
+  ar(CEREAL_NVP(causal));
+  ar(CEREAL_NVP(regularizer));
+
+  if (Archive::is_loading::value)
+  {
+    qProj.clear();
+    kProj.clear();
+    vProj.clear();
+    attnOut.clear();
+    logSumExp.clear();
+    backwardDone = false;
+  }
+}
+
+template<typename MatType, typename RegularizerType>
+void MultiheadAttentionType<MatType, RegularizerType>::SplitInput(
+    const MatType& input,
+    MatType& query,
+    MatType& key,
+    MatType& value) const
+{
+  const size_t batchSize = input.n_cols;
+  query.set_size(embedDim, tgtSeqLen * batchSize);
+  key.set_size(embedDim, srcSeqLen * batchSize);
+  value.set_size(embedDim, srcSeqLen * batchSize);
+
+  for (size_t b = 0; b < batchSize; ++b)
+  {
+    // Each column of the input holds the embeddings of the query, key and
+    // value one after another.
+    const MatType point(const_cast<ElemType*>(input.colptr(b)), embedDim,
+        tgtSeqLen + 2 * srcSeqLen, false, true);
+    query.cols(b * tgtSeqLen, (b + 1) * tgtSeqLen - 1) =
+        point.cols(0, tgtSeqLen - 1);
+    key.cols(b * srcSeqLen, (b + 1) * srcSeqLen - 1) =
+        point.cols(tgtSeqLen, tgtSeqLen + srcSeqLen - 1);
+    value.cols(b * srcSeqLen, (b + 1) * srcSeqLen - 1) =
+        point.cols(tgtSeqLen + srcSeqLen, tgtSeqLen + 2 * srcSeqLen - 1);
+  }
+}
+
+template<typename MatType, typename RegularizerType>
+void MultiheadAttentionType<MatType, RegularizerType>::ApplyMasks(
+    MatType& scores,
+    const size_t keyBegin,
+    const size_t queryBegin) const
+{
+  if (!keyPaddingMask.is_empty())
+  {
+    for (size_t j = 0; j < scores.n_rows; ++j)
+      scores.row(j) += keyPaddingMask[keyBegin + j];
+  }
+
+  if (!attnMask.is_empty())
+  {
+    scores += attnMask.submat(queryBegin, keyBegin,
+        queryBegin + scores.n_cols - 1, keyBegin + scores.n_rows - 1).t();
+  }
+
+  if (causal)
+  {
+    // Key j is masked for query i if j > i.
+    const ElemType inf = std::numeric_limits<ElemType>::infinity();
+    for (size_t i = 0; i < scores.n_cols; ++i)
+    {
+      for (size_t j = (queryBegin + i + 1 > keyBegin) ?
+          queryBegin + i + 1 - keyBegin : 0; j < scores.n_rows; ++j)
+      {
+        scores(j, i) = -inf;
+      }
+    }
+  }
+}
+
+template<typename MatType, typename RegularizerType>
+void MultiheadAttentionType<MatType, RegularizerType>::AttentionBackward(
+    const MatType& error)
+{
+  const size_t batchSize = error.n_cols;
+  const MatType errorAlias(const_cast<ElemType*>(error.memptr()), embedDim,
+      tgtSeqLen * batchSize, false, true);
+
+  // The error of the output of the heads.
+  const MatType attnGrad = outWt.t() * errorAlias;
+
+  qGrad.zeros(embedDim, tgtSeqLen * batchSize);
+  kGrad.zeros(embedDim, srcSeqLen * batchSize);
+  vGrad.zeros(embedDim, srcSeqLen * batchSize);
+
+  // The scores are recomputed tile by tile from the projections and the
+  // log-sum-exp of the scores of each query.  The heads of each point write to
+  // distinct parts of qGrad, kGrad and vGrad.
+  #pragma omp parallel for
+  for (omp_size_t t = 0; t < (omp_size_t) (batchSize * numHeads); ++t)
+  {
+    const size_t b = t / numHeads;
+    const size_t head = t % numHeads;
+    const size_t headBegin = head * headDim;
+    const size_t headEnd = headBegin + headDim - 1;
+
+    for (size_t i0 = 0; i0 < tgtSeqLen; i0 += tileSize)
+    {
+      const size_t i1 = std::min(i0 + tileSize, tgtSeqLen);
+      const size_t qBegin = b * tgtSeqLen + i0;
+      const size_t qEnd = b * tgtSeqLen + i1 - 1;
+
+      const MatType q = qProj.submat(headBegin, qBegin, headEnd, qEnd);
+      const MatType outGrad = attnGrad.submat(headBegin, qBegin, headEnd,
+          qEnd);
+      const arma::Row<ElemType> lse =
+          logSumExp.submat(qBegin, head, qEnd, head).t();
+      // The derivative of the softmax needs sum_j p_ij dp_ij, which is the dot
+      // product of the error and the output of each query.
+      const arma::Row<ElemType> delta = arma::sum(outGrad %
+          attnOut.submat(headBegin, qBegin, headEnd, qEnd), 0);
+
+      const size_t keyEnd = causal ? std::min(i1, srcSeqLen) : srcSeqLen;
+      for (size_t j0 = 0; j0 < keyEnd; j0 += tileSize)
+      {
+        const size_t j1 = std::min(j0 + tileSize, keyEnd);
+        const size_t kBegin = b * srcSeqLen + j0;
+        const size_t kEnd = b * srcSeqLen + j1 - 1;
+
+        const MatType k = kProj.submat(headBegin, kBegin, headEnd, kEnd);
+        const MatType v = vProj.submat(headBegin, kBegin, headEnd, kEnd);
+
+        // The shape of probs : (nk, nq).
+        MatType probs = k.t() * q;
+        ApplyMasks(probs, j0, i0);
+        probs.each_row() -= lse;
+        probs = arma::exp(probs);
+
+        vGrad.submat(headBegin, kBegin, headEnd, kEnd) += outGrad * probs.t();
+
+        // Error of the scores.
+        MatType scoresGrad = v.t() * outGrad;
+        scoresGrad.each_row() -= delta;
+        scoresGrad %= probs;
+
+        qGrad.submat(headBegin, qBegin, headEnd, qEnd) += k * scoresGrad;
+        kGrad.submat(headBegin, kBegin, headEnd, kEnd) += q * scoresGrad.t();
+      }
+    }
+  }
+
+  // The queries were scaled after the projection.
+  qGrad /= std::sqrt(ElemType(headDim));
+
+  backwardDone = true;
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
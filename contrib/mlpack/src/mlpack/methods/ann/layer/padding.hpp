@@ -13,6 +13,7 @@
 #define MLPACK_METHODS_ANN_LAYER_PADDING_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/methods/ann/parallel_columns.hpp>
 #include "layer.hpp"
 
 namespace mlpack {
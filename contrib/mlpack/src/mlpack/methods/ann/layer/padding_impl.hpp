@@ -37,54 +37,60 @@ PaddingType<MatType>::PaddingType(
 template<typename MatType>
 void PaddingType<MatType>::Forward(const MatType& input, MatType& output)
 {
-  // Make an alias of the input and output so that we can deal with the first
-  // two dimensions directly.
-  arma::Cube<typename MatType::elem_type> reshapedInput(
-      (typename MatType::elem_type*) input.memptr(),
-      this->inputDimensions[0], this->inputDimensions[1], totalInMaps *
-      input.n_cols, false, true);
-  arma::Cube<typename MatType::elem_type> reshapedOutput(output.memptr(),
-      this->outputDimensions[0], this->outputDimensions[1], totalInMaps *
-      output.n_cols, false, true);
-
-  // Set the padding parts to 0.
-  if (padWLeft > 0)
+  // Blocks of points are padded in parallel.
+  ParallelColumns(input.n_cols, output.n_rows,
+      [&](const size_t begin, const size_t end)
   {
-    reshapedOutput.tube(0,
-                        0,
-                        reshapedOutput.n_rows - 1,
-                        padWLeft - 1).zeros();
-  }
-
-  if (padHTop > 0)
-  {
-    reshapedOutput.tube(0,
-                        padWLeft,
-                        padHTop - 1,
-                        padWLeft + this->inputDimensions[1] - 1).zeros();
-  }
-
-  if (padWRight > 0)
-  {
-    reshapedOutput.tube(0,
-                        padWLeft + this->inputDimensions[1],
-                        reshapedOutput.n_rows - 1,
-                        reshapedOutput.n_cols - 1).zeros();
-  }
-
-  if (padHBottom > 0)
-  {
-    reshapedOutput.tube(padHTop + this->inputDimensions[0],
+    // Make an alias of the input and output so that we can deal with the
+    // first two dimensions directly.
+    arma::Cube<typename MatType::elem_type> reshapedInput(
+        (typename MatType::elem_type*) input.colptr(begin),
+        this->inputDimensions[0], this->inputDimensions[1], totalInMaps *
+        (end - begin), false, true);
+    arma::Cube<typename MatType::elem_type> reshapedOutput(
+        output.colptr(begin), this->outputDimensions[0],
+        this->outputDimensions[1], totalInMaps * (end - begin), false, true);
+
+    // Set the padding parts to 0.
+    if (padWLeft > 0)
+    {
+      reshapedOutput.tube(0,
+                          0,
+                          reshapedOutput.n_rows - 1,
+                          padWLeft - 1).zeros();
+    }
+
+    if (padHTop > 0)
+    {
+      reshapedOutput.tube(0,
+                          padWLeft,
+                          padHTop - 1,
+                          padWLeft + this->inputDimensions[1] - 1).zeros();
+    }
+
+    if (padWRight > 0)
+    {
+      reshapedOutput.tube(0,
+                          padWLeft + this->inputDimensions[1],
+                          reshapedOutput.n_rows - 1,
+                          reshapedOutput.n_cols - 1).zeros();
+    }
+
+    if (padHBottom > 0)
+    {
+      reshapedOutput.tube(padHTop + this->inputDimensions[0],
+                          padWLeft,
+                          reshapedOutput.n_rows - 1,
+                          padWLeft + this->inputDimensions[1] - 1).zeros();
+    }
+
+    // Copy the input matrix.
+    reshapedOutput.tube(padHTop,
                         padWLeft,
-                        reshapedOutput.n_rows - 1,
-                        padWLeft + this->inputDimensions[1] - 1).zeros();
-  }
-
-  // Copy the input matrix.
-  reshapedOutput.tube(padHTop,
-                      padWLeft,
-                      padHTop + this->inputDimensions[0] - 1,
-                      padWLeft + this->inputDimensions[1] - 1) = reshapedInput;
+                        padHTop + this->inputDimensions[0] - 1,
+                        padWLeft + this->inputDimensions[1] - 1) =
+        reshapedInput;
+  });
 }
 
 template<typename MatType>
@@ -93,19 +99,24 @@ void PaddingType<MatType>::Backward(
     const MatType& gy,
     MatType& g)
 {
-  // Reshape g and gy so that extracting the un-padded input is easier to
-  // understand.
-  arma::Cube<typename MatType::elem_type> reshapedGy(
-      (typename MatType::elem_type*) gy.memptr(), this->outputDimensions[0],
-      this->outputDimensions[1], totalInMaps * gy.n_cols, false, true);
-  arma::Cube<typename MatType::elem_type> reshapedG(g.memptr(),
-      this->inputDimensions[0], this->inputDimensions[1], totalInMaps *
-      g.n_cols, false, true);
-
-  reshapedG = reshapedGy.tube(padHTop,
-                              padWLeft,
-                              padHTop + this->inputDimensions[0] - 1,
-                              padWLeft + this->inputDimensions[1] - 1);
+  ParallelColumns(gy.n_cols, gy.n_rows,
+      [&](const size_t begin, const size_t end)
+  {
+    // Reshape g and gy so that extracting the un-padded input is easier to
+    // understand.
+    arma::Cube<typename MatType::elem_type> reshapedGy(
+        (typename MatType::elem_type*) gy.colptr(begin),
+        this->outputDimensions[0], this->outputDimensions[1], totalInMaps *
+        (end - begin), false, true);
+    arma::Cube<typename MatType::elem_type> reshapedG(g.colptr(begin),
+        this->inputDimensions[0], this->inputDimensions[1], totalInMaps *
+        (end - begin), false, true);
+
+    reshapedG = reshapedGy.tube(padHTop,
+                                padWLeft,
+                                padHTop + this->inputDimensions[0] - 1,
+                                padWLeft + this->inputDimensions[1] - 1);
+  });
 }
 
 template<typename MatType>
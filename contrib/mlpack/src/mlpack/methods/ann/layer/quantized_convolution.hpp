@@ -0,0 +1,198 @@
+/**
+ * @file methods/ann/layer/quantized_convolution.hpp
+ *
+ * Definition of the QuantizedConvolution layer, an inference-only version of
+ * the Convolution layer with 8-bit integer filters.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_QUANTIZED_CONVOLUTION_HPP
+#define MLPACK_METHODS_ANN_LAYER_QUANTIZED_CONVOLUTION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/ann/convolution_rules/im2col_convolution.hpp>
+#include <mlpack/methods/ann/quantization/int8_gemm.hpp>
+
+#include "layer.hpp"
+#include "padding.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * The QuantizedConvolution layer computes the same function as the
+ * Convolution layer, but holds the filters as 8-bit integers, with one scale
+ * per output map (per-channel symmetric quantization).  The input is padded
+ * and lowered with `Im2ColConvolution`, quantized to 8-bit integers with a
+ * fixed scale that is usually found by calibration on a sample of inputs (see
+ * `Quantize()`), and convolved with all filters with a single integer matrix
+ * multiplication with 32-bit accumulation.  The bias is kept in floating
+ * point.
+ *
+ * The layer is meant for inference only: it has no trainable weights, and
+ * `Backward()` throws an exception.
+ *
+ * @tparam MatType Matrix representation to accept as input and use for
+ *    computation.
+ */
+template<typename MatType = arma::mat>
+class QuantizedConvolutionType : public Layer<MatType>
+{
+ public:
+  //! The element type of the input and output.
+  typedef typename MatType::elem_type ElemType;
+
+  //! Create an empty QuantizedConvolution object.
+  QuantizedConvolutionType();
+
+  /**
+   * Quantize the given filters.  The geometry parameters have the same meaning
+   * as for the Convolution layer.
+   *
+   * @param weight Filters (kernelWidth x kernelHeight x (inMaps * maps)); slice
+   *     (inMaps * m + i) is the filter of input map i for output map m.
+   * @param bias Bias (one element per output map), or an empty matrix for no
+   *     bias.
+   * @param maps Number of output maps.
+   * @param strideWidth Stride of filter application in the x direction.
+   * @param strideHeight Stride of filter application in the y direction.
+   * @param padWLeft Left padding width of the input.
+   * @param padWRight Right padding width of the input.
+   * @param padHTop Top padding height of the input.
+   * @param padHBottom Bottom padding height of the input.
+   * @param inputScale Scale used to quantize the input: input values are
+   *     divided by it and rounded to integers in [-127, 127].
+   */
+  QuantizedConvolutionType(const arma::Cube<ElemType>& weight,
+                           const MatType& bias,
+                           const size_t maps,
+                           const size_t strideWidth,
+                           const size_t strideHeight,
+                           const size_t padWLeft,
+                           const size_t padWRight,
+                           const size_t padHTop,
+                           const size_t padHBottom,
+                           const double inputScale);
+
+  //! Clone the QuantizedConvolutionType object. This handles polymorphism
+  //! correctly.
+  QuantizedConvolutionType* Clone() const
+  {
+    return new QuantizedConvolutionType(*this);
+  }
+
+  /**
+   * Convolve the input with the quantized filters.
+   *
+   * @param input Input data used for evaluating the specified function.
+   * @param output Resulting output activation.
+   */
+  void Forward(const MatType& input, MatType& output);
+
+  //! The layer can't be trained; this throws std::logic_error.
+  void Backward(const MatType& /* input */,
+                const MatType& /* gy */,
+                MatType& /* g */);
+
+  //! Get the quantized filters (one filter of kernelWidth * kernelHeight *
+  //! inMaps elements per output map, column-major).
+  const std::vector<int8_t>& Weight() const { return weight; }
+
+  //! Get the scale of the filter of each output map.
+  const arma::Col<ElemType>& WeightScales() const { return weightScales; }
+
+  //! Get the bias (empty if the layer has no bias).
+  const arma::Col<ElemType>& Bias() const { return bias; }
+
+  //! Get the scale used to quantize the input.
+  ElemType InputScale() const { return inputScale; }
+
+  //! Get the number of output maps.
+  size_t Maps() const { return maps; }
+  //! Get the filter width.
+  size_t KernelWidth() const { return kernelWidth; }
+  //! Get the filter height.
+  size_t KernelHeight() const { return kernelHeight; }
+
+  //! Compute the output dimensions of the layer given `InputDimensions()`.
+  void ComputeOutputDimensions();
+
+  //! Serialize the layer.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! Locally-stored number of output maps.
+  size_t maps;
+
+  //! Locally-stored number of input maps of each filter.
+  size_t filterMaps;
+
+  //! Locally-stored filter/kernel width.
+  size_t kernelWidth;
+
+  //! Locally-stored filter/kernel height.
+  size_t kernelHeight;
+
+  //! Locally-stored stride of the filter in x-direction.
+  size_t strideWidth;
+
+  //! Locally-stored stride of the filter in y-direction.
+  size_t strideHeight;
+
+  //! Locally-stored left-side padding width.
+  size_t padWLeft;
+
+  //! Locally-stored right-side padding width.
+  size_t padWRight;
+
+  //! Locally-stored top padding height.
+  size_t padHTop;
+
+  //! Locally-stored bottom padding height.
+  size_t padHBottom;
+
+  //! Locally-stored quantized filters, one per column.
+  std::vector<int8_t> weight;
+
+  //! Locally-stored scale of the filter of each output map.
+  arma::Col<ElemType> weightScales;
+
+  //! Locally-stored bias.
+  arma::Col<ElemType> bias;
+
+  //! Locally-stored scale of the input.
+  ElemType inputScale;
+
+  //! Locally-stored padding layer.
+  PaddingType<MatType> padding;
+
+  //! Locally-cached higher-order input dimensions.
+  size_t higherInDimensions;
+
+  //! Locally-stored padded input (workspace).
+  MatType inputPadded;
+
+  //! Locally-stored lowered input, and its transpose (workspace).
+  MatType lowered, loweredT;
+
+  //! Locally-stored quantized lowered input (workspace).
+  std::vector<int8_t> quantizedInput;
+
+  //! Locally-stored integer result of the convolution (workspace).
+  std::vector<int32_t> accumulated;
+}; // class QuantizedConvolutionType
+
+// Standard QuantizedConvolution layer.
+typedef QuantizedConvolutionType<arma::mat> QuantizedConvolution;
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "quantized_convolution_impl.hpp"
+
+#endif
@@ -0,0 +1,227 @@
+/**
+ * @file methods/ann/layer/quantized_convolution_impl.hpp
+ *
+ * Implementation of the QuantizedConvolution layer.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_QUANTIZED_CONVOLUTION_IMPL_HPP
+#define MLPACK_METHODS_ANN_LAYER_QUANTIZED_CONVOLUTION_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "quantized_convolution.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename MatType>
+QuantizedConvolutionType<MatType>::QuantizedConvolutionType() :
+    Layer<MatType>(),
+    maps(0),
+    filterMaps(0),
+    kernelWidth(0),
+    kernelHeight(0),
+    strideWidth(1),
+    strideHeight(1),
+    padWLeft(0),
+    padWRight(0),
+    padHTop(0),
+    padHBottom(0),
+    inputScale(1),
+    higherInDimensions(1)
+{
+  // Nothing to do here.
+}
+
+template<typename MatType>
+QuantizedConvolutionType<MatType>::QuantizedConvolutionType(
+    const arma::Cube<ElemType>& weightIn,
+    const MatType& biasIn,
+    const size_t maps,
+    const size_t strideWidth,
+    const size_t strideHeight,
+    const size_t padWLeft,
+    const size_t padWRight,
+    const size_t padHTop,
+    const size_t padHBottom,
+    const double inputScale) :
+    Layer<MatType>(),
+    maps(maps),
+    filterMaps(maps == 0 ? 0 : weightIn.n_slices / maps),
+    kernelWidth(weightIn.n_rows),
+    kernelHeight(weightIn.n_cols),
+    strideWidth(strideWidth),
+    strideHeight(strideHeight),
+    padWLeft(padWLeft),
+    padWRight(padWRight),
+    padHTop(padHTop),
+    padHBottom(padHBottom),
+    inputScale(inputScale > 0 ? inputScale : 1),
+    padding(padWLeft, padWRight, padHTop, padHBottom),
+    higherInDimensions(1)
+{
+  if (maps == 0 || weightIn.n_slices != maps * filterMaps)
+  {
+    std::ostringstream oss;
+    oss << "QuantizedConvolution::QuantizedConvolution(): the number of "
+        << "filter slices (" << weightIn.n_slices << ") is not a multiple of "
+        << "the number of output maps (" << maps << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (!biasIn.is_empty() && biasIn.n_elem != maps)
+  {
+    std::ostringstream oss;
+    oss << "QuantizedConvolution::QuantizedConvolution(): bias has "
+        << biasIn.n_elem << " elements, but there are " << maps
+        << " output maps!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  bias = arma::vectorise(biasIn);
+
+  // The filters of each output map are consecutive slices, so they form one
+  // column of this alias; each gets its own scale.
+  const size_t filterSize = kernelWidth * kernelHeight * filterMaps;
+  const MatType filters(const_cast<ElemType*>(weightIn.memptr()), filterSize,
+      maps, false, true);
+  weightScales = arma::vectorise(arma::max(arma::abs(filters), 0)) / 127;
+  weightScales.replace(0, 1);
+
+  weight.resize(filterSize * maps);
+  for (size_t m = 0; m < maps; ++m)
+  {
+    QuantizeInt8(filters.colptr(m), filterSize, weightScales[m],
+        weight.data() + m * filterSize);
+  }
+}
+
+template<typename MatType>
+void QuantizedConvolutionType<MatType>::Forward(
+    const MatType& input, MatType& output)
+{
+  // First, perform any padding if necessary.
+  const bool usingPadding =
+      (padWLeft != 0 || padWRight != 0 || padHTop != 0 || padHBottom != 0);
+  const size_t paddedRows = padding.OutputDimensions()[0];
+  const size_t paddedCols = padding.OutputDimensions()[1];
+  if (usingPadding)
+  {
+    inputPadded.set_size(paddedRows * paddedCols * filterMaps *
+        higherInDimensions, input.n_cols);
+    padding.Forward(input, inputPadded);
+  }
+
+  const arma::Cube<ElemType> inputTemp(const_cast<ElemType*>(
+      (usingPadding ? inputPadded : input).memptr()), paddedRows, paddedCols,
+      filterMaps * higherInDimensions * input.n_cols, false, true);
+
+  // Lower all input maps of all points at once, and quantize the patches; the
+  // lowered matrix is transposed first, so that each patch is contiguous.
+  Im2ColConvolution<ValidConvolution>::Im2Col(inputTemp, filterMaps,
+      kernelWidth, kernelHeight, strideWidth, strideHeight, 1, 1, lowered);
+  loweredT = lowered.t();
+
+  quantizedInput.resize(loweredT.n_elem);
+  QuantizeInt8(loweredT.memptr(), loweredT.n_elem, inputScale,
+      quantizedInput.data());
+
+  const size_t patches = loweredT.n_cols;
+  accumulated.resize(maps * patches);
+  Int8Gemm(weight.data(), quantizedInput.data(), accumulated.data(), maps,
+      patches, loweredT.n_rows);
+
+  // Patch (i + outSize * p) gives element i of each output map of point p
+  // (where the higher dimensions count as separate points).  Convert the
+  // result back to floating point, and add the bias.
+  const size_t outSize = this->outputDimensions[0] *
+      this->outputDimensions[1];
+  const bool hasBias = !bias.is_empty();
+  #pragma omp parallel for if (patches * maps >= 16384)
+  for (omp_size_t r = 0; r < (omp_size_t) patches; ++r)
+  {
+    const size_t p = r / outSize;
+    const size_t i = r % outSize;
+    const int32_t* acc = accumulated.data() + r * maps;
+    for (size_t m = 0; m < maps; ++m)
+    {
+      output[(p * maps + m) * outSize + i] = acc[m] * inputScale *
+          weightScales[m] + (hasBias ? bias[m] : 0);
+    }
+  }
+}
+
+template<typename MatType>
+void QuantizedConvolutionType<MatType>::Backward(
+    const MatType& /* input */, const MatType& /* gy */, MatType& /* g */)
+{
+  throw std::logic_error("QuantizedConvolution::Backward(): quantized layers "
+      "can only be used for inference!");
+}
+
+template<typename MatType>
+void QuantizedConvolutionType<MatType>::ComputeOutputDimensions()
+{
+  const size_t inMaps = (this->inputDimensions.size() >= 3) ?
+      this->inputDimensions[2] : 1;
+  if (inMaps != filterMaps)
+  {
+    std::ostringstream oss;
+    oss << "QuantizedConvolution::ComputeOutputDimensions(): input has "
+        << inMaps << " maps, but the filters have " << filterMaps << "!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  padding.InputDimensions() = this->inputDimensions;
+  padding.ComputeOutputDimensions();
+
+  // The output has at least 3 dimensions, like the Convolution layer.
+  this->outputDimensions = std::vector<size_t>(
+      std::max(this->inputDimensions.size(), size_t(3)), 1);
+  this->outputDimensions[0] = (padding.OutputDimensions()[0] - kernelWidth) /
+      strideWidth + 1;
+  this->outputDimensions[1] = (padding.OutputDimensions()[1] - kernelHeight) /
+      strideHeight + 1;
+
+  higherInDimensions = 1;
+  for (size_t i = 3; i < this->inputDimensions.size(); ++i)
+  {
+    higherInDimensions *= this->inputDimensions[i];
+    this->outputDimensions[i] = this->inputDimensions[i];
+  }
+
+  this->outputDimensions[2] = maps;
+}
+
+template<typename MatType>
+template<typename Archive>
+void QuantizedConvolutionType<MatType>::serialize(
+    Archive& ar, const uint32_t /* version */)
+{
+  ar(cereal::base_class<Layer<MatType>>(this));
+
+  ar(CEREAL_NVP(maps));
+  ar(CEREAL_NVP(filterMaps));
+  ar(CEREAL_NVP(kernelWidth));
+  ar(CEREAL_NVP(kernelHeight));
+  ar(CEREAL_NVP(strideWidth));
+  ar(CEREAL_NVP(strideHeight));
+  ar(CEREAL_NVP(padWLeft));
+  ar(CEREAL_NVP(padWRight));
+  ar(CEREAL_NVP(padHTop));
+  ar(CEREAL_NVP(padHBottom));
+  ar(CEREAL_NVP(weight));
+  ar(CEREAL_NVP(weightScales));
+  ar(CEREAL_NVP(bias));
+  ar(CEREAL_NVP(inputScale));
+  ar(CEREAL_NVP(padding));
+  ar(CEREAL_NVP(higherInDimensions));
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
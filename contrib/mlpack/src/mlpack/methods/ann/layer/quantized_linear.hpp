@@ -0,0 +1,135 @@
+/**
+ * @file methods/ann/layer/quantized_linear.hpp
+ *
+ * Definition of the QuantizedLinear layer, an inference-only version of the
+ * Linear and LinearNoBias layers with 8-bit integer weights.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_QUANTIZED_LINEAR_HPP
+#define MLPACK_METHODS_ANN_LAYER_QUANTIZED_LINEAR_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/ann/quantization/int8_gemm.hpp>
+
+#include "layer.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * The QuantizedLinear layer computes y = Ax + b like the Linear layer, but
+ * holds the weights A as 8-bit integers, with one scale per output unit
+ * (per-channel symmetric quantization).  The input is quantized to 8-bit
+ * integers too, with a fixed scale that is usually found by calibration on a
+ * sample of inputs (see `Quantize()`), and the product is computed with
+ * integer arithmetic and 32-bit accumulation.  The bias is kept in floating
+ * point, and is optional, so that the layer can replace both `Linear` and
+ * `LinearNoBias`.
+ *
+ * The layer is meant for inference only: it has no trainable weights, and
+ * `Backward()` throws an exception.
+ *
+ * @tparam MatType Matrix representation to accept as input and use for
+ *    computation.
+ */
+template<typename MatType = arma::mat>
+class QuantizedLinearType : public Layer<MatType>
+{
+ public:
+  //! The element type of the input and output.
+  typedef typename MatType::elem_type ElemType;
+
+  //! Create an empty QuantizedLinear object.
+  QuantizedLinearType();
+
+  /**
+   * Quantize the given weights.
+   *
+   * @param weight Weight matrix (outSize x inSize).
+   * @param bias Bias (outSize elements), or an empty matrix for no bias.
+   * @param inputScale Scale used to quantize the input: input values are
+   *     divided by it and rounded to integers in [-127, 127].
+   */
+  QuantizedLinearType(const MatType& weight,
+                      const MatType& bias,
+                      const double inputScale);
+
+  //! Clone the QuantizedLinearType object. This handles polymorphism correctly.
+  QuantizedLinearType* Clone() const { return new QuantizedLinearType(*this); }
+
+  /**
+   * Compute y = Ax + b with the quantized weights and input.
+   *
+   * @param input Input data used for evaluating the specified function.
+   * @param output Resulting output activation.
+   */
+  void Forward(const MatType& input, MatType& output);
+
+  //! The layer can't be trained; this throws std::logic_error.
+  void Backward(const MatType& /* input */,
+                const MatType& /* gy */,
+                MatType& /* g */);
+
+  //! Get the quantized weights (inSize x outSize, column-major).
+  const std::vector<int8_t>& Weight() const { return weight; }
+
+  //! Get the scale of the weights of each output unit.
+  const arma::Col<ElemType>& WeightScales() const { return weightScales; }
+
+  //! Get the bias (empty if the layer has no bias).
+  const arma::Col<ElemType>& Bias() const { return bias; }
+
+  //! Get the scale used to quantize the input.
+  ElemType InputScale() const { return inputScale; }
+
+  //! Get the weights converted back to floating point (outSize x inSize).
+  MatType DequantizedWeight() const;
+
+  //! Compute the output dimensions of the layer given `InputDimensions()`.
+  void ComputeOutputDimensions();
+
+  //! Serialize the layer.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! Locally-stored number of input units.
+  size_t inSize;
+
+  //! Locally-stored number of output units.
+  size_t outSize;
+
+  //! Locally-stored quantized weights; column i holds row i of the weight
+  //! matrix, so that the product is a sequence of contiguous dot products.
+  std::vector<int8_t> weight;
+
+  //! Locally-stored scale of the weights of each output unit.
+  arma::Col<ElemType> weightScales;
+
+  //! Locally-stored bias.
+  arma::Col<ElemType> bias;
+
+  //! Locally-stored scale of the input.
+  ElemType inputScale;
+
+  //! Locally-stored quantized input (workspace).
+  std::vector<int8_t> quantizedInput;
+
+  //! Locally-stored integer result of the product (workspace).
+  std::vector<int32_t> accumulated;
+}; // class QuantizedLinearType
+
+// Standard QuantizedLinear layer.
+typedef QuantizedLinearType<arma::mat> QuantizedLinear;
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "quantized_linear_impl.hpp"
+
+#endif
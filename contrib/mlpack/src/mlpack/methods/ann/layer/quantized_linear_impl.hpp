@@ -0,0 +1,148 @@
+/**
+ * @file methods/ann/layer/quantized_linear_impl.hpp
+ *
+ * Implementation of the QuantizedLinear layer.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_QUANTIZED_LINEAR_IMPL_HPP
+#define MLPACK_METHODS_ANN_LAYER_QUANTIZED_LINEAR_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "quantized_linear.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename MatType>
+QuantizedLinearType<MatType>::QuantizedLinearType() :
+    Layer<MatType>(),
+    inSize(0),
+    outSize(0),
+    inputScale(1)
+{
+  // Nothing to do here.
+}
+
+template<typename MatType>
+QuantizedLinearType<MatType>::QuantizedLinearType(
+    const MatType& weightIn,
+    const MatType& biasIn,
+    const double inputScale) :
+    Layer<MatType>(),
+    inSize(weightIn.n_cols),
+    outSize(weightIn.n_rows),
+    inputScale(inputScale > 0 ? inputScale : 1)
+{
+  if (!biasIn.is_empty() && biasIn.n_elem != outSize)
+  {
+    std::ostringstream oss;
+    oss << "QuantizedLinear::QuantizedLinear(): bias has " << biasIn.n_elem
+        << " elements, but the weight matrix has " << outSize << " rows!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  bias = arma::vectorise(biasIn);
+
+  // Each output unit gets its own scale, chosen so that its largest weight is
+  // mapped to 127.
+  weightScales = arma::max(arma::abs(weightIn), 1) / 127;
+  weightScales.replace(0, 1);
+
+  weight.resize(inSize * outSize);
+  const MatType transposed = weightIn.t();
+  for (size_t o = 0; o < outSize; ++o)
+  {
+    QuantizeInt8(transposed.colptr(o), inSize, weightScales[o],
+        weight.data() + o * inSize);
+  }
+}
+
+template<typename MatType>
+void QuantizedLinearType<MatType>::Forward(
+    const MatType& input, MatType& output)
+{
+  quantizedInput.resize(input.n_elem);
+  accumulated.resize(outSize * input.n_cols);
+
+  QuantizeInt8(input.memptr(), input.n_elem, inputScale,
+      quantizedInput.data());
+  Int8Gemm(weight.data(), quantizedInput.data(), accumulated.data(), outSize,
+      input.n_cols, inSize);
+
+  // Convert the result back to floating point, and add the bias.
+  const bool hasBias = !bias.is_empty();
+  for (size_t j = 0; j < input.n_cols; ++j)
+  {
+    const int32_t* acc = accumulated.data() + j * outSize;
+    ElemType* out = output.colptr(j);
+    for (size_t o = 0; o < outSize; ++o)
+    {
+      out[o] = acc[o] * inputScale * weightScales[o] +
+          (hasBias ? bias[o] : 0);
+    }
+  }
+}
+
+template<typename MatType>
+void QuantizedLinearType<MatType>::Backward(
+    const MatType& /* input */, const MatType& /* gy */, MatType& /* g */)
+{
+  throw std::logic_error("QuantizedLinear::Backward(): quantized layers can "
+      "only be used for inference!");
+}
+
+template<typename MatType>
+MatType QuantizedLinearType<MatType>::DequantizedWeight() const
+{
+  MatType result(outSize, inSize);
+  for (size_t o = 0; o < outSize; ++o)
+    for (size_t i = 0; i < inSize; ++i)
+      result(o, i) = weight[i + o * inSize] * weightScales[o];
+
+  return result;
+}
+
+template<typename MatType>
+void QuantizedLinearType<MatType>::ComputeOutputDimensions()
+{
+  size_t totalInSize = this->inputDimensions[0];
+  for (size_t i = 1; i < this->inputDimensions.size(); ++i)
+    totalInSize *= this->inputDimensions[i];
+
+  if (totalInSize != inSize)
+  {
+    std::ostringstream oss;
+    oss << "QuantizedLinear::ComputeOutputDimensions(): input has "
+        << totalInSize << " elements, but the layer expects " << inSize << "!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // The QuantizedLinear layer flattens its input, like the Linear layer.
+  this->outputDimensions = std::vector<size_t>(this->inputDimensions.size(),
+      1);
+  this->outputDimensions[0] = outSize;
+}
+
+template<typename MatType>
+template<typename Archive>
+void QuantizedLinearType<MatType>::serialize(
+    Archive& ar, const uint32_t /* version */)
+{
+  ar(cereal::base_class<Layer<MatType>>(this));
+
+  ar(CEREAL_NVP(inSize));
+  ar(CEREAL_NVP(outSize));
+  ar(CEREAL_NVP(weight));
+  ar(CEREAL_NVP(weightScales));
+  ar(CEREAL_NVP(bias));
+  ar(CEREAL_NVP(inputScale));
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -14,6 +14,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include "layer.hpp"
+#include "../make_alias.hpp"
 
 namespace mlpack {
 namespace ann {
@@ -65,6 +66,54 @@ class RecurrentLayer : public Layer<MatType>
       const size_t bpttSteps,
       const size_t batchSize) = 0;
 
+  /**
+   * Pass `steps` consecutive time steps of a sequence forward through the
+   * layer.  `input` holds the input of every step, as one block of
+   * `input.n_cols / steps` columns (the batch) per step, and `output` is filled
+   * in the same way.  The state before the first step is taken from
+   * `PreviousStep()` (if `HasPreviousStep()`).  If `storeSteps` is true, step
+   * `s` is stored in `CurrentStep() + s`, so that `BackwardSequence()` can be
+   * called afterwards; otherwise, every step overwrites `CurrentStep()`.
+   *
+   * When the function returns, `PreviousStep()` is the index of the last step,
+   * so that the sequence can be continued with another call.
+   *
+   * The default implementation calls `Forward()` once per step; layers can
+   * override it to process the steps more efficiently.
+   *
+   * @param input Input of all the steps.
+   * @param output Output of all the steps.
+   * @param steps Number of time steps in `input`.
+   * @param storeSteps Whether to keep the state of every step.
+   */
+  virtual void ForwardSequence(const MatType& input,
+                               MatType& output,
+                               const size_t steps,
+                               const bool storeSteps);
+
+  /**
+   * Backpropagate through the `steps` time steps that were last passed to
+   * `ForwardSequence()` with `storeSteps` set to true; `CurrentStep()` and
+   * `PreviousStep()` must be what they were before that call.  The error is
+   * not propagated to the steps before the first one (truncated BPTT).
+   *
+   * The default implementation calls `Backward()` and `Gradient()` once per
+   * step, from the last step to the first.
+   *
+   * @param input Input of all the steps.
+   * @param output Output of all the steps.
+   * @param gy Backpropagated error of the output of all the steps.
+   * @param g Error of the input of all the steps.
+   * @param gradient Gradient of the weights, summed over all the steps.
+   * @param steps Number of time steps in `input`.
+   */
+  virtual void BackwardSequence(const MatType& input,
+                                const MatType& output,
+                                const MatType& gy,
+                                MatType& g,
+                                MatType& gradient,
+                                const size_t steps);
+
   //! Get the current step index to use in a forward or backward pass.
   size_t CurrentStep() const { return currentStep; }
   //! Modify the current step index to use in a forward or backward pass.
@@ -67,6 +67,75 @@ RecurrentLayer<MatType>::operator=(RecurrentLayer&& other)
   return *this;
 }
 
+template<typename MatType>
+void RecurrentLayer<MatType>::ForwardSequence(const MatType& input,
+                                              MatType& output,
+                                              const size_t steps,
+                                              const bool storeSteps)
+{
+  const size_t batchSize = input.n_cols / steps;
+  const size_t firstStep = currentStep;
+
+  MatType inputAlias, outputAlias;
+  for (size_t s = 0; s < steps; ++s)
+  {
+    if (storeSteps)
+      currentStep = firstStep + s;
+
+    MakeAlias(inputAlias, (typename MatType::elem_type*)
+        input.colptr(s * batchSize), input.n_rows, batchSize);
+    MakeAlias(outputAlias, output.colptr(s * batchSize), output.n_rows,
+        batchSize);
+    this->Forward(inputAlias, outputAlias);
+
+    previousStep = currentStep;
+  }
+
+  currentStep = firstStep;
+}
+
+template<typename MatType>
+void RecurrentLayer<MatType>::BackwardSequence(const MatType& input,
+                                               const MatType& output,
+                                               const MatType& gy,
+                                               MatType& g,
+                                               MatType& gradient,
+                                               const size_t steps)
+{
+  const size_t batchSize = input.n_cols / steps;
+  const size_t firstStep = currentStep;
+  const size_t firstPreviousStep = previousStep;
+
+  // During the backward pass, the previous step is the one after the current
+  // step in time.
+  gradient.zeros();
+  MatType stepGradient(gradient.n_rows, gradient.n_cols);
+  MatType inputAlias, outputAlias, gyAlias, gAlias;
+  previousStep = size_t(-1);
+  for (size_t s = steps; s > 0; --s)
+  {
+    currentStep = firstStep + s - 1;
+
+    const size_t col = (s - 1) * batchSize;
+    MakeAlias(inputAlias, (typename MatType::elem_type*) input.colptr(col),
+        input.n_rows, batchSize);
+    MakeAlias(outputAlias, (typename MatType::elem_type*) output.colptr(col),
+        output.n_rows, batchSize);
+    MakeAlias(gyAlias, (typename MatType::elem_type*) gy.colptr(col),
+        gy.n_rows, batchSize);
+    MakeAlias(gAlias, g.colptr(col), g.n_rows, batchSize);
+
+    this->Backward(outputAlias, gyAlias, gAlias);
+    this->Gradient(inputAlias, gyAlias, stepGradient);
+    gradient += stepGradient;
+
+    previousStep = currentStep;
+  }
+
+  currentStep = firstStep;
+  previousStep = firstPreviousStep;
+}
+
 template<typename MatType>
 template<typename Archive>
 void RecurrentLayer<MatType>::serialize(
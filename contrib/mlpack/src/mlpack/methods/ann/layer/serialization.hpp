@@ -28,6 +28,12 @@
     CEREAL_REGISTER_TYPE(mlpack::ann::ElliotType<__VA_ARGS__>); \
     CEREAL_REGISTER_TYPE(mlpack::ann::ElishType<__VA_ARGS__>); \
     CEREAL_REGISTER_TYPE(mlpack::ann::GaussianType<__VA_ARGS__>); \
+    CEREAL_REGISTER_TYPE(mlpack::ann::FastSigmoidType<__VA_ARGS__>); \
+    CEREAL_REGISTER_TYPE(mlpack::ann::FastTanHType<__VA_ARGS__>); \
+    CEREAL_REGISTER_TYPE(mlpack::ann::FastSoftPlusType<__VA_ARGS__>); \
+    CEREAL_REGISTER_TYPE(mlpack::ann::FastSwishType<__VA_ARGS__>); \
+    CEREAL_REGISTER_TYPE(mlpack::ann::FastGELUType<__VA_ARGS__>); \
+    CEREAL_REGISTER_TYPE(mlpack::ann::FastMishType<__VA_ARGS__>); \
     /* (end of base_layer.hpp) */ \
     CEREAL_REGISTER_TYPE(mlpack::ann::ConcatenateType<__VA_ARGS__>); \
     CEREAL_REGISTER_TYPE(mlpack::ann::ConvolutionType< \
@@ -35,6 +41,11 @@
         mlpack::ann::NaiveConvolution<mlpack::ann::FullConvolution>, \
         mlpack::ann::NaiveConvolution<mlpack::ann::ValidConvolution>, \
         __VA_ARGS__>); \
+    CEREAL_REGISTER_TYPE(mlpack::ann::ConvolutionType< \
+        mlpack::ann::Im2ColConvolution<mlpack::ann::ValidConvolution>, \
+        mlpack::ann::Im2ColConvolution<mlpack::ann::FullConvolution>, \
+        mlpack::ann::Im2ColConvolution<mlpack::ann::ValidConvolution>, \
+        __VA_ARGS__>); \
     CEREAL_REGISTER_TYPE(mlpack::ann::DropConnectType<__VA_ARGS__>); \
     CEREAL_REGISTER_TYPE(mlpack::ann::DropoutType<__VA_ARGS__>); \
     CEREAL_REGISTER_TYPE(mlpack::ann::LeakyReLUType<__VA_ARGS__>); \
@@ -44,10 +55,14 @@
     CEREAL_REGISTER_TYPE(mlpack::ann::LogSoftMaxType<__VA_ARGS__>); \
     CEREAL_REGISTER_TYPE(mlpack::ann::LSTMType<__VA_ARGS__>); \
     CEREAL_REGISTER_TYPE(mlpack::ann::MaxPoolingType<__VA_ARGS__>); \
+    CEREAL_REGISTER_TYPE(mlpack::ann::MultiheadAttentionType<__VA_ARGS__>); \
     CEREAL_REGISTER_TYPE(mlpack::ann::NoisyLinearType<__VA_ARGS__>); \
     CEREAL_REGISTER_TYPE(mlpack::ann::PaddingType<__VA_ARGS__>); \
+    CEREAL_REGISTER_TYPE(mlpack::ann::QuantizedConvolutionType<__VA_ARGS__>); \
+    CEREAL_REGISTER_TYPE(mlpack::ann::QuantizedLinearType<__VA_ARGS__>); \
     CEREAL_REGISTER_TYPE(mlpack::ann::RBFType<__VA_ARGS__>); \
 
 CEREAL_REGISTER_MLPACK_LAYERS(arma::mat);
+CEREAL_REGISTER_MLPACK_LAYERS(arma::fmat);
 
 #endif
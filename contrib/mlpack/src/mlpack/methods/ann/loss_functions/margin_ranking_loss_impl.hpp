@@ -38,7 +38,8 @@ typename MatType::elem_type MarginRankingLossType<MatType>::Forward(
   const MatType& prediction2 = prediction.rows(predictionRows / 2,
       predictionRows - 1);
 
-  double lossSum = arma::accu(arma::max(arma::zeros(size(target)),
+  typename MatType::elem_type lossSum = arma::accu(arma::max(
+      arma::zeros<MatType>(size(target)),
       -target % (prediction1 - prediction2) + margin));
 
   if (reduction)
@@ -38,7 +38,7 @@ SigmoidCrossEntropyErrorType<MatType>::Forward(
   ElemType maximum = 0;
   for (size_t i = 0; i < prediction.n_elem; ++i)
   {
-    maximum += std::max(prediction[i], 0.0) +
+    maximum += std::max(prediction[i], ElemType(0)) +
         std::log(1 + std::exp(-std::abs(prediction[i])));
   }
 
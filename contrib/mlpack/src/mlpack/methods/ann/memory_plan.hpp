@@ -0,0 +1,159 @@
+/**
+ * @file methods/ann/memory_plan.hpp
+ *
+ * Definition of the MemoryPlan class, which decides where the outputs of the
+ * layers of a network are stored during training, and which of them are
+ * dropped and recomputed during the backward pass.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_MEMORY_PLAN_HPP
+#define MLPACK_METHODS_ANN_MEMORY_PLAN_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <mlpack/methods/ann/layer/layer.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * A MemoryPlan describes the activation memory of a sequence of layers (as
+ * held by a `MultiLayer`, and so by an `FFN`), per point of a batch:
+ *
+ *  - During the backward pass, the error of the input of a layer is only
+ *    needed until the previous layer has used it, so the errors of all layers
+ *    share two buffers, each large enough for the largest layer.
+ *  - During a forward pass that is not followed by a backward pass (i.e. for
+ *    prediction), the outputs of the layers share two buffers in the same way.
+ *  - During training, the outputs of all layers are kept for the backward pass,
+ *    unless a checkpoint interval `k` is given.  Then, only the outputs of
+ *    every `k`-th layer (the checkpoints) are kept; the outputs of the layers
+ *    in between share one buffer, and during the backward pass, they are
+ *    recomputed from the previous checkpoint, one segment at a time.  This
+ *    trades one extra forward pass for memory: with `k` close to the square
+ *    root of the number of layers, the memory for the outputs grows with the
+ *    square root of the depth of the network instead of linearly.
+ *
+ * The outputs of layers that draw random numbers in their `Forward()`
+ * (`Dropout`, `AlphaDropout` and `DropConnect`) or that hold a recurrent state
+ * are always kept, so that these layers are never recomputed.  All other layers
+ * must give the same output each time they are passed the same input for the
+ * recomputation to be exact.
+ *
+ * The output of the last layer is not part of the plan, since it is stored by
+ * the caller.
+ *
+ * @code
+ * FFN<> model;
+ * // ... add layers ...
+ * model.CheckpointInterval(4);
+ * const MemoryPlan<> plan = model.PlanMemory();
+ * std::cout << "Peak activation memory for batches of 256 points: "
+ *     << plan.PeakBytes(256) << " bytes (" << plan.UnplannedBytes(256)
+ *     << " bytes without planning)." << std::endl;
+ * @endcode
+ *
+ * @tparam MatType Matrix representation used by the layers.
+ */
+template<typename MatType = arma::mat>
+class MemoryPlan
+{
+ public:
+  //! Create an empty plan, for a network with no layers.
+  MemoryPlan();
+
+  /**
+   * Plan the memory of the given layers, which must have their input
+   * dimensions set.
+   *
+   * @param layers Layers of the network, in order.
+   * @param inputSize Number of elements of each input point.
+   * @param checkpointInterval Keep the output of every `checkpointInterval`-th
+   *     layer only, or of all layers if 0.
+   */
+  MemoryPlan(const std::vector<Layer<MatType>*>& layers,
+             const size_t inputSize,
+             const size_t checkpointInterval = 0);
+
+  //! Get whether the output of each layer is kept during the forward pass of
+  //! training.
+  const std::vector<bool>& Kept() const { return kept; }
+  //! Get the offset (in elements per point) of the output of each layer in the
+  //! output buffer used for training.
+  const std::vector<size_t>& Offsets() const { return offsets; }
+  //! Get the index of the first layer of the segment of each layer; the
+  //! outputs of the layers of a segment, except its last layer, are recomputed
+  //! together.
+  const std::vector<size_t>& SegmentStarts() const { return segmentStarts; }
+
+  //! Get the number of layers whose output is recomputed.
+  size_t NumRecomputed() const { return numRecomputed; }
+
+  //! Get the number of elements per point of the output buffer for training.
+  size_t OutputSize() const { return outputSize; }
+  //! Get the number of elements per point of the two error buffers.
+  size_t DeltaSize() const { return deltaSize; }
+  //! Get the number of elements per point of the two output buffers for
+  //! prediction.
+  size_t PredictionSize() const { return predictionSize; }
+  //! Get the number of elements per point that would be needed during training
+  //! without any planning (one buffer for each output and each error).
+  size_t UnplannedSize() const { return unplannedSize; }
+
+  //! Get the peak number of bytes of activation memory during training with
+  //! the given batch size.
+  size_t PeakBytes(const size_t batchSize) const
+  {
+    return (outputSize + deltaSize) * batchSize * sizeof(ElemType);
+  }
+  //! Get the number of bytes of activation memory during prediction with the
+  //! given batch size.
+  size_t PredictionBytes(const size_t batchSize) const
+  {
+    return predictionSize * batchSize * sizeof(ElemType);
+  }
+  //! Get the number of bytes of activation memory that training with the given
+  //! batch size would need without any planning.
+  size_t UnplannedBytes(const size_t batchSize) const
+  {
+    return unplannedSize * batchSize * sizeof(ElemType);
+  }
+
+ private:
+  typedef typename MatType::elem_type ElemType;
+
+  /**
+   * Return whether the given layer gives the same output each time it is passed
+   * the same input, so that its output can be recomputed.
+   */
+  static bool Recomputable(const Layer<MatType>* layer);
+
+  //! Whether the output of each layer is kept.
+  std::vector<bool> kept;
+  //! Offset of the output of each layer in the output buffer.
+  std::vector<size_t> offsets;
+  //! First layer of the segment of each layer.
+  std::vector<size_t> segmentStarts;
+  //! Number of layers whose output is recomputed.
+  size_t numRecomputed;
+  //! Elements per point of the output buffer for training.
+  size_t outputSize;
+  //! Elements per point of the error buffers.
+  size_t deltaSize;
+  //! Elements per point of the output buffers for prediction.
+  size_t predictionSize;
+  //! Elements per point without planning.
+  size_t unplannedSize;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "memory_plan_impl.hpp"
+
+#endif
@@ -0,0 +1,123 @@
+/**
+ * @file methods/ann/memory_plan_impl.hpp
+ *
+ * Implementation of the MemoryPlan class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_MEMORY_PLAN_IMPL_HPP
+#define MLPACK_METHODS_ANN_MEMORY_PLAN_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "memory_plan.hpp"
+
+#include <mlpack/methods/ann/layer/alpha_dropout.hpp>
+#include <mlpack/methods/ann/layer/dropconnect.hpp>
+#include <mlpack/methods/ann/layer/dropout.hpp>
+#include <mlpack/methods/ann/layer/recurrent_layer.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename MatType>
+MemoryPlan<MatType>::MemoryPlan() :
+    numRecomputed(0),
+    outputSize(0),
+    deltaSize(0),
+    predictionSize(0),
+    unplannedSize(0)
+{
+  // Nothing to do here.
+}
+
+template<typename MatType>
+MemoryPlan<MatType>::MemoryPlan(const std::vector<Layer<MatType>*>& layers,
+                                const size_t inputSize,
+                                const size_t checkpointInterval) :
+    kept(layers.size(), true),
+    offsets(layers.size(), 0),
+    segmentStarts(layers.size(), 0),
+    numRecomputed(0),
+    outputSize(0),
+    deltaSize(0),
+    predictionSize(0),
+    unplannedSize(0)
+{
+  const size_t n = layers.size();
+  if (n == 0)
+    return;
+
+  // First decide which outputs are kept.  The output of the last layer is held
+  // by the caller, so it is always kept.
+  std::vector<size_t> sizes(n);
+  size_t keptSize = 0, maxIntermediateSize = 0;
+  unplannedSize = inputSize;
+  for (size_t i = 0; i < n; ++i)
+  {
+    sizes[i] = layers[i]->OutputSize();
+    unplannedSize += sizes[i];
+    if (i == n - 1)
+      break;
+
+    // Every intermediate output is the input of the next layer too.
+    unplannedSize += sizes[i];
+    maxIntermediateSize = std::max(maxIntermediateSize, sizes[i]);
+
+    if (checkpointInterval != 0 && (i + 1) % checkpointInterval != 0 &&
+        Recomputable(layers[i]))
+    {
+      kept[i] = false;
+      ++numRecomputed;
+    }
+    else
+    {
+      offsets[i] = keptSize;
+      keptSize += sizes[i];
+    }
+  }
+
+  // The outputs that are not kept are placed after the kept outputs; each
+  // segment starts again at the beginning of that region.
+  size_t segmentStart = 0, segmentSize = 0, maxSegmentSize = 0;
+  for (size_t i = 0; i < n; ++i)
+  {
+    segmentStarts[i] = segmentStart;
+    if (kept[i])
+    {
+      segmentStart = i + 1;
+      segmentSize = 0;
+    }
+    else
+    {
+      offsets[i] = keptSize + segmentSize;
+      segmentSize += sizes[i];
+      maxSegmentSize = std::max(maxSegmentSize, segmentSize);
+    }
+  }
+
+  outputSize = keptSize + maxSegmentSize;
+
+  // At most two intermediate outputs (or errors of intermediate outputs) are
+  // needed at the same time when no backward pass follows (or during the
+  // backward pass).
+  const size_t buffers = std::min(n - 1, size_t(2));
+  deltaSize = buffers * maxIntermediateSize;
+  predictionSize = buffers * maxIntermediateSize;
+}
+
+template<typename MatType>
+bool MemoryPlan<MatType>::Recomputable(const Layer<MatType>* layer)
+{
+  return (dynamic_cast<const DropoutType<MatType>*>(layer) == nullptr) &&
+      (dynamic_cast<const AlphaDropoutType<MatType>*>(layer) == nullptr) &&
+      (dynamic_cast<const DropConnectType<MatType>*>(layer) == nullptr) &&
+      (dynamic_cast<const RecurrentLayer<MatType>*>(layer) == nullptr);
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
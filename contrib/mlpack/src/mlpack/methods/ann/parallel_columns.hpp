@@ -0,0 +1,108 @@
+/**
+ * @file methods/ann/parallel_columns.hpp
+ *
+ * Utilities to split the columns (points) of a batch across threads.  These are
+ * used by layers whose forward and backward passes are element-wise or
+ * per-point loops, and so get no parallelism from the BLAS.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_PARALLEL_COLUMNS_HPP
+#define MLPACK_METHODS_ANN_PARALLEL_COLUMNS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+namespace mlpack {
+namespace ann {
+
+/**
+ * Call `f(begin, end)` on contiguous blocks of the columns [0, nCols), one
+ * block per thread.  Batches with fewer than `minElements` elements in total
+ * are not worth the overhead of a parallel region, and are processed with a
+ * single call `f(0, nCols)` on the calling thread.
+ *
+ * @param nCols Number of columns (points in the batch).
+ * @param nRows Number of elements in each column.
+ * @param f Function called as f(begin, end) for the half-open range of columns
+ *     [begin, end).
+ * @param minElements Minimum number of elements to use more than one thread.
+ */
+template<typename FunctionType>
+void ParallelColumns(const size_t nCols,
+                     const size_t nRows,
+                     FunctionType&& f,
+                     const size_t minElements = 16384)
+{
+  size_t numBlocks = 1;
+  #ifdef HAS_OPENMP
+    if (nCols * nRows >= minElements && !omp_in_parallel())
+      numBlocks = std::min((size_t) omp_get_max_threads(), nCols);
+  #endif
+
+  if (numBlocks <= 1)
+  {
+    if (nCols > 0)
+      f(size_t(0), nCols);
+    return;
+  }
+
+  #pragma omp parallel for schedule(static, 1) num_threads(numBlocks)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = b * nCols / numBlocks;
+    const size_t end = (b + 1) * nCols / numBlocks;
+    if (end > begin)
+      f(begin, end);
+  }
+}
+
+/**
+ * Set the number of threads used by OpenMP parallel regions started from the
+ * calling thread for the lifetime of the object, and restore the previous
+ * value on destruction.  A thread count of 0 leaves the setting unchanged.
+ */
+class ScopedNumThreads
+{
+ public:
+  //! Use the given number of threads until the object is destroyed.
+  ScopedNumThreads(const size_t numThreads) : oldNumThreads(0)
+  {
+    #ifdef HAS_OPENMP
+      if (numThreads > 0)
+      {
+        oldNumThreads = omp_get_max_threads();
+        omp_set_num_threads((int) numThreads);
+      }
+    #else
+      (void) numThreads;
+    #endif
+  }
+
+  //! Restore the previous number of threads.
+  ~ScopedNumThreads()
+  {
+    #ifdef HAS_OPENMP
+      if (oldNumThreads > 0)
+        omp_set_num_threads(oldNumThreads);
+    #endif
+  }
+
+  ScopedNumThreads(const ScopedNumThreads&) = delete;
+  ScopedNumThreads& operator=(const ScopedNumThreads&) = delete;
+
+ private:
+  //! The number of threads to restore, or 0 if nothing was changed.
+  int oldNumThreads;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
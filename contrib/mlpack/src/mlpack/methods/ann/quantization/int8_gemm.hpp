@@ -0,0 +1,138 @@
+/**
+ * @file methods/ann/quantization/int8_gemm.hpp
+ *
+ * Kernels for the product of 8-bit integer matrices with 32-bit accumulation,
+ * used by the quantized layers.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_QUANTIZATION_INT8_GEMM_HPP
+#define MLPACK_METHODS_ANN_QUANTIZATION_INT8_GEMM_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#if defined(__AVX2__)
+  #include <immintrin.h>
+#endif
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Compute the dot product of two vectors of 8-bit integers, accumulated in
+ * 32-bit integers.  The kernel is chosen at compile time: with AVX-512 VNNI or
+ * AVX-VNNI, products are accumulated with `vpdpwssd`; with AVX2, with
+ * `vpmaddwd`; otherwise, a portable loop is used.  All kernels give exactly
+ * the same result.
+ *
+ * @param a First vector.
+ * @param b Second vector.
+ * @param n Number of elements of each vector.
+ */
+inline int32_t Int8Dot(const int8_t* a, const int8_t* b, const size_t n)
+{
+  size_t i = 0;
+  int32_t result = 0;
+
+#if defined(__AVX2__)
+  // Widen 16 elements of each vector to 16-bit integers, multiply them and add
+  // pairs of neighbouring products into eight 32-bit accumulators.
+  __m256i sum = _mm256_setzero_si256();
+  for (; i + 16 <= n; i += 16)
+  {
+    const __m256i x = _mm256_cvtepi8_epi16(
+        _mm_loadu_si128((const __m128i*) (a + i)));
+    const __m256i y = _mm256_cvtepi8_epi16(
+        _mm_loadu_si128((const __m128i*) (b + i)));
+  #if defined(__AVX512VNNI__) && defined(__AVX512VL__)
+    sum = _mm256_dpwssd_epi32(sum, x, y);
+  #elif defined(__AVXVNNI__)
+    sum = _mm256_dpwssd_avx_epi32(sum, x, y);
+  #else
+    sum = _mm256_add_epi32(sum, _mm256_madd_epi16(x, y));
+  #endif
+  }
+
+  __m128i half = _mm_add_epi32(_mm256_castsi256_si128(sum),
+      _mm256_extracti128_si256(sum, 1));
+  half = _mm_hadd_epi32(half, half);
+  half = _mm_hadd_epi32(half, half);
+  result = _mm_cvtsi128_si32(half);
+#endif
+
+  for (; i < n; ++i)
+    result += int32_t(a[i]) * int32_t(b[i]);
+
+  return result;
+}
+
+/**
+ * Compute C = A^T B for 8-bit integer matrices A (k x m) and B (k x n), stored
+ * column-major, into the 32-bit integer matrix C (m x n), also column-major.
+ * So, element (i, j) of C is the dot product of column i of A and column j of
+ * B; both are contiguous in memory.  For a layer, A holds one filter (or one
+ * row of the weight matrix) per column, and B holds one input per column.
+ *
+ * Large products are computed in parallel with OpenMP.
+ *
+ * @param a Matrix A (k x m).
+ * @param b Matrix B (k x n).
+ * @param c Matrix C (m x n), which is overwritten.
+ * @param m Number of columns of A.
+ * @param n Number of columns of B.
+ * @param k Number of rows of A and B.
+ */
+inline void Int8Gemm(const int8_t* a,
+                     const int8_t* b,
+                     int32_t* c,
+                     const size_t m,
+                     const size_t n,
+                     const size_t k)
+{
+  // Each task computes a block of rows of one column of C, so that a single
+  // input (as in a batch of one point) is still split across threads.
+  const size_t blockRows = 64;
+  const size_t blocksPerColumn = (m + blockRows - 1) / blockRows;
+  const size_t tasks = blocksPerColumn * n;
+
+  #pragma omp parallel for schedule(static) if (m * n * k >= 65536)
+  for (omp_size_t t = 0; t < (omp_size_t) tasks; ++t)
+  {
+    const size_t j = t / blocksPerColumn;
+    const size_t begin = (t % blocksPerColumn) * blockRows;
+    const size_t end = std::min(begin + blockRows, m);
+    for (size_t i = begin; i < end; ++i)
+      c[i + j * m] = Int8Dot(a + i * k, b + j * k, k);
+  }
+}
+
+/**
+ * Quantize the given values symmetrically to 8-bit integers: each value x is
+ * mapped to round(x / scale), clamped to [-127, 127].
+ *
+ * @param input Values to quantize.
+ * @param n Number of values.
+ * @param scale Scale of the quantized values (must be positive).
+ * @param output Quantized values.
+ */
+template<typename eT>
+inline void QuantizeInt8(const eT* input,
+                         const size_t n,
+                         const eT scale,
+                         int8_t* output)
+{
+  const eT inverseScale = 1 / scale;
+  for (size_t i = 0; i < n; ++i)
+  {
+    const eT x = std::round(input[i] * inverseScale);
+    output[i] = (int8_t) std::min(std::max(x, eT(-127)), eT(127));
+  }
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
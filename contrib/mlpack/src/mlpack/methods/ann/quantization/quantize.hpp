@@ -0,0 +1,110 @@
+/**
+ * @file methods/ann/quantization/quantize.hpp
+ *
+ * Post-training quantization of feedforward networks: replace the Linear,
+ * LinearNoBias and Convolution layers of a trained network with their 8-bit
+ * integer versions, and compare the accuracy of the result with the original
+ * network.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_QUANTIZATION_QUANTIZE_HPP
+#define MLPACK_METHODS_ANN_QUANTIZATION_QUANTIZE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <mlpack/methods/ann/ffn.hpp>
+#include <mlpack/methods/ann/layer/convolution.hpp>
+#include <mlpack/methods/ann/layer/linear.hpp>
+#include <mlpack/methods/ann/layer/linear_no_bias.hpp>
+#include <mlpack/methods/ann/layer/quantized_convolution.hpp>
+#include <mlpack/methods/ann/layer/quantized_linear.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Quantize a trained network for inference.  Every `Linear` and `LinearNoBias`
+ * layer (without regularization) and every `Convolution` layer (with the
+ * default `Im2ColConvolution` rules) is replaced by a `QuantizedLinear` or
+ * `QuantizedConvolution` layer, which holds its weights as 8-bit integers with
+ * one scale per output unit or map.  All other layers are kept as they are,
+ * with their weights.
+ *
+ * The inputs of the quantized layers are quantized too, with one fixed scale
+ * per layer.  These scales are calibrated by running the original network on
+ * the given calibration data (in testing mode) and recording the largest
+ * absolute value seen at the input of each layer, so the calibration data
+ * should be a representative sample of the data the network will be used on.
+ *
+ * The quantized network can be used with `Predict()`, serialized and compiled
+ * with `CompileForInference()`, but it can't be trained any further.  Use
+ * `CompareQuantized()` on a copy of the original network to check that the
+ * loss of accuracy is acceptable.
+ *
+ * @code
+ * FFN<> model;
+ * // ... build and train the model ...
+ * FFN<> quantizedModel(model);
+ * Quantize(quantizedModel, calibrationData);
+ * QuantizationReport report = CompareQuantized(model, quantizedModel,
+ *     testData);
+ * @endcode
+ *
+ * @param network Trained network to quantize.
+ * @param calibrationData Sample of inputs used to calibrate the input scales.
+ * @param batchSize Number of points of the calibration data processed at once.
+ */
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+void Quantize(FFN<OutputLayerType, InitializationRuleType, MatType>& network,
+              const MatType& calibrationData,
+              const size_t batchSize = 128);
+
+/**
+ * Differences between the predictions of a network and of its quantized
+ * version, as computed by `CompareQuantized()`.
+ */
+struct QuantizationReport
+{
+  //! Largest absolute difference between two elements of the predictions.
+  double maxAbsoluteError;
+  //! Mean absolute difference between the elements of the predictions.
+  double meanAbsoluteError;
+  //! Frobenius norm of the difference of the predictions, divided by the
+  //! Frobenius norm of the predictions of the original network.
+  double relativeError;
+  //! Fraction of points for which the largest element of the prediction (i.e.
+  //! the predicted class, for a classifier) is in the same row.
+  double agreement;
+};
+
+/**
+ * Compare the predictions of a network with the predictions of its quantized
+ * version (or any other network with the same input and output sizes) on the
+ * given data.
+ *
+ * @param network Original network.
+ * @param quantizedNetwork Quantized network.
+ * @param data Points to predict, one per column.
+ * @param batchSize Batch size to use for prediction.
+ */
+template<typename NetworkType,
+         typename QuantizedNetworkType,
+         typename MatType>
+QuantizationReport CompareQuantized(NetworkType& network,
+                                    QuantizedNetworkType& quantizedNetwork,
+                                    const MatType& data,
+                                    const size_t batchSize = 128);
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "quantize_impl.hpp"
+
+#endif
@@ -0,0 +1,189 @@
+/**
+ * @file methods/ann/quantization/quantize_impl.hpp
+ *
+ * Implementation of post-training quantization of feedforward networks.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_QUANTIZATION_QUANTIZE_IMPL_HPP
+#define MLPACK_METHODS_ANN_QUANTIZATION_QUANTIZE_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "quantize.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Return a quantized copy of the given layer, with the given input scale, or
+ * nullptr if the layer can't be quantized.
+ */
+template<typename MatType>
+Layer<MatType>* QuantizeLayer(Layer<MatType>* layer, const double inputScale)
+{
+  typedef ConvolutionType<
+      Im2ColConvolution<ValidConvolution>,
+      Im2ColConvolution<FullConvolution>,
+      Im2ColConvolution<ValidConvolution>,
+      MatType
+  > Im2ColConvolutionLayer;
+
+  if (LinearType<MatType, NoRegularizer>* linear =
+      dynamic_cast<LinearType<MatType, NoRegularizer>*>(layer))
+  {
+    return new QuantizedLinearType<MatType>(linear->Weight(), linear->Bias(),
+        inputScale);
+  }
+  else if (LinearNoBiasType<MatType, NoRegularizer>* linearNoBias =
+      dynamic_cast<LinearNoBiasType<MatType, NoRegularizer>*>(layer))
+  {
+    return new QuantizedLinearType<MatType>(linearNoBias->Parameters(),
+        MatType(), inputScale);
+  }
+  else if (Im2ColConvolutionLayer* conv =
+      dynamic_cast<Im2ColConvolutionLayer*>(layer))
+  {
+    return new QuantizedConvolutionType<MatType>(conv->Weight(), conv->Bias(),
+        conv->Maps(), conv->StrideWidth(), conv->StrideHeight(),
+        conv->PadWLeft(), conv->PadWRight(), conv->PadHTop(),
+        conv->PadHBottom(), inputScale);
+  }
+
+  return nullptr;
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+void Quantize(FFN<OutputLayerType, InitializationRuleType, MatType>& network,
+              const MatType& calibrationData,
+              const size_t batchSize)
+{
+  typedef typename MatType::elem_type ElemType;
+
+  if (calibrationData.n_cols == 0)
+  {
+    throw std::invalid_argument("Quantize(): no calibration data given!");
+  }
+
+  // Predicting the first point sets up the network in testing mode, with its
+  // dimensions and weights; this also checks the size of the data.
+  MatType firstPrediction;
+  network.Predict(calibrationData.col(0), firstPrediction);
+
+  // Record the largest absolute value at the input of each layer.  Only the
+  // const accessor is used here, so that the network stays set up.
+  const std::vector<Layer<MatType>*>& layers =
+      static_cast<const FFN<OutputLayerType, InitializationRuleType, MatType>&>(
+      network).Network();
+  std::vector<ElemType> ranges(layers.size(), 0);
+  const size_t step = std::max(batchSize, size_t(1));
+  for (size_t begin = 0; begin < calibrationData.n_cols; begin += step)
+  {
+    const size_t end = std::min(begin + step, (size_t) calibrationData.n_cols);
+    MatType current = calibrationData.cols(begin, end - 1);
+    for (size_t l = 0; l < layers.size(); ++l)
+    {
+      ranges[l] = std::max(ranges[l], (ElemType) arma::abs(current).max());
+
+      MatType next(layers[l]->OutputSize(), current.n_cols);
+      layers[l]->Forward(current, next);
+      current = std::move(next);
+    }
+  }
+
+  // Replace the layers that can be quantized, and collect the weights of the
+  // other layers, in order, into the new parameters of the network.  The
+  // largest input value of each layer is mapped to 127.
+  const MatType oldParameters = network.Parameters();
+  std::vector<Layer<MatType>*>& mutableLayers = network.Network();
+  std::vector<std::pair<size_t, size_t>> keptWeights;
+  size_t offset = 0, newWeightSize = 0;
+  for (size_t l = 0; l < mutableLayers.size(); ++l)
+  {
+    const size_t weightSize = mutableLayers[l]->WeightSize();
+    Layer<MatType>* quantized = QuantizeLayer(mutableLayers[l],
+        double(ranges[l]) / 127);
+    if (quantized != nullptr)
+    {
+      quantized->InputDimensions() = mutableLayers[l]->InputDimensions();
+      quantized->OutputDimensions();
+
+      delete mutableLayers[l];
+      mutableLayers[l] = quantized;
+    }
+    else if (weightSize > 0)
+    {
+      keptWeights.push_back(std::make_pair(offset, weightSize));
+      newWeightSize += weightSize;
+    }
+
+    offset += weightSize;
+  }
+
+  MatType newParameters(newWeightSize, 1);
+  size_t newOffset = 0;
+  for (const std::pair<size_t, size_t>& kept : keptWeights)
+  {
+    newParameters.rows(newOffset, newOffset + kept.second - 1) =
+        oldParameters.rows(kept.first, kept.first + kept.second - 1);
+    newOffset += kept.second;
+  }
+
+  network.Parameters() = std::move(newParameters);
+}
+
+template<typename NetworkType,
+         typename QuantizedNetworkType,
+         typename MatType>
+QuantizationReport CompareQuantized(NetworkType& network,
+                                    QuantizedNetworkType& quantizedNetwork,
+                                    const MatType& data,
+                                    const size_t batchSize)
+{
+  MatType predictions, quantizedPredictions;
+  network.Predict(data, predictions, batchSize);
+  quantizedNetwork.Predict(data, quantizedPredictions, batchSize);
+
+  if (predictions.n_rows != quantizedPredictions.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "CompareQuantized(): networks have different output sizes ("
+        << predictions.n_rows << " and " << quantizedPredictions.n_rows
+        << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  QuantizationReport report;
+  const MatType difference = arma::abs(quantizedPredictions - predictions);
+  report.maxAbsoluteError = difference.is_empty() ? 0.0 :
+      (double) difference.max();
+  report.meanAbsoluteError = difference.is_empty() ? 0.0 :
+      (double) arma::accu(difference) / difference.n_elem;
+
+  const double norm = arma::norm(predictions, "fro");
+  const double differenceNorm = arma::norm(difference, "fro");
+  report.relativeError = (norm > 0) ? differenceNorm / norm : differenceNorm;
+
+  size_t agreeing = 0;
+  for (size_t i = 0; i < predictions.n_cols; ++i)
+  {
+    if (predictions.col(i).index_max() ==
+        quantizedPredictions.col(i).index_max())
+    {
+      ++agreeing;
+    }
+  }
+  report.agreement = (predictions.n_cols == 0) ? 1.0 :
+      double(agreeing) / predictions.n_cols;
+
+  return report;
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
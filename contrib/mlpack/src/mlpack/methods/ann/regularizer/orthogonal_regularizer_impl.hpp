@@ -27,7 +27,8 @@ OrthogonalRegularizer::OrthogonalRegularizer(double factor) :
 template<typename MatType>
 void OrthogonalRegularizer::Evaluate(const MatType& weight, MatType& gradient)
 {
-  arma::mat grad = arma::zeros(arma::size(weight));
+  typedef typename MatType::elem_type ElemType;
+  MatType grad = arma::zeros<MatType>(arma::size(weight));
 
   for (size_t i = 0; i < weight.n_rows; ++i)
   {
@@ -35,14 +36,14 @@ void OrthogonalRegularizer::Evaluate(const MatType& weight, MatType& gradient)
     {
       if (i == j)
       {
-        double s =
+        ElemType s =
             arma::as_scalar(
             arma::sign((weight.row(i) * weight.row(i).t()) - 1));
         grad.row(i) += 2 * s * weight.row(i);
       }
       else
       {
-        double s = arma::as_scalar(
+        ElemType s = arma::as_scalar(
             arma::sign(weight.row(i) * weight.row(j).t()));
         grad.row(i) += s * weight.row(j);
         grad.row(j) += s * weight.row(i);
@@ -359,6 +359,47 @@ class RNN
   //! Set the current step index of all recurrent layers to `step`.
   void SetCurrentStep(const size_t step);
 
+  /**
+   * Pass the time steps `firstStep` to `firstStep + steps - 1` of the points
+   * `begin` to `begin + batchSize - 1` of `data` forward through the network,
+   * one layer at a time: each layer is given all the time steps at once (with
+   * `RecurrentLayer::ForwardSequence()` for recurrent layers), so that the
+   * matrix products of non-recurrent layers and the input projections of
+   * recurrent layers are done for all time steps together.  The output of each
+   * layer is held in `layerOutputs`, with one block of `batchSize` columns per
+   * time step.
+   *
+   * The recurrent layers continue from their `PreviousStep()`, and store the
+   * steps starting at their `CurrentStep()` if `storeSteps` is true.
+   */
+  void ForwardSteps(const arma::Cube<typename MatType::elem_type>& data,
+                    const size_t begin,
+                    const size_t batchSize,
+                    const size_t firstStep,
+                    const size_t steps,
+                    const bool storeSteps);
+
+  /**
+   * Backpropagate the given error of the output of the last call to
+   * `ForwardSteps()` (which must have stored its `steps` time steps) through
+   * the network, one layer at a time, and store the gradient of the parameters
+   * in `gradient`.
+   */
+  void BackwardSteps(const MatType& error,
+                     MatType& gradient,
+                     const size_t steps);
+
+  /**
+   * Compute the loss of the output of the last call to `ForwardSteps()` (for
+   * the time steps `firstStep` to `firstStep + steps - 1`).  If `error` is
+   * given, it is filled with the error of the output.
+   */
+  typename MatType::elem_type OutputLoss(const size_t begin,
+                                         const size_t batchSize,
+                                         const size_t firstStep,
+                                         const size_t steps,
+                                         MatType* error = nullptr);
+
   //! Number of timesteps to consider for backpropagation through time (BPTT).
   size_t bpttSteps;
   //! Whether the network expects only one single response per sequence, or one
@@ -378,6 +419,19 @@ class RNN
   //! The matrix of responses to the input data points.  This member is empty,
   //! except during training.
   arma::Cube<typename MatType::elem_type> responses;
+
+  //! The input of the time steps passed to `ForwardSteps()`.  This is an alias
+  //! of the data, or of `stepInputData` if the data had to be gathered.
+  MatType stepInput;
+
+  //! Storage for the gathered input of the time steps.
+  MatType stepInputData;
+
+  //! The output of each layer for the time steps passed to `ForwardSteps()`.
+  std::vector<MatType> layerOutputs;
+
+  //! The error of the input of each layer, computed by `BackwardSteps()`.
+  std::vector<MatType> layerDeltas;
 }; // class RNNType
 
 } // namespace ann
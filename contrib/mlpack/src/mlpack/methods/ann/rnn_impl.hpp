@@ -220,7 +220,6 @@ void RNN<
   results.set_size(network.network.OutputSize(), predictors.n_cols,
       predictors.n_slices);
 
-  MatType inputAlias, outputAlias;
   for (size_t i = 0; i < predictors.n_cols; i += batchSize)
   {
     const size_t effectiveBatchSize = std::min(batchSize,
@@ -232,21 +231,15 @@ void RNN<
     SetPreviousStep(size_t(-1));
     SetCurrentStep(size_t(0));
 
-    // Iterate over all time steps.
+    // Pass all time steps through the network at once.
+    ForwardSteps(predictors, i, effectiveBatchSize, 0, predictors.n_slices,
+        false);
+
+    const MatType& output = layerOutputs.back();
     for (size_t t = 0; t < predictors.n_slices; ++t)
     {
-      // If it is after the first step, we have a previous state.
-      if (t == 1)
-        SetPreviousStep(size_t(0));
-
-      // Create aliases for the input and output.
-      MakeAlias(inputAlias,
-          (typename MatType::elem_type*) predictors.slice(t).colptr(i),
-          predictors.n_rows, effectiveBatchSize);
-      MakeAlias(outputAlias, results.slice(t).colptr(i), results.n_rows,
-          effectiveBatchSize);
-
-      network.Forward(inputAlias, outputAlias);
+      results.slice(t).cols(i, i + effectiveBatchSize - 1) = output.cols(
+          t * effectiveBatchSize, (t + 1) * effectiveBatchSize - 1);
     }
   }
 }
@@ -327,25 +320,14 @@ typename MatType::elem_type RNN<
   ResetMemoryState(1, batchSize);
   SetCurrentStep(0);
   SetPreviousStep(size_t(-1));
-  MatType output(network.network.OutputSize(), batchSize);
-
-  typename MatType::elem_type loss = 0.0;
-  MatType stepData, responseData;
-  for (size_t t = 0; t < predictors.n_slices; ++t)
-  {
-    if (t == 1)
-      SetPreviousStep(0);
 
-    // Manually reset the data of the network to be an alias of the current time
-    // step.
-    MakeAlias(network.predictors, predictors.slice(t).colptr(begin),
-        predictors.n_rows, batchSize);
-    const size_t responseStep = (single) ? 0 : t;
-    MakeAlias(network.responses, responses.slice(responseStep).colptr(begin),
-        responses.n_rows, batchSize);
+  ForwardSteps(predictors, begin, batchSize, 0, predictors.n_slices, false);
+  typename MatType::elem_type loss = OutputLoss(begin, batchSize, 0,
+      predictors.n_slices);
 
-    loss += network.Evaluate(output, begin, batchSize);
-  }
+  // Add loss (this is not dependent on time steps, and should only be added
+  // once).
+  loss += network.network.Loss();
 
   return loss;
 }
@@ -385,115 +367,52 @@ typename MatType::elem_type RNN<
 {
   network.CheckNetwork("RNN::EvaluateWithGradient()", predictors.n_rows);
 
-  typename MatType::elem_type loss = 0;
-
   // We must save anywhere between 1 and `bpttSteps` states, but we are limited
   // by `predictors.n_slices`.
   const size_t effectiveBPTTSteps = std::max(size_t(1),
       std::min(bpttSteps, size_t(predictors.n_slices)));
+  const size_t extraSteps = predictors.n_slices - effectiveBPTTSteps;
 
-  ResetMemoryState(effectiveBPTTSteps, batchSize);
+  // The state after the time steps that BPTT never goes back to is kept in the
+  // extra memory cell `effectiveBPTTSteps`.
+  ResetMemoryState(effectiveBPTTSteps + 1, batchSize);
+  SetCurrentStep(effectiveBPTTSteps);
   SetPreviousStep(size_t(-1));
-  arma::Cube<typename MatType::elem_type> outputs(
-      network.network.OutputSize(), batchSize, effectiveBPTTSteps);
 
   // If `bpttSteps` is less than the number of time steps in the data, then for
   // the first few steps, we won't actually need to hold onto any historical
-  // information, since BPTT will never go back that far.
-  const size_t extraSteps = (predictors.n_slices - effectiveBPTTSteps + 1);
-  MatType stepData, outputData, responseData;
-  for (size_t t = 0; t < std::min(size_t(predictors.n_slices), extraSteps); ++t)
+  // information.  These steps are passed through the network in chunks of at
+  // most `effectiveBPTTSteps` time steps, so that the memory used doesn't grow
+  // with the length of the sequences.
+  typename MatType::elem_type loss = 0;
+  for (size_t t = 0; t < extraSteps; t += effectiveBPTTSteps)
   {
-    SetCurrentStep(0);
-
-    // Make an alias of the step's data.
-    MakeAlias(stepData, predictors.slice(t).colptr(begin), predictors.n_rows,
-        batchSize);
-    MakeAlias(outputData, outputs.slice(t).memptr(), outputs.n_rows,
-        outputs.n_cols);
-    network.network.Forward(stepData, outputData);
-
-    const size_t responseStep = (single) ? 0 : t;
-    MakeAlias(responseData, responses.slice(responseStep).colptr(begin),
-        responses.n_rows, batchSize);
-
-    loss += network.outputLayer.Forward(outputData, responseData);
-
-    SetPreviousStep(0);
+    const size_t steps = std::min(effectiveBPTTSteps, extraSteps - t);
+    ForwardSteps(predictors, begin, batchSize, t, steps, false);
+    loss += OutputLoss(begin, batchSize, t, steps);
   }
 
   // Next, we reach the time steps that will be used for BPTT, for which we must
   // preserve step data.
-  for (size_t t = extraSteps; t < predictors.n_slices; ++t)
-  {
-    SetCurrentStep(t - extraSteps + 1);
-
-    // Wrap a matrix around our data to avoid a copy.
-    MakeAlias(stepData, predictors.slice(t).colptr(begin), predictors.n_rows,
-        batchSize);
-    MakeAlias(outputData, outputs.slice(t).memptr(), outputs.n_rows,
-        outputs.n_cols);
-    network.network.Forward(stepData, outputData);
-
-    const size_t responseStep = (single) ? 0 : t;
-    MakeAlias(responseData, responses.slice(responseStep).colptr(begin),
-        responses.n_rows, batchSize);
-
-    loss += network.outputLayer.Forward(outputData, responseData);
+  SetCurrentStep(0);
+  ForwardSteps(predictors, begin, batchSize, extraSteps, effectiveBPTTSteps,
+      true);
 
-    SetPreviousStep(t - extraSteps + 1);
-  }
+  // Set up the error by backpropagating through the output layer.  Note that
+  // if we are in 'single' mode, we don't care what the network outputs until
+  // the input sequence is done, so there is no error for any other time step.
+  MatType error;
+  loss += OutputLoss(begin, batchSize, extraSteps, effectiveBPTTSteps, &error);
 
   // Add loss (this is not dependent on time steps, and should only be added
   // once).
   loss += network.network.Loss();
 
-  // Initialize current/working gradient.
+  // Now pass that error backwards through the network.
   gradient.zeros(network.Parameters().n_rows, network.Parameters().n_cols);
-  GradType currentGradient;
-  currentGradient.zeros(network.Parameters().n_rows,
-      network.Parameters().n_cols);
-
-  SetPreviousStep(size_t(-1));
-  const size_t minStep = predictors.n_slices - effectiveBPTTSteps + 1;
-  for (size_t t = predictors.n_slices; t >= minStep; --t)
-  {
-    SetCurrentStep(t - 1);
-
-    currentGradient.zeros();
-    MatType error(outputs.n_rows, outputs.n_cols);
-
-    // Set up the response by backpropagating through the output layer.  Note
-    // that if we are in 'single' mode, we don't care what the network outputs
-    // until the input sequence is done, so there is no error for any timestep
-    // other than the first one.
-    if (single && (t - 1) < responses.n_slices - 1)
-    {
-      error.zeros();
-    }
-    else
-    {
-      MakeAlias(outputData, outputs.slice(t - 1).colptr(0), outputs.n_rows,
-          outputs.n_cols);
-      const size_t respStep = (single) ? 0 : t - 1;
-      MakeAlias(responseData, responses.slice(respStep).colptr(begin),
-          responses.n_rows, batchSize);
-      network.outputLayer.Backward(outputData, responseData, error);
-    }
-
-    // Now pass that error backwards through the network.
-    MakeAlias(outputData, outputs.slice(t - 1).colptr(0), outputs.n_rows,
-        outputs.n_cols);
-    MatType networkDelta;
-    network.network.Backward(outputData, error, networkDelta);
-
-    MakeAlias(stepData, predictors.slice(t - 1).colptr(begin),
-        predictors.n_rows, batchSize);
-    network.network.Gradient(stepData, error, currentGradient);
-    gradient += currentGradient;
-
-    SetPreviousStep(t - 1);
-  }
+  SetCurrentStep(0);
+  SetPreviousStep((extraSteps > 0) ? effectiveBPTTSteps : size_t(-1));
+  BackwardSteps(error, gradient, effectiveBPTTSteps);
 
   return loss;
 }
@@ -614,6 +533,156 @@ void RNN<
   }
 }
 
+template<
+    typename OutputLayerType,
+    typename InitializationRuleType,
+    typename MatType
+>
+void RNN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::ForwardSteps(
+    const arma::Cube<typename MatType::elem_type>& data,
+    const size_t begin,
+    const size_t batchSize,
+    const size_t firstStep,
+    const size_t steps,
+    const bool storeSteps)
+{
+  // Gather the input of all the time steps into one matrix, with one block of
+  // columns per time step.  When the batch is the whole dataset, the slices of
+  // the cube already have this layout.
+  if (begin == 0 && batchSize == data.n_cols)
+  {
+    MakeAlias(stepInput,
+        (typename MatType::elem_type*) data.slice_memptr(firstStep),
+        data.n_rows, batchSize * steps);
+  }
+  else
+  {
+    stepInputData.set_size(data.n_rows, batchSize * steps);
+    for (size_t s = 0; s < steps; ++s)
+    {
+      stepInputData.cols(s * batchSize, (s + 1) * batchSize - 1) =
+          data.slice(firstStep + s).cols(begin, begin + batchSize - 1);
+    }
+    MakeAlias(stepInput, stepInputData.memptr(), stepInputData.n_rows,
+        stepInputData.n_cols);
+  }
+
+  const std::vector<Layer<MatType>*>& layers = network.Network();
+  layerOutputs.resize(layers.size());
+  for (size_t l = 0; l < layers.size(); ++l)
+  {
+    // Make sure training/testing mode is set right in each layer.
+    layers[l]->Training() = network.network.Training();
+
+    const MatType& input = (l == 0) ? stepInput : layerOutputs[l - 1];
+    layerOutputs[l].set_size(layers[l]->OutputSize(), input.n_cols);
+
+    RecurrentLayer<MatType>* r =
+        dynamic_cast<RecurrentLayer<MatType>*>(layers[l]);
+    if (r != nullptr)
+      r->ForwardSequence(input, layerOutputs[l], steps, storeSteps);
+    else
+      layers[l]->Forward(input, layerOutputs[l]);
+  }
+}
+
+template<
+    typename OutputLayerType,
+    typename InitializationRuleType,
+    typename MatType
+>
+void RNN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::BackwardSteps(
+    const MatType& error,
+    MatType& gradient,
+    const size_t steps)
+{
+  const std::vector<Layer<MatType>*>& layers = network.Network();
+  layerDeltas.resize(layers.size());
+
+  // The gradient of each layer is an alias of its part of `gradient`.
+  MatType layerGradient;
+  size_t gradientEnd = gradient.n_elem;
+  for (size_t l = layers.size(); l > 0; --l)
+  {
+    Layer<MatType>* layer = layers[l - 1];
+    const MatType& input = (l == 1) ? stepInput : layerOutputs[l - 2];
+    const MatType& gy = (l == layers.size()) ? error : layerDeltas[l];
+
+    const size_t weightSize = layer->WeightSize();
+    gradientEnd -= weightSize;
+    MakeAlias(layerGradient, gradient.memptr() + gradientEnd, weightSize, 1);
+
+    layerDeltas[l - 1].set_size(input.n_rows, input.n_cols);
+    RecurrentLayer<MatType>* r = dynamic_cast<RecurrentLayer<MatType>*>(layer);
+    if (r != nullptr)
+    {
+      r->BackwardSequence(input, layerOutputs[l - 1], gy, layerDeltas[l - 1],
+          layerGradient, steps);
+    }
+    else
+    {
+      layer->Backward(layerOutputs[l - 1], gy, layerDeltas[l - 1]);
+      layer->Gradient(input, gy, layerGradient);
+    }
+  }
+}
+
+template<
+    typename OutputLayerType,
+    typename InitializationRuleType,
+    typename MatType
+>
+typename MatType::elem_type RNN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::OutputLoss(
+    const size_t begin,
+    const size_t batchSize,
+    const size_t firstStep,
+    const size_t steps,
+    MatType* error)
+{
+  const MatType& output = layerOutputs.back();
+  if (error != nullptr)
+    error->zeros(output.n_rows, output.n_cols);
+
+  typename MatType::elem_type loss = 0;
+  MatType outputData, responseData, errorData;
+  for (size_t s = 0; s < steps; ++s)
+  {
+    // In 'single' mode, only the last time step has a response.
+    const size_t t = firstStep + s;
+    if (single && t != predictors.n_slices - 1)
+      continue;
+
+    MakeAlias(outputData,
+        (typename MatType::elem_type*) output.colptr(s * batchSize),
+        output.n_rows, batchSize);
+    const size_t responseStep = (single) ? 0 : t;
+    MakeAlias(responseData, responses.slice(responseStep).colptr(begin),
+        responses.n_rows, batchSize);
+
+    loss += network.outputLayer.Forward(outputData, responseData);
+    if (error != nullptr)
+    {
+      MakeAlias(errorData, error->colptr(s * batchSize), error->n_rows,
+          batchSize);
+      network.outputLayer.Backward(outputData, responseData, errorData);
+    }
+  }
+
+  return loss;
+}
+
 } // namespace ann
 } // namespace mlpack
 
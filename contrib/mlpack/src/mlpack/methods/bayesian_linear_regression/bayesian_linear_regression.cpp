@@ -12,6 +12,7 @@
 #include "bayesian_linear_regression.hpp"
 #include <mlpack/core/util/log.hpp>
 #include <mlpack/core/util/timers.hpp>
+#include <mlpack/core/util/size_checks.hpp>
 
 using namespace mlpack;
 using namespace mlpack::regression;
@@ -33,15 +34,59 @@ BayesianLinearRegression::BayesianLinearRegression(const bool centerData,
 double BayesianLinearRegression::Train(const arma::mat& data,
                                        const arma::rowvec& responses)
 {
-  arma::mat phi;
-  arma::rowvec t;
-  arma::colvec eigVal;
-  arma::mat eigVec;
+  util::CheckSameSizes(data, responses, "BayesianLinearRegression::Train()");
+
+  // Accumulate the statistics relative to the exact means, so that they are
+  // as accurate as if the data had been centered first.
+  NormalEquations equations(data.n_rows, arma::mean(data, 1),
+      arma::mean(responses));
+  equations.Accumulate(data, responses);
 
-  // Preprocess the data. Center and scale.
-  responsesOffset = CenterScaleData(data, responses, phi, t);
+  return Train(equations, &data, &responses);
+}
+
+double BayesianLinearRegression::Train(const NormalEquations& equations)
+{
+  return Train(equations, NULL, NULL);
+}
 
-  if (!arma::eig_sym(eigVal, eigVec, arma::symmatu(phi * phi.t())))
+double BayesianLinearRegression::Train(const NormalEquations& equations,
+                                       const arma::mat* data,
+                                       const arma::rowvec* responses)
+{
+  const double n = (double) equations.NumPoints();
+
+  // The centered and scaled data phi and responses t are never formed; we only
+  // need phi * phi^T, phi * t^T and t * t^T, which follow from the statistics.
+  arma::mat phiPhiT;
+  arma::colvec phiT;
+  double tT;
+  if (centerData)
+  {
+    dataOffset = equations.Mean();
+    responsesOffset = equations.ResponseMean();
+    phiPhiT = equations.CenteredScatter();
+    phiT = equations.CenteredCross();
+    tT = equations.CenteredResponseSquares();
+  }
+  else
+  {
+    responsesOffset = 0.0;
+    phiPhiT = equations.RawScatter();
+    phiT = equations.RawCross();
+    tT = equations.RawResponseSquares();
+  }
+
+  if (scaleData)
+  {
+    dataScale = arma::sqrt(equations.CenteredScatter().diag() / (n - 1));
+    phiPhiT /= dataScale * dataScale.t();
+    phiT /= dataScale;
+  }
+
+  arma::colvec eigVal;
+  arma::mat eigVec;
+  if (!arma::eig_sym(eigVal, eigVec, arma::symmatu(phiPhiT)))
   {
     Log::Fatal << "BayesianLinearRegression::Train(): Eigendecomposition "
                << "of covariance failed!" << std::endl;
@@ -49,14 +94,41 @@ double BayesianLinearRegression::Train(const arma::mat& data,
 
   // Compute this quantities once and for all.
   const arma::mat eigVecInv = inv(eigVec);
-  const arma::colvec eigVecInvPhitT = eigVecInv * phi * t.t();
+  const arma::colvec eigVecInvPhitT = eigVecInv * phiT;
+
+  // The squared residual of any solution omega is
+  //
+  //   ||t - omega^T phi||^2 = ||t - omegaLS^T phi||^2 +
+  //       (omega - omegaLS)^T phi phi^T (omega - omegaLS),
+  //
+  // where omegaLS is the (minimum norm) least squares solution.  Only the
+  // first term suffers from cancellation when it is computed from the
+  // statistics, so if the data is available it is computed on the data
+  // instead; this keeps the solution accurate for (nearly) noise-free data.
+  const arma::colvec invEigVal = arma::conv_to<arma::colvec>::from(eigVal >
+      eigVal.max() * eigVal.n_elem * arma::datum::eps) / eigVal;
+  const arma::colvec omegaLS = eigVec * (invEigVal % eigVecInvPhitT);
+  double residual;
+  if (data != NULL)
+  {
+    omega = omegaLS;
+    const double rmse = RMSE(*data, *responses);
+    residual = rmse * rmse * n;
+  }
+  else
+  {
+    residual = std::max(tT - dot(omegaLS, phiT), 0.0);
+  }
 
   // Initialize the hyperparameters and begin with an infinitely broad prior.
+  // The variance of the responses does not depend on whether they are
+  // centered.
   alpha = 1e-6;
-  beta =  1 / (var(t, 1) * 0.1);
+  beta =  1 / (equations.CenteredResponseSquares() / n * 0.1);
 
   unsigned short i = 0;
   double deltaAlpha = 1.0, crit = 1.0;
+  double sse = 0.0;
 
   while ((crit > tolerance) && (i < maxIterations))
   {
@@ -71,8 +143,10 @@ double BayesianLinearRegression::Train(const arma::mat& data,
     alpha = gamma / dot(omega, omega);
 
     // Update beta.
-    const arma::rowvec temp = t - omega.t() * phi;
-    beta = (data.n_cols - gamma) / dot(temp, temp);
+    const arma::colvec delta = omega - omegaLS;
+    sse = residual + std::max(arma::as_scalar(delta.t() * phiPhiT * delta),
+        0.0);
+    beta = (n - gamma) / sse;
 
     // Compute the stopping criterion.
     deltaAlpha += alpha;
@@ -83,7 +157,7 @@ double BayesianLinearRegression::Train(const arma::mat& data,
   // Compute the covariance matrix for the uncertainties later.
   matCovariance = eigVec * diagmat(1 / (beta * eigVal + alpha)) * eigVecInv;
 
-  return RMSE(data, responses);
+  return (data != NULL) ? RMSE(*data, *responses) : std::sqrt(sse / n);
 }
 
 void BayesianLinearRegression::Predict(const arma::mat& points,
@@ -115,48 +189,6 @@ double BayesianLinearRegression::RMSE(const arma::mat& data,
   return sqrt(mean(square(responses - predictions)));
 }
 
-double BayesianLinearRegression::CenterScaleData(const arma::mat& data,
-                                                 const arma::rowvec& responses,
-                                                 arma::mat& dataProc,
-                                                 arma::rowvec& responsesProc)
-{
-  if (!centerData && !scaleData)
-  {
-    dataProc = arma::mat(const_cast<double*>(data.memptr()), data.n_rows,
-                                             data.n_cols, false, true);
-    responsesProc = arma::rowvec(const_cast<double*>(responses.memptr()),
-                                                     responses.n_elem, false,
-                                                     true);
-  }
-
-  else if (centerData && !scaleData)
-  {
-    dataOffset = mean(data, 1);
-    responsesOffset = mean(responses);
-    dataProc = data.each_col() - dataOffset;
-    responsesProc = responses - responsesOffset;
-  }
-
-  else if (!centerData && scaleData)
-  {
-    dataScale = stddev(data, 0, 1);
-    dataProc = data.each_col() / dataScale;
-    responsesProc = arma::rowvec(const_cast<double*>(responses.memptr()),
-                                                     responses.n_elem, false,
-                                                     true);
-  }
-
-  else
-  {
-    dataOffset = mean(data, 1);
-    dataScale = stddev(data, 0, 1);
-    responsesOffset = mean(responses);
-    dataProc = (data.each_col() - dataOffset).each_col() / dataScale;
-    responsesProc = responses - responsesOffset;
-  }
-  return responsesOffset;
-}
-
 void BayesianLinearRegression::CenterScaleDataPred(
     const arma::mat& data,
     arma::mat& dataProc) const
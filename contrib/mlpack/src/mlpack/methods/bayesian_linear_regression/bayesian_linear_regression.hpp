@@ -16,6 +16,7 @@
 #define MLPACK_METHODS_BAYESIAN_LINEAR_REGRESSION_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/methods/linear_regression/normal_equations.hpp>
 
 namespace mlpack {
 namespace regression {
@@ -129,6 +130,38 @@ class BayesianLinearRegression
   double Train(const arma::mat& data,
                const arma::rowvec& responses);
 
+  /**
+   * Run BayesianLinearRegression on data that is read one chunk at a time, so
+   * that only O(P^2) memory is needed no matter how many points there are.
+   * The given source must be callable as
+   *
+   * @code
+   * bool source(arma::mat& data, arma::rowvec& responses);
+   * @endcode
+   *
+   * and should fill the given chunk and return true, or return false once
+   * there is no more data.  The statistics of the data are accumulated
+   * relative to the mean of the first chunk.
+   *
+   * @param source Source of chunks of points and responses.
+   * @return Root mean squared error on the training data.
+   */
+  template<typename ChunkSourceType>
+  double Train(ChunkSourceType& source,
+               const std::enable_if_t<
+                   !std::is_same<ChunkSourceType, NormalEquations>::value>* =
+                   0);
+
+  /**
+   * Run BayesianLinearRegression on the given accumulated statistics of the
+   * (unweighted) training data.  The hyperparameters only depend on the data
+   * through these statistics.
+   *
+   * @param equations Accumulated statistics of the training data.
+   * @return Root mean squared error on the training data.
+   */
+  double Train(const NormalEquations& equations);
+
   /**
    * Predict \f$y_{i}\f$ for each data point in the given data matrix using the
    * currently-trained Bayesian Ridge model.
@@ -283,19 +316,18 @@ class BayesianLinearRegression
   arma::mat matCovariance;
 
   /**
-   * Center and scale the data accordind to centerData and scaleData.
-   * Allows future modifications of new points.
+   * Run BayesianLinearRegression on the given statistics.  If the training data
+   * is given too, the residual of the least squares solution is computed on it
+   * rather than from the statistics, which is more accurate.
    *
-   * @param data Design matrix in column-major format, dim(P, N).
-   * @param responses A vector of targets.
-   * @param dataProc Data processed, dim(P, N).
-   * @param responsesProc Responses processed, dim(N).
-   * @return reponsesOffset Mean of responses.
+   * @param equations Accumulated statistics of the training data.
+   * @param data Training data, or NULL.
+   * @param responses Training responses, or NULL.
+   * @return Root mean squared error on the training data.
    */
-  double CenterScaleData(const arma::mat& data,
-                         const arma::rowvec& responses,
-                         arma::mat& dataProc,
-                         arma::rowvec& responsesProc);
+  double Train(const NormalEquations& equations,
+               const arma::mat* data,
+               const arma::rowvec* responses);
 
   /**
    * Center and scale the points before prediction.
@@ -309,7 +341,7 @@ class BayesianLinearRegression
 } // namespace regression
 } // namespace mlpack
 
-// Include implementation of serialize.
+// Include implementation.
 #include "bayesian_linear_regression_impl.hpp"
 
 #endif
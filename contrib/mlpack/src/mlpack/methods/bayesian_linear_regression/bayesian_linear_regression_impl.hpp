@@ -17,6 +17,42 @@
 namespace mlpack {
 namespace regression {
 
+template<typename ChunkSourceType>
+double BayesianLinearRegression::Train(
+    ChunkSourceType& source,
+    const std::enable_if_t<
+        !std::is_same<ChunkSourceType, NormalEquations>::value>*)
+{
+  arma::mat data;
+  arma::rowvec responses;
+
+  NormalEquations equations;
+  bool initialized = false;
+  while (source(data, responses))
+  {
+    if (data.n_cols == 0)
+      continue;
+
+    // Use the means of the first chunk as the shifts for all of the data.
+    if (!initialized)
+    {
+      equations = NormalEquations(data.n_rows, arma::mean(data, 1),
+          arma::mean(responses));
+      initialized = true;
+    }
+
+    equations.Accumulate(data, responses);
+  }
+
+  if (!initialized)
+  {
+    throw std::invalid_argument("BayesianLinearRegression::Train(): the data "
+        "source did not provide any points!");
+  }
+
+  return Train(equations);
+}
+
 /**
  * Serialize the Bayesian linear regression model.
  */
@@ -510,6 +510,12 @@ class DecisionTree :
   typedef typename CategoricalSplit::AuxiliarySplitInfo
       CategoricalAuxiliarySplitInfo;
 
+  //! Whether the numeric split search may evaluate dimensions in parallel.
+  //! RandomBinaryNumericSplit draws from the global RNG, so it must be
+  //! searched serially.
+  static constexpr bool parallelSplitSearch = !std::is_same<NumericSplit,
+      RandomBinaryNumericSplit<FitnessFunction>>::value;
+
   /**
    * Calculate the class probabilities of the given labels.
    */
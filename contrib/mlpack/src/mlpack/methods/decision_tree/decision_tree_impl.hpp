@@ -837,7 +837,7 @@ double DecisionTree<FitnessFunction,
       UseWeights ? weights.subvec(begin, begin + count - 1) : weights);
   size_t bestDim = data.n_rows; // This means "no split".
 
-  if (maximumDepth != 1)
+  if (maximumDepth != 1 && !parallelSplitSearch)
   {
     for (size_t i = dimensionSelector.Begin(); i != dimensionSelector.End();
          i = dimensionSelector.Next())
@@ -868,6 +868,61 @@ double DecisionTree<FitnessFunction,
         break;
     }
   }
+  else if (maximumDepth != 1)
+  {
+    // Collect the dimensions to consider first, so that the dimension selector
+    // (which may be stateful) is only used on this thread.
+    std::vector<size_t> dimensions;
+    for (size_t i = dimensionSelector.Begin(); i != dimensionSelector.End();
+         i = dimensionSelector.Next())
+      dimensions.push_back(i);
+
+    // Each dimension is searched independently against the gain of the
+    // unsplit node; every thread writes only to its own slots.
+    const double initialGain = bestGain;
+    std::vector<double> dimGains(dimensions.size());
+    std::vector<arma::vec> dimSplitInfo(dimensions.size());
+    std::vector<NumericAuxiliarySplitInfo> dimAux(dimensions.size());
+
+    #pragma omp parallel for
+    for (omp_size_t d = 0; d < (omp_size_t) dimensions.size(); ++d)
+    {
+      dimGains[d] = NumericSplit::template SplitIfBetter<UseWeights>(
+          initialGain,
+          data.cols(begin, begin + count - 1).row(dimensions[d]),
+          labels.cols(begin, begin + count - 1),
+          numClasses,
+          UseWeights ? weights.cols(begin, begin + count - 1) : weights,
+          minimumLeafSize,
+          minimumGainSplit,
+          dimSplitInfo[d],
+          dimAux[d]);
+    }
+
+    // Now reduce in dimension order, applying the same acceptance rule as the
+    // serial search above, so the selected split does not depend on the
+    // number of threads.
+    size_t bestIndex = dimensions.size();
+    for (size_t d = 0; d < dimensions.size(); ++d)
+    {
+      if (bestGain >= 0.0)
+        break;
+
+      if (dimGains[d] == DBL_MAX ||
+          dimGains[d] <= std::min(bestGain + minimumGainSplit, 0.0))
+        continue;
+
+      bestIndex = d;
+      bestGain = dimGains[d];
+    }
+
+    if (bestIndex != dimensions.size())
+    {
+      bestDim = dimensions[bestIndex];
+      classProbabilities = std::move(dimSplitInfo[bestIndex]);
+      NumericAuxiliarySplitInfo::operator=(dimAux[bestIndex]);
+    }
+  }
 
   // Did we split or not?  If so, then split the data and create the children.
   if (bestDim != data.n_rows)
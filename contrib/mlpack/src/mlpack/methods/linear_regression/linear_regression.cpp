@@ -46,51 +46,104 @@ double LinearRegression::Train(const arma::mat& predictors,
                                const arma::rowvec& responses,
                                const arma::rowvec& weights,
                                const bool intercept)
+{
+  // Sanity check on data.
+  util::CheckSameSizes(predictors, responses, "LinearRegression::Train()");
+  if (weights.n_elem > 0)
+  {
+    util::CheckSameSizes(predictors, weights, "LinearRegression::Train()",
+        "weights");
+  }
+
+  // This is a two-pass algorithm: first find the (weighted) mean of the
+  // predictors, then accumulate the normal equations of the data centered on
+  // that mean.  Neither pass needs a copy of the data.
+  arma::vec shift;
+  if (intercept)
+  {
+    shift = (weights.n_elem > 0) ?
+        arma::vec(predictors * weights.t() / arma::accu(weights)) :
+        arma::vec(arma::mean(predictors, 1));
+  }
+
+  NormalEquations equations(predictors.n_rows, shift);
+  equations.Accumulate(predictors, responses, weights);
+  Train(equations, intercept);
+
+  return ComputeError(predictors, responses);
+}
+
+double LinearRegression::Train(const NormalEquations& equations,
+                               const bool intercept)
 {
   this->intercept = intercept;
 
   /*
    * We want to calculate the a_i coefficients of:
    * \sum_{i=0}^n (a_i * x_i^i)
-   * In order to get the intercept value, we will add a row of ones.
+   * In order to get the intercept value, we add a one to every point, so that
+   * we solve
+   *
+   *   (X W X^T + lambda * I) a = X W y^T.
+   *
+   * All of the coefficients (including the intercept) are penalized.  Add an
+   * "all ones" row to the predictors and set intercept = false to get the same
+   * model without the intercept being treated specially.
+   *
+   * The normal equations are accumulated for the points shifted by s.  Writing
+   * a' = a_0 + s^T b for the intercept of the shifted problem, the ridge
+   * penalty a_0^2 + b^T b becomes (a' - s^T b)^2 + b^T b, so we solve
+   *
+   *   (X' W X'^T + lambda * P) [a'; b] = X' W y^T
+   *
+   * with P = [1, -s^T; -s, I + s s^T], and then recover a_0 = a' - s^T b.
+   * The total runtime of this is O(d^2 N) to accumulate the equations (done
+   * elsewhere) and O(d^3) to solve them.
    */
+  const size_t d = equations.Scatter().n_rows;
+  const arma::vec& s = equations.Shift();
 
-  // We store the number of rows and columns of the predictors.
-  // Reminder: Armadillo stores the data transposed from how we think of it,
-  //           that is, columns are actually rows (see: column major order).
-
-  // Sanity check on data.
-  util::CheckSameSizes(predictors, responses, "LinearRegression::Train()");
-
-  const size_t nCols = predictors.n_cols;
-
-  arma::mat p = predictors;
-  arma::rowvec r = responses;
-
-  // Here we add the row of ones to the predictors.
-  // The intercept is not penalized. Add an "all ones" row to design and set
-  // intercept = false to get a penalized intercept.
+  arma::mat gram, penalty;
+  arma::vec rhs;
   if (intercept)
   {
-    p.insert_rows(0, arma::ones<arma::mat>(1, nCols));
+    gram.set_size(d + 1, d + 1);
+    gram(0, 0) = equations.Weight();
+    gram.submat(1, 0, d, 0) = equations.Sums();
+    gram.submat(0, 1, 0, d) = equations.Sums().t();
+    gram.submat(1, 1, d, d) = equations.Scatter();
+
+    penalty.set_size(d + 1, d + 1);
+    penalty(0, 0) = 1.0;
+    penalty.submat(1, 0, d, 0) = -s;
+    penalty.submat(0, 1, 0, d) = -s.t();
+    penalty.submat(1, 1, d, d) = arma::eye<arma::mat>(d, d) + s * s.t();
+
+    rhs.set_size(d + 1);
+    rhs[0] = equations.RawResponseSum();
+    rhs.subvec(1, d) = equations.Cross() +
+        equations.Sums() * equations.ResponseShift();
   }
-
-  if (weights.n_elem > 0)
+  else
   {
-    p = p * diagmat(sqrt(weights));
-    r = sqrt(weights) % responses;
+    // Without an intercept, a shift would change the model, so we need the
+    // unshifted equations.
+    gram = equations.RawScatter();
+    penalty = arma::eye<arma::mat>(d, d);
+    rhs = equations.RawCross();
   }
 
-  // Convert to this form:
-  // a * (X X^T) = y X^T.
-  // Then we'll use Armadillo to solve it.
-  // The total runtime of this should be O(d^2 N) + O(d^3) + O(dN).
-  // (assuming the SVD is used to solve it)
-  arma::mat cov = p * p.t() +
-      lambda * arma::eye<arma::mat>(p.n_rows, p.n_rows);
+  parameters = arma::solve(gram + lambda * penalty, rhs);
 
-  parameters = arma::solve(cov, p * r.t());
-  return ComputeError(predictors, responses);
+  // The weighted sum of squared residuals follows from the same statistics.
+  const double sse = equations.RawResponseSquares() -
+      2 * arma::dot(parameters, rhs) +
+      arma::as_scalar(parameters.t() * gram * parameters);
+
+  if (intercept)
+    parameters[0] -= arma::dot(s, parameters.subvec(1, d));
+
+  return std::max(sse, 0.0) / equations.Weight();
 }
 
 void LinearRegression::Predict(const arma::mat& points,
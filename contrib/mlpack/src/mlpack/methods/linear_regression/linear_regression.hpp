@@ -15,6 +15,8 @@
 
 #include <mlpack/prereqs.hpp>
 
+#include "normal_equations.hpp"
+
 namespace mlpack {
 namespace regression /** Regression methods. */ {
 
@@ -95,6 +97,48 @@ class LinearRegression
                const arma::rowvec& weights,
                const bool intercept = true);
 
+  /**
+   * Train the LinearRegression model on data that is read one chunk at a
+   * time, so that only O(d^2) memory is needed no matter how many points there
+   * are.  Careful!  This will completely ignore and overwrite the existing
+   * model.  The given source must be callable as
+   *
+   * @code
+   * bool source(arma::mat& predictors,
+   *             arma::rowvec& responses,
+   *             arma::rowvec& weights);
+   * @endcode
+   *
+   * and should fill the given chunk and return true, or return false once
+   * there is no more data.  The weights may be left empty, in which case every
+   * point in the chunk has weight 1.  The normal equations are accumulated
+   * relative to the mean of the first chunk, so that they stay accurate even
+   * though the data is only seen once.
+   *
+   * @param source Source of chunks of points, responses and weights.
+   * @param intercept Whether or not to fit an intercept term.
+   * @return The weighted mean squared error of the model on the training data.
+   */
+  template<typename ChunkSourceType>
+  double Train(ChunkSourceType& source,
+               const bool intercept = true,
+               const std::enable_if_t<
+                   !arma::is_arma_type<ChunkSourceType>::value &&
+                   !std::is_same<ChunkSourceType, NormalEquations>::value>* =
+                   0);
+
+  /**
+   * Set the model to the (ridge) least squares solution given by the given
+   * accumulated normal equations.  Careful!  This will completely ignore and
+   * overwrite the existing model.
+   *
+   * @param equations Accumulated statistics of the training data.
+   * @param intercept Whether or not to fit an intercept term.
+   * @return The weighted mean squared error of the model on the training data.
+   */
+  double Train(const NormalEquations& equations,
+               const bool intercept = true);
+
   /**
    * Calculate y_i for each data point in points.
    *
@@ -167,4 +211,7 @@ class LinearRegression
 } // namespace regression
 } // namespace mlpack
 
+// Include implementation of templated functions.
+#include "linear_regression_impl.hpp"
+
 #endif // MLPACK_METHODS_LINEAR_REGRESSION_HPP
@@ -0,0 +1,61 @@
+/**
+ * @file methods/linear_regression/linear_regression_impl.hpp
+ *
+ * Implementation of the templated LinearRegression functions.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_LINEAR_REGRESSION_LINEAR_REGRESSION_IMPL_HPP
+#define MLPACK_METHODS_LINEAR_REGRESSION_LINEAR_REGRESSION_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "linear_regression.hpp"
+
+namespace mlpack {
+namespace regression {
+
+template<typename ChunkSourceType>
+double LinearRegression::Train(
+    ChunkSourceType& source,
+    const bool intercept,
+    const std::enable_if_t<
+        !arma::is_arma_type<ChunkSourceType>::value &&
+        !std::is_same<ChunkSourceType, NormalEquations>::value>*)
+{
+  arma::mat predictors;
+  arma::rowvec responses, weights;
+
+  NormalEquations equations;
+  bool initialized = false;
+  while (source(predictors, responses, weights))
+  {
+    if (predictors.n_cols == 0)
+      continue;
+
+    // Use the mean of the first chunk as the shift for all of the data.
+    if (!initialized)
+    {
+      equations = NormalEquations(predictors.n_rows, intercept ?
+          arma::vec(arma::mean(predictors, 1)) : arma::vec());
+      initialized = true;
+    }
+
+    equations.Accumulate(predictors, responses, weights);
+  }
+
+  if (!initialized)
+  {
+    throw std::invalid_argument("LinearRegression::Train(): the data source "
+        "did not provide any points!");
+  }
+
+  return Train(equations, intercept);
+}
+
+} // namespace regression
+} // namespace mlpack
+
+#endif
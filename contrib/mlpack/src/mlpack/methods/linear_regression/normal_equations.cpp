@@ -0,0 +1,134 @@
+/**
+ * @file methods/linear_regression/normal_equations.cpp
+ *
+ * Implementation of the NormalEquations class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "normal_equations.hpp"
+#include <mlpack/core/util/size_checks.hpp>
+
+using namespace mlpack;
+using namespace mlpack::regression;
+
+NormalEquations::NormalEquations(const size_t dimensionality,
+                                 const arma::vec& shift,
+                                 const double responseShift) :
+    shift(shift.is_empty() ? arma::vec(dimensionality, arma::fill::zeros) :
+        shift),
+    responseShift(responseShift),
+    numPoints(0),
+    weight(0.0),
+    sums(dimensionality, arma::fill::zeros),
+    scatter(dimensionality, dimensionality, arma::fill::zeros),
+    cross(dimensionality, arma::fill::zeros),
+    responseSum(0.0),
+    responseSquares(0.0)
+{
+  if (this->shift.n_elem != dimensionality)
+  {
+    std::ostringstream oss;
+    oss << "NormalEquations::NormalEquations(): shift has "
+        << this->shift.n_elem << " elements, but data has dimensionality "
+        << dimensionality << "!";
+    throw std::invalid_argument(oss.str());
+  }
+}
+
+void NormalEquations::Accumulate(const arma::mat& predictors,
+                                 const arma::rowvec& responses,
+                                 const arma::rowvec& weights)
+{
+  util::CheckSameSizes(predictors, responses, "NormalEquations::Accumulate()");
+  if (weights.n_elem > 0)
+  {
+    util::CheckSameSizes(predictors, weights, "NormalEquations::Accumulate()",
+        "weights");
+  }
+  util::CheckSameDimensionality(predictors, shift,
+      "NormalEquations::Accumulate()", "predictors");
+
+  // The scatter matrix is accumulated with one matrix multiplication per
+  // block, so that only a block of shifted points has to be materialized.
+  const size_t blockSize = 1024;
+  const size_t numBlocks = (predictors.n_cols + blockSize - 1) / blockSize;
+
+  #pragma omp parallel
+  {
+    NormalEquations local(shift.n_elem, shift, responseShift);
+
+    #pragma omp for schedule(static)
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+    {
+      const size_t begin = b * blockSize;
+      const size_t end = std::min(begin + blockSize,
+          (size_t) predictors.n_cols) - 1;
+
+      arma::mat x = predictors.cols(begin, end);
+      x.each_col() -= shift;
+      const arma::rowvec y = responses.subvec(begin, end) - responseShift;
+      const arma::rowvec w = (weights.n_elem > 0) ? weights.subvec(begin, end)
+          : arma::rowvec(y.n_elem, arma::fill::ones);
+      const arma::mat xw = x.each_row() % w;
+
+      local.numPoints += y.n_elem;
+      local.weight += arma::accu(w);
+      local.sums += arma::sum(xw, 1);
+      local.scatter += xw * x.t();
+      local.cross += xw * y.t();
+      local.responseSum += arma::dot(w, y);
+      local.responseSquares += arma::dot(w % y, y);
+    }
+
+    #pragma omp critical
+    *this += local;
+  }
+}
+
+NormalEquations& NormalEquations::operator+=(const NormalEquations& other)
+{
+  numPoints += other.numPoints;
+  weight += other.weight;
+  sums += other.sums;
+  scatter += other.scatter;
+  cross += other.cross;
+  responseSum += other.responseSum;
+  responseSquares += other.responseSquares;
+  return *this;
+}
+
+arma::mat NormalEquations::CenteredScatter() const
+{
+  return scatter - sums * sums.t() / weight;
+}
+
+arma::vec NormalEquations::CenteredCross() const
+{
+  return cross - sums * (responseSum / weight);
+}
+
+double NormalEquations::CenteredResponseSquares() const
+{
+  return responseSquares - responseSum * responseSum / weight;
+}
+
+arma::mat NormalEquations::RawScatter() const
+{
+  return scatter + sums * shift.t() + shift * sums.t() +
+      weight * shift * shift.t();
+}
+
+arma::vec NormalEquations::RawCross() const
+{
+  return cross + shift * responseSum + (sums + weight * shift) *
+      responseShift;
+}
+
+double NormalEquations::RawResponseSquares() const
+{
+  return responseSquares + responseShift * (2 * responseSum +
+      weight * responseShift);
+}
@@ -0,0 +1,137 @@
+/**
+ * @file methods/linear_regression/normal_equations.hpp
+ *
+ * Accumulation of the sufficient statistics of a (weighted) least squares
+ * problem, so that linear models can be fit without holding all of the data in
+ * memory at once.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_LINEAR_REGRESSION_NORMAL_EQUATIONS_HPP
+#define MLPACK_METHODS_LINEAR_REGRESSION_NORMAL_EQUATIONS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace regression {
+
+/**
+ * The sufficient statistics of a weighted least squares problem with
+ * predictors X (one point per column), responses y and weights w: the total
+ * weight, and the weighted sums, scatter matrix and cross products of the
+ * predictors and responses.  Only O(d^2) memory is needed regardless of the
+ * number of points, and blocks of points can be accumulated one at a time.
+ *
+ * To avoid the loss of precision of the textbook normal equations, the
+ * predictors and responses are shifted by a fixed vector s and a fixed value r
+ * before accumulating, i.e.
+ *
+ *   Sums() = sum_i w_i (x_i - s),
+ *   Scatter() = sum_i w_i (x_i - s) (x_i - s)^T,
+ *   Cross() = sum_i w_i (x_i - s) (y_i - r),
+ *   ResponseSum() = sum_i w_i (y_i - r),
+ *   ResponseSquares() = sum_i w_i (y_i - r)^2.
+ *
+ * When s and r are the means of the data (or close to them), the centered
+ * statistics are computed as accurately as with the two-pass algorithm.
+ */
+class NormalEquations
+{
+ public:
+  /**
+   * Create empty statistics for data of the given dimensionality, with the
+   * given shifts (a zero shift is used for the predictors if it is empty).
+   *
+   * @param dimensionality Dimensionality of the predictors.
+   * @param shift Vector subtracted from every predictor before accumulating.
+   * @param responseShift Value subtracted from every response before
+   *     accumulating.
+   */
+  NormalEquations(const size_t dimensionality = 0,
+                  const arma::vec& shift = arma::vec(),
+                  const double responseShift = 0.0);
+
+  /**
+   * Add the given block of points to the statistics.  The block is split into
+   * sub-blocks that are accumulated in parallel into per-thread partial sums,
+   * which are merged at the end.
+   *
+   * @param predictors Block of points, one per column.
+   * @param responses Response for each point.
+   * @param weights Weight for each point (if empty, every point has weight 1).
+   */
+  void Accumulate(const arma::mat& predictors,
+                  const arma::rowvec& responses,
+                  const arma::rowvec& weights = arma::rowvec());
+
+  //! Merge the statistics of another set of points (with the same shifts).
+  NormalEquations& operator+=(const NormalEquations& other);
+
+  //! Get the shift of the predictors.
+  const arma::vec& Shift() const { return shift; }
+  //! Get the shift of the responses.
+  double ResponseShift() const { return responseShift; }
+  //! Get the number of points.
+  size_t NumPoints() const { return numPoints; }
+  //! Get the total weight of the points.
+  double Weight() const { return weight; }
+  //! Get the weighted sum of the shifted predictors.
+  const arma::vec& Sums() const { return sums; }
+  //! Get the weighted scatter matrix of the shifted predictors.
+  const arma::mat& Scatter() const { return scatter; }
+  //! Get the weighted cross products of the shifted predictors and responses.
+  const arma::vec& Cross() const { return cross; }
+  //! Get the weighted sum of the shifted responses.
+  double ResponseSum() const { return responseSum; }
+  //! Get the weighted sum of the squared shifted responses.
+  double ResponseSquares() const { return responseSquares; }
+
+  //! Get the weighted mean of the predictors.
+  arma::vec Mean() const { return shift + sums / weight; }
+  //! Get the weighted mean of the responses.
+  double ResponseMean() const { return responseShift + responseSum / weight; }
+
+  //! Get the weighted scatter matrix of the centered predictors.
+  arma::mat CenteredScatter() const;
+  //! Get the weighted cross products of the centered predictors and responses.
+  arma::vec CenteredCross() const;
+  //! Get the weighted sum of the squared centered responses.
+  double CenteredResponseSquares() const;
+  //! Get the weighted scatter matrix of the unshifted predictors (X W X^T).
+  arma::mat RawScatter() const;
+  //! Get the weighted cross products of the unshifted data (X W y^T).
+  arma::vec RawCross() const;
+  //! Get the weighted sum of the unshifted responses.
+  double RawResponseSum() const
+  { return responseSum + weight * responseShift; }
+  //! Get the weighted sum of the squared unshifted responses.
+  double RawResponseSquares() const;
+
+ private:
+  //! The shift applied to the predictors.
+  arma::vec shift;
+  //! The shift applied to the responses.
+  double responseShift;
+  //! The number of points.
+  size_t numPoints;
+  //! The total weight.
+  double weight;
+  //! The weighted sum of the shifted predictors.
+  arma::vec sums;
+  //! The weighted scatter matrix of the shifted predictors.
+  arma::mat scatter;
+  //! The weighted cross products of the shifted predictors and responses.
+  arma::vec cross;
+  //! The weighted sum of the shifted responses.
+  double responseSum;
+  //! The weighted sum of the squared shifted responses.
+  double responseSquares;
+};
+
+} // namespace regression
+} // namespace mlpack
+
+#endif
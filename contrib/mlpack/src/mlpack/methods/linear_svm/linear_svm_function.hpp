@@ -108,7 +108,9 @@ class LinearSVMFunction
 
   /**
    * Evaluate the gradient of the hinge loss function, following
-   * the LinearFunctionType requirements on the Gradient function.
+   * the LinearFunctionType requirements on the Gradient function.  If
+   * GradType is a sparse matrix, only the coordinates of the features present
+   * in the batch are set, and the L2 penalty is applied lazily to those.
    *
    * @tparam GradType Type of the gradient matrix.
    * @param parameters The parameters of the SVM.
@@ -163,9 +165,9 @@ class LinearSVMFunction
   arma::mat& InitialPoint() { return initialPoint; }
 
   //! Get the dataset.
-  const arma::sp_mat& Dataset() const { return dataset; }
+  const MatType& Dataset() const { return dataset; }
   //! Modify the dataset.
-  arma::sp_mat& Dataset() { return dataset; }
+  MatType& Dataset() { return dataset; }
 
   //! Sets the regularization parameter.
   double& Lambda() { return lambda; }
@@ -179,6 +181,32 @@ class LinearSVMFunction
   size_t NumFunctions() const;
 
  private:
+  /**
+   * Compute the gradient for the batch of points starting at firstId, given
+   * the hinge loss subgradient coefficients for each point in the batch.
+   */
+  template <typename GradType>
+  void BatchGradient(
+      const arma::mat& parameters,
+      const size_t firstId,
+      const arma::mat& difference,
+      GradType& gradient,
+      const std::enable_if_t<!arma::is_SpMat<GradType>::value>* = 0) const;
+
+  /**
+   * Compute a sparse gradient for the batch of points starting at firstId.
+   * Only the features that appear in the batch (and the intercept, if it is
+   * fitted) receive a gradient, and the L2 penalty is applied lazily to those
+   * coordinates only.
+   */
+  template <typename GradType>
+  void BatchGradient(
+      const arma::mat& parameters,
+      const size_t firstId,
+      const arma::mat& difference,
+      GradType& gradient,
+      const std::enable_if_t<arma::is_SpMat<GradType>::value>* = 0) const;
+
   //! The initial point, from which to start the optimization.
   arma::mat initialPoint;
 
@@ -16,6 +16,7 @@
 
 #include <mlpack/core/math/make_alias.hpp>
 #include <mlpack/core/math/shuffle_data.hpp>
+#include <mlpack/core/math/lazy_regularization.hpp>
 
 // In case it hasn't been included yet.
 #include "linear_svm_function.hpp"
@@ -215,8 +216,7 @@ double LinearSVMFunction<MatType>::Evaluate(
   {
     scores = parameters.rows(0, dataset.n_rows - 1).t()
         * dataset.cols(firstId, lastId)
-        + arma::repmat(parameters.row(dataset.n_rows).t(), 1,
-        dataset.n_cols);
+        + arma::repmat(parameters.row(dataset.n_rows).t(), 1, batchSize);
   }
 
   arma::mat margin = scores - (arma::repmat(arma::ones(numClasses).t()
@@ -335,24 +335,7 @@ void LinearSVMFunction<MatType>::Gradient(
   arma::mat difference = groundTruth.cols(firstId, lastId)
       % (-arma::repmat(arma::sum(mask), numClasses, 1)) + mask;
 
-  // Check intercept condition
-  if (!fitIntercept)
-  {
-    gradient = dataset.cols(firstId, lastId) * difference.t();
-  }
-  else
-  {
-    gradient.set_size(arma::size(parameters));
-    gradient.submat(0, 0, parameters.n_rows - 2, parameters.n_cols - 1) =
-        dataset.cols(firstId, lastId) * difference.t();
-    gradient.row(parameters.n_rows - 1) =
-        arma::ones<arma::rowvec>(batchSize) * difference.t();
-  }
-
-  gradient /= batchSize;
-
-  // Adding the regularization contribution to the gradient.
-  gradient += lambda * parameters;
+  BatchGradient(parameters, firstId, difference, gradient);
 }
 
 template <typename MatType>
@@ -444,7 +427,7 @@ double LinearSVMFunction<MatType>::EvaluateWithGradient(
   {
     scores = parameters.rows(0, dataset.n_rows - 1).t()
         * dataset.cols(firstId, lastId)
-        + arma::repmat(parameters.row(dataset.n_rows).t(), 1, dataset.n_cols);
+        + arma::repmat(parameters.row(dataset.n_rows).t(), 1, batchSize);
   }
 
   arma::mat margin = scores - (arma::repmat(arma::ones(numClasses).t()
@@ -459,6 +442,31 @@ double LinearSVMFunction<MatType>::EvaluateWithGradient(
   arma::mat difference = groundTruth.cols(firstId, lastId)
       % (-arma::repmat(arma::sum(mask), numClasses, 1)) + mask;
 
+  BatchGradient(parameters, firstId, difference, gradient);
+
+  // The Hinge Loss Function
+  loss = arma::accu(arma::clamp(margin, 0.0, DBL_MAX));
+  loss /= batchSize;
+
+  // Adding the regularization term.
+  regularization = 0.5 * lambda * arma::dot(parameters, parameters);
+
+  cost = loss + regularization;
+  return cost;
+}
+
+template <typename MatType>
+template <typename GradType>
+void LinearSVMFunction<MatType>::BatchGradient(
+    const arma::mat& parameters,
+    const size_t firstId,
+    const arma::mat& difference,
+    GradType& gradient,
+    const std::enable_if_t<!arma::is_SpMat<GradType>::value>*) const
+{
+  const size_t batchSize = difference.n_cols;
+  const size_t lastId = firstId + batchSize - 1;
+
   // Check intercept condition
   if (!fitIntercept)
   {
@@ -475,19 +483,58 @@ double LinearSVMFunction<MatType>::EvaluateWithGradient(
 
   gradient /= batchSize;
 
-
   // Adding the regularization contribution to the gradient.
   gradient += lambda * parameters;
+}
 
-  // The Hinge Loss Function
-  loss = arma::accu(arma::clamp(margin.cols(firstId, lastId), 0.0, DBL_MAX));
-  loss /= batchSize;
+template <typename MatType>
+template <typename GradType>
+void LinearSVMFunction<MatType>::BatchGradient(
+    const arma::mat& parameters,
+    const size_t firstId,
+    const arma::mat& difference,
+    GradType& gradient,
+    const std::enable_if_t<arma::is_SpMat<GradType>::value>*) const
+{
+  const size_t batchSize = difference.n_cols;
+  const size_t lastId = firstId + batchSize - 1;
 
-  // Adding the regularization term.
-  regularization = 0.5 * lambda * arma::dot(parameters, parameters);
+  // Only the features present in the batch get a nonzero gradient, and only
+  // those are regularized.
+  arma::sp_mat featureGradient;
+  math::SparseGradientProduct(dataset.cols(firstId, lastId),
+      arma::mat(difference / batchSize), featureGradient);
+  math::LazyL2Regularize(featureGradient, parameters, lambda);
 
-  cost = loss + regularization;
-  return cost;
+  if (!fitIntercept)
+  {
+    gradient = std::move(featureGradient);
+    return;
+  }
+
+  // The intercept row is dense; every point contributes to it.
+  const arma::rowvec interceptGradient = arma::sum(difference, 1).t() /
+      batchSize + lambda * parameters.row(parameters.n_rows - 1);
+
+  arma::umat locations(2, featureGradient.n_nonzero + parameters.n_cols);
+  arma::vec values(featureGradient.n_nonzero + parameters.n_cols);
+  size_t i = 0;
+  typename arma::sp_mat::const_iterator it = featureGradient.begin();
+  for ( ; it != featureGradient.end(); ++it, ++i)
+  {
+    locations(0, i) = it.row();
+    locations(1, i) = it.col();
+    values[i] = (*it);
+  }
+  for (size_t c = 0; c < parameters.n_cols; ++c, ++i)
+  {
+    locations(0, i) = parameters.n_rows - 1;
+    locations(1, i) = c;
+    values[i] = interceptGradient[c];
+  }
+
+  gradient = GradType(locations, values, parameters.n_rows,
+      parameters.n_cols);
 }
 
 template <typename MatType>
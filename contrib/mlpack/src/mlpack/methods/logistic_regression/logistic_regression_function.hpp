@@ -17,6 +17,7 @@
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/math/make_alias.hpp>
 #include <mlpack/core/math/shuffle_data.hpp>
+#include <mlpack/core/math/lazy_regularization.hpp>
 
 namespace mlpack {
 namespace regression {
@@ -116,7 +117,32 @@ class LogisticRegressionFunction
   void Gradient(const arma::mat& parameters,
                 const size_t begin,
                 GradType& gradient,
-                const size_t batchSize = 1) const;
+                const size_t batchSize = 1,
+                const std::enable_if_t<!arma::is_SpMat<GradType>::value>* = 0)
+      const;
+
+  /**
+   * Evaluate the gradient of the logistic regression log-likelihood function
+   * with the given parameters, for the given batch size from a given point in
+   * the dataset, into a sparse gradient.  Only the intercept and the features
+   * that appear in the batch receive a gradient, and the L2 penalty is applied
+   * lazily to those coordinates only.  When the predictors are sparse, the
+   * cost of this is proportional to the number of nonzeros in the batch.
+   *
+   * @param parameters Vector of logistic regression parameters.
+   * @param begin Index of the starting point to use for objective function
+   *     gradient evaluation.
+   * @param gradient Sparse vector to output gradient into.
+   * @param batchSize Number of points to be processed as a batch for objective
+   *     function gradient evaluation.
+   */
+  template<typename GradType>
+  void Gradient(const arma::mat& parameters,
+                const size_t begin,
+                GradType& gradient,
+                const size_t batchSize = 1,
+                const std::enable_if_t<arma::is_SpMat<GradType>::value>* = 0)
+      const;
 
   /**
    * Evaluate the gradient of the logistic regression log-likelihood function
@@ -147,10 +173,26 @@ class LogisticRegressionFunction
    * the given batch size from a given point in the dataset.
    */
   template<typename GradType>
-  double EvaluateWithGradient(const arma::mat& parameters,
-                              const size_t begin,
-                              GradType& gradient,
-                              const size_t batchSize = 1) const;
+  double EvaluateWithGradient(
+      const arma::mat& parameters,
+      const size_t begin,
+      GradType& gradient,
+      const size_t batchSize = 1,
+      const std::enable_if_t<!arma::is_SpMat<GradType>::value>* = 0) const;
+
+  /**
+   * Evaluate the objective function and sparse gradient of the logistic
+   * regression log-likelihood function simultaneously with the given
+   * parameters, for the given batch size from a given point in the dataset.
+   * See the sparse overload of Gradient() for details on the gradient.
+   */
+  template<typename GradType>
+  double EvaluateWithGradient(
+      const arma::mat& parameters,
+      const size_t begin,
+      GradType& gradient,
+      const size_t batchSize = 1,
+      const std::enable_if_t<arma::is_SpMat<GradType>::value>* = 0) const;
 
   //! Return the number of separable functions (the number of predictor points).
   size_t NumFunctions() const { return predictors.n_cols; }
@@ -159,6 +201,16 @@ class LogisticRegressionFunction
   size_t NumFeatures() const { return predictors.n_rows + 1; }
 
  private:
+  /**
+   * Assemble the sparse gradient for a batch, given the difference between
+   * the sigmoids and the responses for each point in the batch.
+   */
+  template<typename GradType>
+  void SparseGradient(const arma::mat& parameters,
+                      const size_t begin,
+                      const arma::rowvec& diffs,
+                      GradType& gradient) const;
+
   //! The matrix of data points (predictors).  This is an alias until shuffling
   //! is done.
   MatType predictors;
@@ -159,7 +159,9 @@ void LogisticRegressionFunction<MatType>::Gradient(
                 const arma::mat& parameters,
                 const size_t begin,
                 GradType& gradient,
-                const size_t batchSize) const
+                const size_t batchSize,
+                const std::enable_if_t<!arma::is_SpMat<GradType>::value>*)
+    const
 {
   // Regularization term.
   arma::mat regularization;
@@ -244,7 +246,8 @@ double LogisticRegressionFunction<MatType>::EvaluateWithGradient(
     const arma::mat& parameters,
     const size_t begin,
     GradType& gradient,
-    const size_t batchSize) const
+    const size_t batchSize,
+    const std::enable_if_t<!arma::is_SpMat<GradType>::value>*) const
 {
   // Regularization term.
   arma::mat regularization =
@@ -278,6 +281,99 @@ double LogisticRegressionFunction<MatType>::EvaluateWithGradient(
   return objectiveRegularization - result;
 }
 
+//! Evaluate the sparse gradient of the logistic regression objective function
+//! for a given batch size.
+template<typename MatType>
+template<typename GradType>
+void LogisticRegressionFunction<MatType>::Gradient(
+    const arma::mat& parameters,
+    const size_t begin,
+    GradType& gradient,
+    const size_t batchSize,
+    const std::enable_if_t<arma::is_SpMat<GradType>::value>*) const
+{
+  // Calculating the sigmoid function values.
+  const arma::rowvec sigmoids = 1.0 / (1.0 + arma::exp(-(parameters(0, 0) +
+      parameters.tail_cols(parameters.n_elem - 1) *
+      predictors.cols(begin, begin + batchSize - 1))));
+
+  const arma::rowvec diffs = sigmoids - arma::conv_to<arma::rowvec>::from(
+      responses.subvec(begin, begin + batchSize - 1));
+
+  SparseGradient(parameters, begin, diffs, gradient);
+}
+
+template<typename MatType>
+template<typename GradType>
+double LogisticRegressionFunction<MatType>::EvaluateWithGradient(
+    const arma::mat& parameters,
+    const size_t begin,
+    GradType& gradient,
+    const size_t batchSize,
+    const std::enable_if_t<arma::is_SpMat<GradType>::value>*) const
+{
+  const double objectiveRegularization = lambda *
+      (batchSize / (2.0 * predictors.n_cols)) *
+      arma::dot(parameters.tail_cols(parameters.n_elem - 1),
+                parameters.tail_cols(parameters.n_elem - 1));
+
+  // Calculate the sigmoid function values.
+  const arma::rowvec sigmoids = 1.0 / (1.0 + arma::exp(-(parameters(0, 0) +
+      parameters.tail_cols(parameters.n_elem - 1) *
+      predictors.cols(begin, begin + batchSize - 1))));
+
+  arma::rowvec respD = arma::conv_to<arma::rowvec>::from(responses.subvec(begin,
+      begin + batchSize - 1));
+  SparseGradient(parameters, begin, sigmoids - respD, gradient);
+
+  // Now compute the objective function using the sigmoids.
+  const double result = arma::accu(arma::log(1.0 - respD + sigmoids %
+      (2 * respD - 1.0)));
+
+  // Invert the result, because it's a minimization.
+  return objectiveRegularization - result;
+}
+
+template<typename MatType>
+template<typename GradType>
+void LogisticRegressionFunction<MatType>::SparseGradient(
+    const arma::mat& parameters,
+    const size_t begin,
+    const arma::rowvec& diffs,
+    GradType& gradient) const
+{
+  // Only the features present in the batch get a nonzero gradient.
+  arma::sp_mat featureGradient;
+  math::SparseGradientProduct(predictors.cols(begin, begin + diffs.n_elem - 1),
+      arma::mat(diffs), featureGradient);
+  featureGradient = featureGradient.t();
+
+  // Apply the L2 penalty (scaled to the batch, as in the dense gradient) to
+  // the touched features only.
+  math::LazyL2Regularize(featureGradient,
+      parameters.tail_cols(parameters.n_elem - 1),
+      lambda * diffs.n_elem / predictors.n_cols);
+
+  // Now shift the feature gradient over by one to make room for the intercept.
+  arma::umat locations(2, featureGradient.n_nonzero + 1);
+  arma::vec values(featureGradient.n_nonzero + 1);
+  locations(0, 0) = 0;
+  locations(1, 0) = 0;
+  values[0] = arma::accu(diffs);
+
+  size_t i = 1;
+  typename arma::sp_mat::const_iterator it = featureGradient.begin();
+  for ( ; it != featureGradient.end(); ++it, ++i)
+  {
+    locations(0, i) = 0;
+    locations(1, i) = it.col() + 1;
+    values[i] = (*it);
+  }
+
+  gradient = GradType(locations, values, parameters.n_rows,
+      parameters.n_cols);
+}
+
 } // namespace regression
 } // namespace mlpack
 
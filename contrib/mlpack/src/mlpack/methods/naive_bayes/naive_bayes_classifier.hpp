@@ -108,6 +108,9 @@ class NaiveBayesClassifier
    * classes, either re-initialize or call Means(), Variances(), and
    * Probabilities() individually to set them to the right size.
    *
+   * The per-class statistics of the data are computed in parallel over
+   * contiguous blocks of points, and then merged into the model.
+   *
    * @param data The dataset to train on.
    * @param labels The labels for the dataset.
    * @param numClasses The numbe of classes in the dataset.
@@ -120,6 +123,33 @@ class NaiveBayesClassifier
              const size_t numClasses,
              const bool incremental = true);
 
+  /**
+   * Train the Naive Bayes classifier on data that is read one chunk at a time,
+   * so that the whole dataset never needs to be held in memory.  The given
+   * source must be callable as
+   *
+   * @code
+   * bool source(ModelMatType& chunk, arma::Row<size_t>& chunkLabels);
+   * @endcode
+   *
+   * and should fill the given chunk and its labels and return true, or return
+   * false once there is no more data.  The resulting model is the same as if
+   * Train() had been called on all of the chunks at once.  If incremental is
+   * false, the current model is discarded and the dimensionality of the model
+   * is taken from the first chunk.
+   *
+   * @param source Source of chunks of data and labels.
+   * @param numClasses The number of classes in the dataset.
+   * @param incremental Whether or not to use the current model as a starting
+   *      point.
+   */
+  template<typename ChunkSourceType>
+  void Train(ChunkSourceType& source,
+             const size_t numClasses,
+             const bool incremental = false,
+             const std::enable_if_t<
+                 !arma::is_arma_type<ChunkSourceType>::value>* = 0);
+
   /**
    * Train the Naive Bayes classifier on the given point.  This will use the
    * incremental algorithm for updating the model parameters.  The data must be
@@ -230,10 +260,47 @@ class NaiveBayesClassifier
   //! Small value to prevent log of zero.
   double epsilon;
 
+  /**
+   * Convert the current model into the number of points and the sum of
+   * squared deviations from the mean of each class, so that more data can be
+   * merged into it with UpdateStatistics().
+   *
+   * @param counts Number of points in each class.
+   * @param sumSquares Sum of squared deviations of each feature in each class.
+   */
+  void Denormalize(ModelMatType& counts, ModelMatType& sumSquares) const;
+
+  /**
+   * Merge the statistics of the given data into the given class counts, the
+   * current means, and the given sums of squared deviations.  The statistics
+   * of the data are computed with per-thread accumulators over blocks of
+   * points, and merged with the pairwise update of Chan, Golub and LeVeque.
+   *
+   * @param data The data to merge.
+   * @param labels The labels for the data.
+   * @param counts Number of points in each class.
+   * @param sumSquares Sum of squared deviations of each feature in each class.
+   */
+  template<typename MatType>
+  void UpdateStatistics(const MatType& data,
+                        const arma::Row<size_t>& labels,
+                        ModelMatType& counts,
+                        ModelMatType& sumSquares);
+
+  /**
+   * Set the variances and probabilities of the model from the given class
+   * counts and sums of squared deviations.
+   *
+   * @param counts Number of points in each class.
+   * @param sumSquares Sum of squared deviations of each feature in each class.
+   */
+  void Normalize(const ModelMatType& counts, ModelMatType& sumSquares);
+
   /**
    * Compute the unnormalized posterior log probability of given points (log
    * likelihood). Results are returned as arma::mat, and each column represents
-   * a point, each row represents log likelihood of a class.
+   * a point, each row represents log likelihood of a class.  This is computed
+   * for all points and classes at once with two matrix multiplications.
    *
    * @param data Set of points to compute posterior log probability for.
    * @param logLikelihoods Matrix to store log likelihoods in.
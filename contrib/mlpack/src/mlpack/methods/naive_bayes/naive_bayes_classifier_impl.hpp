@@ -106,73 +106,64 @@ void NaiveBayesClassifier<ModelMatType>::Train(
   }
 
   // Calculate the class probabilities as well as the sample mean and variance
-  // for each of the features with respect to each of the labels.
+  // for each of the features with respect to each of the labels.  The
+  // incremental algorithm starts from the current model; otherwise we start
+  // from an empty model.
+  ModelMatType counts, sumSquares;
   if (incremental)
   {
-    // Use incremental algorithm.
-    // Fist, de-normalize probabilities.
-    probabilities *= trainingPoints;
-
-    for (size_t j = 0; j < data.n_cols; ++j)
-    {
-      const size_t label = labels[j];
-      ++probabilities[label];
-
-      arma::vec delta = data.col(j) - means.col(label);
-      means.col(label) += delta / probabilities[label];
-      variances.col(label) += delta % (data.col(j) - means.col(label));
-    }
-
-    for (size_t i = 0; i < probabilities.n_elem; ++i)
-    {
-      if (probabilities[i] > 2)
-        variances.col(i) /= (probabilities[i] - 1);
-    }
+    Denormalize(counts, sumSquares);
   }
   else
   {
-    // Set all parameters to zero.
-    probabilities.zeros();
+    counts.zeros(probabilities.n_elem);
     means.zeros();
-    variances.zeros();
+    sumSquares.zeros(means.n_rows, means.n_cols);
+  }
 
-    // Don't use incremental algorithm.  This is a two-pass algorithm.  It is
-    // possible to calculate the means and variances using a faster one-pass
-    // algorithm but there are some precision and stability issues.  If this is
-    // too slow, it's an option to use the faster algorithm by default and then
-    // have this (and the incremental algorithm) be other options.
+  UpdateStatistics(data, labels, counts, sumSquares);
+  Normalize(counts, sumSquares);
+}
 
-    // Calculate the means.
-    for (size_t j = 0; j < data.n_cols; ++j)
-    {
-      const size_t label = labels[j];
-      ++probabilities[label];
-      means.col(label) += data.col(j);
-    }
+template<typename ModelMatType>
+template<typename ChunkSourceType>
+void NaiveBayesClassifier<ModelMatType>::Train(
+    ChunkSourceType& source,
+    const size_t numClasses,
+    const bool incremental,
+    const std::enable_if_t<!arma::is_arma_type<ChunkSourceType>::value>*)
+{
+  ModelMatType chunk;
+  arma::Row<size_t> chunkLabels;
 
-    // Normalize means.
-    for (size_t i = 0; i < probabilities.n_elem; ++i)
-      if (probabilities[i] != 0.0)
-        means.col(i) /= probabilities[i];
+  ModelMatType counts, sumSquares;
+  bool initialized = false;
+  while (source(chunk, chunkLabels))
+  {
+    if (chunk.n_cols == 0)
+      continue;
 
-    // Calculate variances.
-    for (size_t j = 0; j < data.n_cols; ++j)
+    if (!initialized)
     {
-      const size_t label = labels[j];
-      variances.col(label) += square(data.col(j) - means.col(label));
+      if (incremental && probabilities.n_elem == numClasses)
+      {
+        Denormalize(counts, sumSquares);
+      }
+      else
+      {
+        counts.zeros(numClasses);
+        means.zeros(chunk.n_rows, numClasses);
+        sumSquares.zeros(chunk.n_rows, numClasses);
+      }
+
+      initialized = true;
     }
 
-    // Normalize variances.
-    for (size_t i = 0; i < probabilities.n_elem; ++i)
-      if (probabilities[i] > 1)
-        variances.col(i) /= (probabilities[i] - 1);
+    UpdateStatistics(chunk, chunkLabels, counts, sumSquares);
   }
 
-  // Add epsilon to prevent log of zero.
-  variances += epsilon;
-
-  probabilities /= data.n_cols;
-  trainingPoints += data.n_cols;
+  if (initialized)
+    Normalize(counts, sumSquares);
 }
 
 template<typename ModelMatType>
@@ -200,6 +191,108 @@ void NaiveBayesClassifier<ModelMatType>::Train(const VecType& point,
   probabilities /= trainingPoints;
 }
 
+template<typename ModelMatType>
+void NaiveBayesClassifier<ModelMatType>::Denormalize(
+    ModelMatType& counts,
+    ModelMatType& sumSquares) const
+{
+  counts = probabilities * trainingPoints;
+  sumSquares = variances;
+  for (size_t i = 0; i < counts.n_elem; ++i)
+    if (counts[i] > 1)
+      sumSquares.col(i) *= (counts[i] - 1);
+}
+
+template<typename ModelMatType>
+template<typename MatType>
+void NaiveBayesClassifier<ModelMatType>::UpdateStatistics(
+    const MatType& data,
+    const arma::Row<size_t>& labels,
+    ModelMatType& counts,
+    ModelMatType& sumSquares)
+{
+  // First compute the count and the mean of each class in the new data.  This
+  // is a two-pass algorithm; it is possible to calculate the means and
+  // variances in one pass but there are some precision and stability issues.
+  ModelMatType dataCounts(counts.n_elem, 1, arma::fill::zeros);
+  ModelMatType dataMeans(means.n_rows, means.n_cols, arma::fill::zeros);
+  ModelMatType dataSumSquares(means.n_rows, means.n_cols, arma::fill::zeros);
+
+  #pragma omp parallel
+  {
+    // Each thread accumulates its own block of points.
+    ModelMatType localCounts(counts.n_elem, 1, arma::fill::zeros);
+    ModelMatType localSums(means.n_rows, means.n_cols, arma::fill::zeros);
+
+    #pragma omp for schedule(static)
+    for (omp_size_t j = 0; j < (omp_size_t) data.n_cols; ++j)
+    {
+      const size_t label = labels[j];
+      ++localCounts[label];
+      localSums.col(label) += data.col(j);
+    }
+
+    #pragma omp critical
+    {
+      dataCounts += localCounts;
+      dataMeans += localSums;
+    }
+  }
+
+  for (size_t i = 0; i < dataCounts.n_elem; ++i)
+    if (dataCounts[i] != 0.0)
+      dataMeans.col(i) /= dataCounts[i];
+
+  // Now calculate the sum of squared deviations from the mean.
+  #pragma omp parallel
+  {
+    ModelMatType localSumSquares(means.n_rows, means.n_cols,
+        arma::fill::zeros);
+
+    #pragma omp for schedule(static)
+    for (omp_size_t j = 0; j < (omp_size_t) data.n_cols; ++j)
+    {
+      const size_t label = labels[j];
+      localSumSquares.col(label) += arma::square(data.col(j) -
+          dataMeans.col(label));
+    }
+
+    #pragma omp critical
+    dataSumSquares += localSumSquares;
+  }
+
+  // Finally, merge the statistics of the data into the given statistics.
+  for (size_t i = 0; i < counts.n_elem; ++i)
+  {
+    if (dataCounts[i] == 0.0)
+      continue;
+
+    const ElemType total = counts[i] + dataCounts[i];
+    const arma::Col<ElemType> delta = dataMeans.col(i) - means.col(i);
+    means.col(i) += delta * (dataCounts[i] / total);
+    sumSquares.col(i) += dataSumSquares.col(i) + arma::square(delta) *
+        (counts[i] * dataCounts[i] / total);
+    counts[i] = total;
+  }
+}
+
+template<typename ModelMatType>
+void NaiveBayesClassifier<ModelMatType>::Normalize(
+    const ModelMatType& counts,
+    ModelMatType& sumSquares)
+{
+  variances = std::move(sumSquares);
+  for (size_t i = 0; i < counts.n_elem; ++i)
+    if (counts[i] > 1)
+      variances.col(i) /= (counts[i] - 1);
+
+  // Add epsilon to prevent log of zero.
+  variances += epsilon;
+
+  trainingPoints = (size_t) std::round(arma::accu(counts));
+  probabilities = counts / arma::accu(counts);
+}
+
 template<typename ModelMatType>
 template<typename MatType>
 void NaiveBayesClassifier<ModelMatType>::LogLikelihood(
@@ -210,24 +303,20 @@ void NaiveBayesClassifier<ModelMatType>::LogLikelihood(
       "NaiveBayesClassifier: element type of given data must match the element "
       "type of the model!");
 
-  logLikelihoods = arma::log(arma::repmat(probabilities, 1, data.n_cols));
-  ModelMatType invVar = 1.0 / variances;
-
-  // Calculate the joint log likelihood of point for each of the
-  // means.n_cols.
-
-  // Loop over every class.
-  for (size_t i = 0; i < means.n_cols; ++i)
-  {
-    // This is an adaptation of gmm::phi() for the case where the covariance is
-    // a diagonal matrix.
-    ModelMatType diffs = data - arma::repmat(means.col(i), 1, data.n_cols);
-    ModelMatType rhs = -0.5 * arma::diagmat(invVar.col(i)) * diffs;
-    arma::Mat<ElemType> exponents = arma::sum(diffs % rhs, 0);
-
-    logLikelihoods.row(i) += (data.n_rows / -2.0 * log(2 * M_PI) - 0.5 *
-        arma::accu(arma::log(variances.col(i))) + exponents);
-  }
+  // This is an adaptation of gmm::phi() for the case where the covariance is a
+  // diagonal matrix.  Expanding the exponent,
+  //   (x - mu)' D^-1 (x - mu) = (1 / var)' x^2 - 2 (mu / var)' x + mu' D^-1 mu,
+  // so the exponents of all classes for all points are given by two matrix
+  // multiplications, plus a constant term for each class.
+  const ModelMatType invVar = 1.0 / variances;
+  const ModelMatType constants = arma::log(probabilities) -
+      0.5 * (data.n_rows * std::log(2 * M_PI) +
+      arma::sum(arma::log(variances), 0).t() +
+      arma::sum(arma::square(means) % invVar, 0).t());
+
+  logLikelihoods = (means % invVar).t() * data -
+      0.5 * (invVar.t() * arma::square(data));
+  logLikelihoods.each_col() += constants.col(0);
 }
 
 template<typename ModelMatType>
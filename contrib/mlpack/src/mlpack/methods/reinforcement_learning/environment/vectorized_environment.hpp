@@ -0,0 +1,212 @@
+/**
+ * @file methods/reinforcement_learning/environment/vectorized_environment.hpp
+ *
+ * This file is the definition of the VectorizedEnvironment class, which steps
+ * several copies of an environment in lockstep.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_ENVIRONMENT_VECTORIZED_ENVIRONMENT_HPP
+#define MLPACK_METHODS_RL_ENVIRONMENT_VECTORIZED_ENVIRONMENT_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace rl {
+
+/**
+ * A VectorizedEnvironment holds several copies of an environment and steps all
+ * of them at once, so that an agent can select the actions of all copies with
+ * one forward pass of its network (see `QLearning::Rollout()`).  The copies are
+ * stepped in parallel when OpenMP is enabled.  When an episode of a copy ends,
+ * the copy is reset with `InitialSample()` right away, so that every copy is
+ * always in a non-terminal state.
+ *
+ * @code
+ * VectorizedEnvironment<CartPole> envs(8);
+ * std::vector<CartPole::Action> actions(envs.NumEnvironments());
+ * // ... select an action for each column of envs.EncodedStates() ...
+ * envs.Step(actions);
+ * // envs.PreviousStates()[i], actions[i], envs.Rewards()[i],
+ * // envs.NextStates()[i] and envs.IsTerminal()[i] form the transition of the
+ * // i-th copy.
+ * @endcode
+ *
+ * The `Sample()` functions of the copies are called from several threads at
+ * once, as the workers of `AsyncLearning` do, so they must not modify state
+ * that the copies share.  Resets are done sequentially.
+ *
+ * @tparam EnvironmentType The environment to hold copies of.
+ */
+template<typename EnvironmentType>
+class VectorizedEnvironment
+{
+ public:
+  //! Convenient typedef for state.
+  using StateType = typename EnvironmentType::State;
+
+  //! Convenient typedef for action.
+  using ActionType = typename EnvironmentType::Action;
+
+  /**
+   * Create the given number of copies of the given environment, and reset all
+   * of them.
+   *
+   * @param numEnvironments Number of copies of the environment.
+   * @param environment Environment to copy.
+   */
+  VectorizedEnvironment(const size_t numEnvironments,
+                        const EnvironmentType& environment = EnvironmentType());
+
+  /**
+   * Reset all copies, and start a new episode in each of them.
+   */
+  void InitialSample();
+
+  /**
+   * Take one step in each copy, with the given actions.  Copies whose episode
+   * ends are reset.
+   *
+   * @param actions Action to take in each copy.
+   */
+  void Step(const std::vector<ActionType>& actions);
+
+  //! Get the number of copies of the environment.
+  size_t NumEnvironments() const { return environments.size(); }
+
+  //! Get the copies of the environment.
+  const std::vector<EnvironmentType>& Environments() const
+  { return environments; }
+  //! Modify the copies of the environment.
+  std::vector<EnvironmentType>& Environments() { return environments; }
+
+  //! Get the current state of each copy.
+  const std::vector<StateType>& States() const { return states; }
+  //! Get the current states of the copies, encoded as columns.
+  const arma::mat& EncodedStates() const { return encodedStates; }
+
+  //! Get the state of each copy before the last step.
+  const std::vector<StateType>& PreviousStates() const
+  { return previousStates; }
+  //! Get the state of each copy after the last step (before any reset).
+  const std::vector<StateType>& NextStates() const { return nextStates; }
+  //! Get the reward of each copy for the last step.
+  const arma::rowvec& Rewards() const { return rewards; }
+  //! Get whether the last step ended the episode of each copy.
+  const arma::irowvec& IsTerminal() const { return isTerminal; }
+
+  //! Get the returns of the episodes that ended during the last step.
+  const std::vector<double>& EpisodeReturns() const { return episodeReturns; }
+
+ private:
+  //! The copies of the environment.
+  std::vector<EnvironmentType> environments;
+
+  //! Current state of each copy.
+  std::vector<StateType> states;
+
+  //! Current states of the copies, encoded as columns.
+  arma::mat encodedStates;
+
+  //! State of each copy before the last step.
+  std::vector<StateType> previousStates;
+
+  //! State of each copy after the last step.
+  std::vector<StateType> nextStates;
+
+  //! Reward of each copy for the last step.
+  arma::rowvec rewards;
+
+  //! Whether the last step ended the episode of each copy.
+  arma::irowvec isTerminal;
+
+  //! Return of the current episode of each copy so far.
+  arma::rowvec returns;
+
+  //! Returns of the episodes that ended during the last step.
+  std::vector<double> episodeReturns;
+};
+
+template<typename EnvironmentType>
+VectorizedEnvironment<EnvironmentType>::VectorizedEnvironment(
+    const size_t numEnvironments,
+    const EnvironmentType& environment) :
+    environments(numEnvironments, environment),
+    states(numEnvironments),
+    previousStates(numEnvironments),
+    nextStates(numEnvironments),
+    rewards(numEnvironments, arma::fill::zeros),
+    isTerminal(numEnvironments, arma::fill::zeros),
+    returns(numEnvironments, arma::fill::zeros)
+{
+  if (numEnvironments == 0)
+  {
+    throw std::invalid_argument("VectorizedEnvironment: the number of "
+        "environments must be positive!");
+  }
+
+  InitialSample();
+}
+
+template<typename EnvironmentType>
+void VectorizedEnvironment<EnvironmentType>::InitialSample()
+{
+  for (size_t i = 0; i < environments.size(); ++i)
+    states[i] = environments[i].InitialSample();
+
+  encodedStates.set_size(states[0].Encode().n_elem, states.size());
+  for (size_t i = 0; i < states.size(); ++i)
+    encodedStates.col(i) = states[i].Encode();
+
+  returns.zeros();
+  episodeReturns.clear();
+}
+
+template<typename EnvironmentType>
+void VectorizedEnvironment<EnvironmentType>::Step(
+    const std::vector<ActionType>& actions)
+{
+  if (actions.size() != environments.size())
+  {
+    std::ostringstream oss;
+    oss << "VectorizedEnvironment::Step(): " << actions.size() << " actions "
+        << "given for " << environments.size() << " environments!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) environments.size(); ++i)
+  {
+    rewards[i] = environments[i].Sample(states[i], actions[i], nextStates[i]);
+    isTerminal[i] = environments[i].IsTerminal(nextStates[i]);
+    returns[i] += rewards[i];
+  }
+
+  // Reset the copies whose episode ended.  This is done sequentially, since
+  // InitialSample() draws random numbers.
+  episodeReturns.clear();
+  for (size_t i = 0; i < environments.size(); ++i)
+  {
+    std::swap(previousStates[i], states[i]);
+    if (isTerminal[i])
+    {
+      episodeReturns.push_back(returns[i]);
+      returns[i] = 0.0;
+      states[i] = environments[i].InitialSample();
+    }
+    else
+    {
+      states[i] = nextStates[i];
+    }
+
+    encodedStates.col(i) = states[i].Encode();
+  }
+}
+
+} // namespace rl
+} // namespace mlpack
+
+#endif
@@ -84,6 +84,38 @@ class GreedyPolicy
     return action;
   }
 
+  /**
+   * Sample an action for each column of the given action values, as Sample()
+   * does for a single column.
+   *
+   * @param actionValues Values for each action (rows) of each state (columns).
+   * @param actions Sampled actions, one for each column.
+   * @param deterministic Always select the actions greedily.
+   * @param isNoisy Specifies whether the network used is noisy.
+   */
+  void Sample(const arma::mat& actionValues,
+              std::vector<ActionType>& actions,
+              bool deterministic = false,
+              const bool isNoisy = false)
+  {
+    const arma::urowvec bestActions = arma::index_max(actionValues, 0);
+    actions.resize(actionValues.n_cols);
+    for (size_t i = 0; i < actionValues.n_cols; ++i)
+    {
+      const double exploration = math::Random();
+      if (!deterministic && exploration < epsilon && isNoisy == false)
+      {
+        actions[i].action = static_cast<decltype(actions[i].action)>
+            (math::RandInt(ActionType::size));
+      }
+      else
+      {
+        actions[i].action =
+            static_cast<decltype(actions[i].action)>(bestActions[i]);
+      }
+    }
+  }
+
   /**
    * Exploration probability will anneal at each step.
    */
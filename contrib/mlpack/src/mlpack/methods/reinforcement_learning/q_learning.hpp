@@ -16,6 +16,7 @@
 #include <mlpack/prereqs.hpp>
 #include <ensmallen.hpp>
 
+#include "environment/vectorized_environment.hpp"
 #include "replay/random_replay.hpp"
 #include "replay/prioritized_replay.hpp"
 #include "training_config.hpp"
@@ -111,6 +112,23 @@ class QLearning
    */
   double Episode();
 
+  /**
+   * Take the given number of steps in each of the given copies of the
+   * environment.  At each step, the actions of all copies are selected with one
+   * forward pass of the learning network, the copies are stepped in parallel,
+   * and their transitions are stored in the replay memory at once; then the
+   * agent is trained once for each transition, as in Episode().  The behavior
+   * policy and the replay method must support batches (as `GreedyPolicy` and
+   * `RandomReplay` do).
+   *
+   * @param environments Copies of the environment to step.
+   * @param steps Number of steps to take in each copy.
+   * @return Returns of the episodes that ended.
+   */
+  std::vector<double> Rollout(
+      VectorizedEnvironment<EnvironmentType>& environments,
+      const size_t steps);
+
   //! Modify total steps from beginning.
   size_t& TotalSteps() { return totalSteps; }
   //! Get total steps from beginning.
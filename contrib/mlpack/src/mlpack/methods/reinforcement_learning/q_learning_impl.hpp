@@ -387,6 +387,57 @@ double QLearning<
   return totalReturn;
 }
 
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename BehaviorPolicyType,
+  typename ReplayType
+>
+std::vector<double> QLearning<
+  EnvironmentType,
+  NetworkType,
+  UpdaterType,
+  BehaviorPolicyType,
+  ReplayType
+>::Rollout(VectorizedEnvironment<EnvironmentType>& environments,
+           const size_t steps)
+{
+  std::vector<double> returns;
+  arma::mat actionValues;
+  std::vector<ActionType> actions;
+  for (size_t step = 0; step < steps; ++step)
+  {
+    // Select the actions of all environments at once.
+    learningNetwork.Predict(environments.EncodedStates(), actionValues);
+    policy.Sample(actionValues, actions, deterministic,
+        config.NoisyQLearning());
+
+    environments.Step(actions);
+    returns.insert(returns.end(), environments.EpisodeReturns().begin(),
+        environments.EpisodeReturns().end());
+
+    // Store the transitions for replay.
+    replayMethod.Store(environments.PreviousStates(), actions,
+        environments.Rewards(), environments.NextStates(),
+        environments.IsTerminal(), config.Discount());
+
+    for (size_t i = 0; i < environments.NumEnvironments(); ++i)
+    {
+      totalSteps++;
+
+      if (deterministic || totalSteps < config.ExplorationSteps())
+        continue;
+      if (config.IsCategorical())
+        TrainCategoricalAgent();
+      else
+        TrainAgent();
+    }
+  }
+
+  return returns;
+}
+
 } // namespace rl
 } // namespace mlpack
 
@@ -27,6 +27,10 @@ namespace rl {
  * train the agent. Typically this would be a random sample and
  * the memory will be a First-In-First-Out buffer.
  *
+ * The memory is allocated once, when the object is constructed, and is used as
+ * a ring buffer.  Transitions of several environments stepped in lockstep can
+ * be stored with one call to `Store()`.
+ *
  * For more information, see the following.
  *
  * @code
@@ -108,6 +112,13 @@ class RandomReplay
              bool isEnd,
              const double& discount)
   {
+    // One-step transitions need no buffering.
+    if (nSteps == 1)
+    {
+      Insert(state, action, reward, nextState, isEnd);
+      return;
+    }
+
     nStepBuffer.push_back({state, action, reward, nextState, isEnd});
 
     // Single step transition is not ready.
@@ -124,19 +135,65 @@ class RandomReplay
     // Make a n-step transition.
     GetNStepInfo(reward, nextState, isEnd, discount);
 
-    state = nStepBuffer.front().state;
-    action = nStepBuffer.front().action;
+    Insert(nStepBuffer.front().state, nStepBuffer.front().action, reward,
+        nextState, isEnd);
+  }
 
-    states.col(position) = state.Encode();
-    actions[position] = action;
-    rewards(position) = reward;
-    nextStates.col(position) = nextState.Encode();
-    isTerminal(position) = isEnd;
-    position++;
-    if (position == capacity)
+  /**
+   * Store one transition of each of several environments that are stepped in
+   * lockstep, e.g. by a `VectorizedEnvironment`.  The i-th transition is given
+   * by the i-th element of each argument.  For n-step transitions, the
+   * transitions of each environment are buffered separately, so the
+   * environments must be given in the same order at each call.
+   *
+   * @param batchStates Given states.
+   * @param batchActions Given actions.
+   * @param batchRewards Given rewards.
+   * @param batchNextStates Given next states.
+   * @param batchIsEnd Whether each next state is a terminal state.
+   * @param discount The discount parameter.
+   */
+  void Store(const std::vector<StateType>& batchStates,
+             const std::vector<ActionType>& batchActions,
+             const arma::rowvec& batchRewards,
+             const std::vector<StateType>& batchNextStates,
+             const arma::irowvec& batchIsEnd,
+             const double& discount)
+  {
+    const size_t n = batchStates.size();
+
+    // One-step transitions need no buffering.
+    if (nSteps == 1)
     {
-      full = true;
-      position = 0;
+      for (size_t i = 0; i < n; ++i)
+      {
+        Insert(batchStates[i], batchActions[i], batchRewards[i],
+            batchNextStates[i], batchIsEnd[i]);
+      }
+      return;
+    }
+
+    if (streamBuffers.size() != n)
+      streamBuffers.resize(n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+      std::deque<Transition>& buffer = streamBuffers[i];
+      buffer.push_back({ batchStates[i], batchActions[i], batchRewards[i],
+          batchNextStates[i], (bool) batchIsEnd[i] });
+
+      if (buffer.size() < nSteps)
+        continue;
+      if (buffer.size() > nSteps)
+        buffer.pop_front();
+
+      double reward;
+      StateType nextState;
+      bool isEnd;
+      GetNStepInfo(buffer, reward, nextState, isEnd, discount);
+
+      Insert(buffer.front().state, buffer.front().action, reward, nextState,
+          isEnd);
     }
   }
 
@@ -153,21 +210,7 @@ class RandomReplay
                     bool& isEnd,
                     const double& discount)
   {
-    reward = nStepBuffer.back().reward;
-    nextState = nStepBuffer.back().nextState;
-    isEnd = nStepBuffer.back().isEnd;
-
-    // Should start from the second last transition in buffer.
-    for (int i = nStepBuffer.size() - 2; i >= 0; i--)
-    {
-      bool iE = nStepBuffer[i].isEnd;
-      reward = nStepBuffer[i].reward + discount * reward * (1 - iE);
-      if (iE)
-      {
-        nextState = nStepBuffer[i].nextState;
-        isEnd = iE;
-      }
-    }
+    GetNStepInfo(nStepBuffer, reward, nextState, isEnd, discount);
   }
 
   /**
@@ -191,8 +234,9 @@ class RandomReplay
         batchSize, arma::distr_param(0, upperBound - 1));
 
     sampledStates = states.cols(sampledIndices);
+    sampledActions.resize(sampledIndices.n_rows);
     for (size_t t = 0; t < sampledIndices.n_rows; t ++)
-      sampledActions.push_back(actions[sampledIndices[t]]);
+      sampledActions[t] = actions[sampledIndices[t]];
     sampledRewards = rewards.elem(sampledIndices).t();
     sampledNextStates = nextStates.cols(sampledIndices);
     isTerminal = this->isTerminal.elem(sampledIndices).t();
@@ -228,6 +272,53 @@ class RandomReplay
   const size_t& NSteps() const { return nSteps; }
 
  private:
+  /**
+   * Get the reward, next state and terminal boolean for nth step from the
+   * given buffer of n consecutive steps.
+   */
+  static void GetNStepInfo(const std::deque<Transition>& buffer,
+                           double& reward,
+                           StateType& nextState,
+                           bool& isEnd,
+                           const double& discount)
+  {
+    reward = buffer.back().reward;
+    nextState = buffer.back().nextState;
+    isEnd = buffer.back().isEnd;
+
+    // Should start from the second last transition in buffer.
+    for (int i = buffer.size() - 2; i >= 0; i--)
+    {
+      bool iE = buffer[i].isEnd;
+      reward = buffer[i].reward + discount * reward * (1 - iE);
+      if (iE)
+      {
+        nextState = buffer[i].nextState;
+        isEnd = iE;
+      }
+    }
+  }
+
+  //! Write the given transition at the current position of the memory.
+  void Insert(const StateType& state,
+              const ActionType& action,
+              const double reward,
+              const StateType& nextState,
+              const bool isEnd)
+  {
+    states.col(position) = state.Encode();
+    actions[position] = action;
+    rewards(position) = reward;
+    nextStates.col(position) = nextState.Encode();
+    isTerminal(position) = isEnd;
+    position++;
+    if (position == capacity)
+    {
+      full = true;
+      position = 0;
+    }
+  }
+
   //! Locally-stored number of examples of each sample.
   size_t batchSize;
 
@@ -246,6 +337,10 @@ class RandomReplay
   //! Locally-stored buffer containing n consecutive steps.
   std::deque<Transition> nStepBuffer;
 
+  //! Locally-stored buffers of n consecutive steps of each environment, for
+  //! transitions stored in batches.
+  std::vector<std::deque<Transition>> streamBuffers;
+
   //! Locally-stored encoded previous states.
   arma::mat states;
 
@@ -14,10 +14,19 @@
 #define MLPACK_METHODS_SOFTMAX_REGRESSION_SOFTMAX_REGRESSION_FUNCTION_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/make_alias.hpp>
+#include <mlpack/core/math/shuffle_data.hpp>
+#include <mlpack/core/math/lazy_regularization.hpp>
 
 namespace mlpack {
 namespace regression {
 
+/**
+ * The objective function for softmax regression.
+ *
+ * @tparam MatType Type of data matrix (i.e. arma::mat or arma::sp_mat).
+ */
+template<typename MatType = arma::mat>
 class SoftmaxRegressionFunction
 {
  public:
@@ -31,7 +40,7 @@ class SoftmaxRegressionFunction
    * @param lambda L2-regularization constant.
    * @param fitIntercept Intercept term flag.
    */
-  SoftmaxRegressionFunction(const arma::mat& data,
+  SoftmaxRegressionFunction(const MatType& data,
                             const arma::Row<size_t>& labels,
                             const size_t numClasses,
                             const double lambda = 0.0001,
@@ -145,10 +154,35 @@ class SoftmaxRegressionFunction
    * @param gradient Matrix to store gradient into.
    * @param batchSize Number of data points to evaluate gradient for.
    */
+  template<typename GradType>
+  void Gradient(const arma::mat& parameters,
+                const size_t start,
+                GradType& gradient,
+                const size_t batchSize = 1,
+                const std::enable_if_t<!arma::is_SpMat<GradType>::value>* = 0)
+      const;
+
+  /**
+   * Evaluate the gradient of the objective function given the current set of
+   * parameters, on a subset of the data, into a sparse matrix.  Only the
+   * features that appear in the batch (and the intercept, if it is fitted)
+   * receive a gradient, and the L2 penalty is applied lazily to those
+   * coordinates only.  When the data is sparse, the cost of this is
+   * proportional to the number of nonzeros in the batch times the number of
+   * classes.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param start First index of the data points to use.
+   * @param gradient Sparse matrix to store gradient into.
+   * @param batchSize Number of data points to evaluate gradient for.
+   */
+  template<typename GradType>
   void Gradient(const arma::mat& parameters,
                 const size_t start,
-                arma::mat& gradient,
-                const size_t batchSize = 1) const;
+                GradType& gradient,
+                const size_t batchSize = 1,
+                const std::enable_if_t<arma::is_SpMat<GradType>::value>* = 0)
+      const;
 
   /**
    * Evaluates the gradient values of the objective function given the current
@@ -189,7 +223,7 @@ class SoftmaxRegressionFunction
 
  private:
   //! Training data matrix.  This is an alias until the data is shuffled.
-  arma::mat data;
+  MatType data;
   //! Label matrix for the provided data.
   arma::sp_mat groundTruth;
   //! Initial parameter point.
@@ -205,4 +239,7 @@ class SoftmaxRegressionFunction
 } // namespace regression
 } // namespace mlpack
 
+// Include implementation.
+#include "softmax_regression_function_impl.hpp"
+
 #endif
@@ -13,6 +13,8 @@
 #include <mlpack/core.hpp>
 
 #include <mlpack/methods/ann/layer/layer_types.hpp>
+#include <mlpack/methods/ann/loss_functions/mean_squared_error.hpp>
+#include <mlpack/methods/ann/ffn.hpp>
 #include <mlpack/methods/ann/activation_functions/logistic_function.hpp>
 #include <mlpack/methods/ann/activation_functions/identity_function.hpp>
 #include <mlpack/methods/ann/activation_functions/softsign_function.hpp>
@@ -35,6 +37,7 @@
 #include <mlpack/methods/ann/activation_functions/hard_swish_function.hpp>
 #include <mlpack/methods/ann/activation_functions/tanh_exponential_function.hpp>
 #include <mlpack/methods/ann/activation_functions/silu_function.hpp>
+#include <mlpack/methods/ann/activation_functions/fast_activation_functions.hpp>
 
 #include "catch.hpp"
 
@@ -1379,3 +1382,118 @@ TEST_CASE("FlattenTSwishFunctionTest", "[ActivationFunctionsTest]")
   CheckFlattenTSwishActivationCorrect(input, desiredActivation);
   CheckFlattenTSwishDerivateCorrect(desiredActivation, desiredDerivation);
 }*/
+
+/**
+ * Check that an approximate activation function and its derivative are close
+ * to the exact ones, in double and single precision.
+ *
+ * @tparam FastFunction Approximate activation function.
+ * @tparam ExactFunction Exact activation function.
+ */
+template<class FastFunction, class ExactFunction>
+void CheckFastActivation(const double tolerance)
+{
+  const arma::colvec input = arma::linspace<arma::colvec>(-20, 20, 4001);
+  arma::colvec exact, fast, exactDerivative, fastDerivative;
+  ExactFunction::Fn(input, exact);
+  FastFunction::Fn(input, fast);
+  ExactFunction::Deriv(input, exactDerivative);
+  FastFunction::Deriv(input, fastDerivative);
+
+  const arma::fcolvec floatInput = arma::conv_to<arma::fcolvec>::from(input);
+  arma::fcolvec floatFast, floatFastDerivative;
+  FastFunction::Fn(floatInput, floatFast);
+  FastFunction::Deriv(floatInput, floatFastDerivative);
+
+  for (size_t i = 0; i < input.n_elem; ++i)
+  {
+    const double scale = std::max(1.0, std::abs(exact(i)));
+    const double derivativeScale = std::max(1.0, std::abs(exactDerivative(i)));
+    REQUIRE(std::abs(fast(i) - exact(i)) <= tolerance * scale);
+    REQUIRE(std::abs(fastDerivative(i) - exactDerivative(i)) <=
+        tolerance * derivativeScale);
+    REQUIRE(FastFunction::Fn(input(i)) == Approx(fast(i)).epsilon(1e-12));
+
+    // Single precision is only accurate to about 1e-7.
+    REQUIRE(std::abs(floatFast(i) - exact(i)) <= 1e-5 * scale);
+    REQUIRE(std::abs(floatFastDerivative(i) - exactDerivative(i)) <=
+        1e-5 * derivativeScale);
+  }
+}
+
+/**
+ * Make sure that the approximate activation functions are close to the exact
+ * ones.
+ */
+TEST_CASE("FastActivationFunctionsTest", "[ActivationFunctionsTest]")
+{
+  CheckFastActivation<FastLogisticFunction, LogisticFunction>(1e-8);
+  CheckFastActivation<FastTanhFunction, TanhFunction>(1e-8);
+  CheckFastActivation<FastSoftplusFunction, SoftplusFunction>(1e-8);
+  CheckFastActivation<FastSwishFunction, SwishFunction>(1e-8);
+  CheckFastActivation<FastSwishFunction, SILUFunction>(1e-8);
+  CheckFastActivation<FastGELUFunction, GELUFunction>(1e-8);
+  CheckFastActivation<FastMishFunction, MishFunction>(1e-8);
+
+  // Check the tails of the underlying approximations too.
+  const arma::colvec x("-1000 -700 -80 -1e-6 0 1e-6 80 700 1000");
+  for (size_t i = 0; i < x.n_elem; ++i)
+  {
+    REQUIRE(std::isfinite(FastExp(x(i))));
+    REQUIRE(FastTanh(x(i)) == Approx(std::tanh(x(i))).epsilon(1e-8));
+    // SoftplusFunction gives 0 for large negative x, so use log1p() instead.
+    const double softplus = std::max(x(i), 0.0) +
+        std::log1p(std::exp(-std::abs(x(i))));
+    REQUIRE(FastSoftplus(x(i)) ==
+        Approx(softplus).epsilon(1e-8).margin(1e-300));
+  }
+
+  const arma::colvec y("1e-300 1e-10 0.5 1 1.4142 2 1e10 1e300");
+  for (size_t i = 0; i < y.n_elem; ++i)
+    REQUIRE(FastLog(y(i)) ==
+        Approx(std::log(y(i))).epsilon(1e-9).margin(1e-9));
+}
+
+/**
+ * Make sure that a network with approximate activations gives nearly the same
+ * predictions as the same network with exact activations.
+ */
+TEST_CASE("FastActivationLayersTest", "[ActivationFunctionsTest]")
+{
+  FFN<MeanSquaredError, RandomInitialization> model;
+  model.Add<Linear>(10);
+  model.Add<Sigmoid>();
+  model.Add<Linear>(10);
+  model.Add<TanH>();
+  model.Add<Linear>(10);
+  model.Add<GELU>();
+  model.Add<Linear>(10);
+  model.Add<Mish>();
+  model.Add<Linear>(10);
+  model.Add<SoftPlus>();
+  model.Add<Linear>(2);
+  model.InputDimensions() = std::vector<size_t>({ 5 });
+  model.Reset();
+
+  FFN<MeanSquaredError, RandomInitialization> fastModel;
+  fastModel.Add<Linear>(10);
+  fastModel.Add<FastSigmoid>();
+  fastModel.Add<Linear>(10);
+  fastModel.Add<FastTanH>();
+  fastModel.Add<Linear>(10);
+  fastModel.Add<FastGELU>();
+  fastModel.Add<Linear>(10);
+  fastModel.Add<FastMish>();
+  fastModel.Add<Linear>(10);
+  fastModel.Add<FastSoftPlus>();
+  fastModel.Add<Linear>(2);
+  fastModel.InputDimensions() = std::vector<size_t>({ 5 });
+  fastModel.Parameters() = model.Parameters();
+
+  arma::mat data(5, 100, arma::fill::randn);
+  arma::mat predictions, fastPredictions;
+  model.Predict(data, predictions);
+  fastModel.Predict(data, fastPredictions);
+
+  REQUIRE(arma::abs(predictions - fastPredictions).max() < 1e-6);
+}
@@ -4707,6 +4707,79 @@ TEST_CASE("GradientConvolutionLayerTest", "[ANNLayerTest]")
   REQUIRE(CheckGradient(function) < 1e3);
 }
 
+/**
+ * Make sure that the Convolution layer, which lowers the whole batch with
+ * Im2ColConvolution, gives the same output as convolving each pair of maps
+ * with NaiveConvolution, and that its backward pass and gradient match finite
+ * differences (the layer is linear in both the input and the weights).
+ */
+TEST_CASE("Im2ColConvolutionLayerTest", "[ANNLayerTest]")
+{
+  typedef ConvolutionType<
+      NaiveConvolution<ValidConvolution>,
+      NaiveConvolution<FullConvolution>,
+      NaiveConvolution<ValidConvolution>,
+      arma::mat> NaiveConvolutionLayer;
+
+  // Parameters: stride, padding.
+  const size_t settings[4][2] = { { 1, 0 }, { 1, 1 }, { 2, 0 }, { 2, 1 } };
+  for (size_t t = 0; t < 4; ++t)
+  {
+    const size_t stride = settings[t][0];
+    const size_t pad = settings[t][1];
+
+    Convolution im2col(3, 3, 3, stride, stride, pad, pad);
+    NaiveConvolutionLayer naive(3, 3, 3, stride, stride, pad, pad);
+    im2col.InputDimensions() = std::vector<size_t>({ 7, 7, 2 });
+    naive.InputDimensions() = std::vector<size_t>({ 7, 7, 2 });
+    im2col.ComputeOutputDimensions();
+    naive.ComputeOutputDimensions();
+    REQUIRE(im2col.OutputSize() == naive.OutputSize());
+
+    arma::mat weights(im2col.WeightSize(), 1, arma::fill::randn);
+    im2col.SetWeights(weights.memptr());
+    naive.SetWeights(weights.memptr());
+
+    // Test the Forward function.
+    arma::mat input(7 * 7 * 2, 4, arma::fill::randn);
+    arma::mat output(im2col.OutputSize(), 4), naiveOutput(naive.OutputSize(),
+        4);
+    im2col.Forward(input, output);
+    naive.Forward(input, naiveOutput);
+    CheckMatrices(output, naiveOutput, 1e-8);
+
+    // Test the Backward function.
+    arma::mat error(im2col.OutputSize(), 4, arma::fill::randn);
+    arma::mat delta(arma::size(input));
+    im2col.Backward(input, error, delta);
+
+    arma::mat perturbedOutput(arma::size(output));
+    for (size_t i = 0; i < input.n_elem; ++i)
+    {
+      arma::mat perturbedInput(input);
+      perturbedInput[i] += 1e-6;
+      im2col.Forward(perturbedInput, perturbedOutput);
+      REQUIRE(delta[i] == Approx(arma::accu(error % (perturbedOutput -
+          output)) / 1e-6).margin(1e-6));
+    }
+
+    // Test the Gradient function.
+    arma::mat gradient(arma::size(weights));
+    im2col.Forward(input, output);
+    im2col.Gradient(input, error, gradient);
+
+    for (size_t i = 0; i < weights.n_elem; ++i)
+    {
+      const double weight = weights[i];
+      weights[i] += 1e-6;
+      im2col.Forward(input, perturbedOutput);
+      weights[i] = weight;
+      REQUIRE(gradient[i] == Approx(arma::accu(error % (perturbedOutput -
+          output)) / 1e-6).margin(1e-6));
+    }
+  }
+}
+
 /**
  * Test that the padding options in Transposed Convolution layer.
  *
@@ -5932,9 +6005,84 @@ TEST_CASE("JacobianPositionalEncodingTest", "[ANNLayerTest]")
 }
 */
 
+/**
+ * Compute the output of a MultiheadAttention layer with the given parameters
+ * directly from its definition, with the full matrix of attention weights.
+ */
+arma::mat NaiveMultiheadAttention(const arma::mat& parameters,
+                                  const arma::mat& input,
+                                  const size_t tgtSeqLen,
+                                  const size_t srcSeqLen,
+                                  const size_t embedDim,
+                                  const size_t numHeads,
+                                  const arma::mat& attnMask = arma::mat(),
+                                  const arma::mat& keyPaddingMask = arma::mat(),
+                                  const bool causal = false)
+{
+  const size_t wtSize = embedDim * embedDim;
+  const size_t headDim = embedDim / numHeads;
+  const arma::mat queryWt = arma::reshape(parameters.rows(0, wtSize - 1),
+      embedDim, embedDim);
+  const arma::mat keyWt = arma::reshape(parameters.rows(wtSize,
+      2 * wtSize - 1), embedDim, embedDim);
+  const arma::mat valueWt = arma::reshape(parameters.rows(2 * wtSize,
+      3 * wtSize - 1), embedDim, embedDim);
+  const arma::mat outWt = arma::reshape(parameters.rows(3 * wtSize,
+      4 * wtSize - 1), embedDim, embedDim);
+  const arma::vec qBias = parameters.rows(4 * wtSize,
+      4 * wtSize + embedDim - 1);
+  const arma::vec kBias = parameters.rows(4 * wtSize + embedDim,
+      4 * wtSize + 2 * embedDim - 1);
+  const arma::vec vBias = parameters.rows(4 * wtSize + 2 * embedDim,
+      4 * wtSize + 3 * embedDim - 1);
+  const arma::vec outBias = parameters.rows(4 * wtSize + 3 * embedDim,
+      4 * wtSize + 4 * embedDim - 1);
+
+  arma::mat output(embedDim * tgtSeqLen, input.n_cols);
+  for (size_t b = 0; b < input.n_cols; ++b)
+  {
+    const arma::mat point = arma::reshape(input.col(b), embedDim,
+        tgtSeqLen + 2 * srcSeqLen);
+    arma::mat q = queryWt * point.cols(0, tgtSeqLen - 1);
+    q.each_col() += qBias;
+    arma::mat k = keyWt * point.cols(tgtSeqLen, tgtSeqLen + srcSeqLen - 1);
+    k.each_col() += kBias;
+    arma::mat v = valueWt * point.cols(tgtSeqLen + srcSeqLen,
+        tgtSeqLen + 2 * srcSeqLen - 1);
+    v.each_col() += vBias;
+
+    arma::mat attn(embedDim, tgtSeqLen);
+    for (size_t h = 0; h < numHeads; ++h)
+    {
+      const arma::span rows(h * headDim, (h + 1) * headDim - 1);
+      arma::mat scores = q.rows(rows).t() * k.rows(rows) / std::sqrt(headDim);
+      if (!attnMask.is_empty())
+        scores += attnMask;
+      if (!keyPaddingMask.is_empty())
+        scores.each_row() += keyPaddingMask;
+      for (size_t i = 0; i < tgtSeqLen; ++i)
+      {
+        for (size_t j = i + 1; causal && j < srcSeqLen; ++j)
+          scores(i, j) = -arma::datum::inf;
+
+        scores.row(i) = arma::exp(scores.row(i) - scores.row(i).max());
+        scores.row(i) /= arma::accu(scores.row(i));
+      }
+
+      attn.rows(rows) = v.rows(rows) * scores.t();
+    }
+
+    arma::mat out = outWt * attn;
+    out.each_col() += outBias;
+    output.col(b) = arma::vectorise(out);
+  }
+
+  return output;
+}
+
 /**
  * Simple Multihead Attention test.
- *
+ */
 TEST_CASE("SimpleMultiheadAttentionTest", "[ANNLayerTest]")
 {
   size_t tLen = 5;
@@ -5962,7 +6110,10 @@ TEST_CASE("SimpleMultiheadAttentionTest", "[ANNLayerTest]")
   MultiheadAttention module(tLen, sLen, embedDim, numHeads);
   module.AttentionMask() = attnMask;
   module.KeyPaddingMask() = keyPaddingMask;
-  module.Reset();
+  module.InputDimensions() = std::vector<size_t>({ embedDim, tLen + 2 * sLen });
+  module.ComputeOutputDimensions();
+  arma::mat weights(module.WeightSize(), 1);
+  module.SetWeights(weights.memptr());
   module.Parameters().randu();
 
   // Forward test.
@@ -5971,6 +6122,18 @@ TEST_CASE("SimpleMultiheadAttentionTest", "[ANNLayerTest]")
   module.Forward(input, output);
   REQUIRE(output.n_rows == embedDim * tLen);
   REQUIRE(output.n_cols == bsz);
+  CheckMatrices(output, NaiveMultiheadAttention(module.Parameters(), input,
+      tLen, sLen, embedDim, numHeads, attnMask, keyPaddingMask), 1e-8);
+
+  // The causal mask gives the same result as the attention mask.
+  MultiheadAttention causalModule(tLen, sLen, embedDim, numHeads, arma::mat(),
+      keyPaddingMask, true);
+  causalModule.InputDimensions() = module.InputDimensions();
+  causalModule.ComputeOutputDimensions();
+  causalModule.SetWeights(weights.memptr());
+  arma::mat causalOutput;
+  causalModule.Forward(input, causalOutput);
+  CheckMatrices(output, causalOutput, 1e-8);
 
   // Backward test.
   arma::mat gy = 0.01 * arma::randu(embedDim * tLen, bsz);
@@ -5986,77 +6149,122 @@ TEST_CASE("SimpleMultiheadAttentionTest", "[ANNLayerTest]")
   REQUIRE(gradient.n_rows == module.Parameters().n_rows);
   REQUIRE(gradient.n_cols == module.Parameters().n_cols);
 }
-*/
 
 /**
- * Jacobian MultiheadAttention module test.
- *
-TEST_CASE("JacobianMultiheadAttentionTest", "[ANNLayerTest]")
+ * Check the MultiheadAttention layer against its definition for sequences that
+ * span several tiles of queries and keys.  The derivatives are checked with
+ * finite differences along random directions.
+ */
+TEST_CASE("MultiheadAttentionTilingTest", "[ANNLayerTest]")
 {
-  // Check when query = key = value.
-  for (size_t i = 0; i < 5; ++i)
-  {
-    const size_t tgtSeqLen = 2;
-    const size_t embedDim = 4;
-    const size_t nHeads = 2;
-    const size_t batchSize = 1;
-
-    arma::mat query = arma::randu(embedDim * tgtSeqLen, batchSize);
-    arma::mat input = arma::join_cols(arma::join_cols(query, query), query);
-
-    MultiheadAttention module(tgtSeqLen, tgtSeqLen, embedDim, nHeads);
-    module.Parameters().randu();
+  const size_t tgtSeqLen = 70;
+  const size_t srcSeqLen = 150;
+  const size_t embedDim = 4;
+  const size_t numHeads = 2;
+  const size_t batchSize = 2;
 
-    double error = CustomJacobianTest(module, input);
-    REQUIRE(error <= 1e-5);
-  }
+  arma::mat keyPaddingMask = arma::zeros(1, srcSeqLen);
+  keyPaddingMask.cols(140, srcSeqLen - 1).fill(-arma::datum::inf);
+  arma::mat attnMask = 0.1 * arma::randn(tgtSeqLen, srcSeqLen);
 
-  // Check when key = value.
-  for (size_t i = 0; i < 5; ++i)
+  for (size_t c = 0; c < 2; ++c)
   {
-    const size_t tgtSeqLen = 2;
-    const size_t srcSeqLen = math::RandInt(2, 5);
-    const size_t embedDim = 4;
-    const size_t nHeads = 2;
-    const size_t batchSize = 1;
+    const bool causal = (c == 1);
+    MultiheadAttention module(tgtSeqLen, srcSeqLen, embedDim, numHeads,
+        attnMask, keyPaddingMask, causal);
+    module.InputDimensions() = std::vector<size_t>({ embedDim,
+        tgtSeqLen + 2 * srcSeqLen });
+    module.ComputeOutputDimensions();
+    arma::mat weights(module.WeightSize(), 1);
+    module.SetWeights(weights.memptr());
+    module.Parameters().randn();
 
-    arma::mat query = arma::randu(embedDim * tgtSeqLen, batchSize);
-    arma::mat key = 0.091 * arma::randu(embedDim * srcSeqLen, batchSize);
-    arma::mat input = arma::join_cols(arma::join_cols(query, key), key);
+    arma::mat input = arma::randn(embedDim * (tgtSeqLen + 2 * srcSeqLen),
+        batchSize);
+    arma::mat output;
+    module.Forward(input, output);
+    CheckMatrices(output, NaiveMultiheadAttention(module.Parameters(), input,
+        tgtSeqLen, srcSeqLen, embedDim, numHeads, attnMask, keyPaddingMask,
+        causal), 1e-8);
 
-    MultiheadAttention module(tgtSeqLen, srcSeqLen, embedDim, nHeads);
-    module.Parameters().randu();
+    arma::mat gy = arma::randn(embedDim * tgtSeqLen, batchSize);
+    arma::mat g, gradient;
+    module.Backward(input, gy, g);
+    module.Gradient(input, gy, gradient);
 
-    double error = CustomJacobianTest(module, input);
-    REQUIRE(error <= 1e-5);
+    const double eps = 1e-6;
+    for (size_t trial = 0; trial < 3; ++trial)
+    {
+      // Derivative with respect to the input.
+      const arma::mat direction = arma::randn(arma::size(input));
+      const arma::mat outputPlus = NaiveMultiheadAttention(
+          module.Parameters(), input + eps * direction, tgtSeqLen, srcSeqLen,
+          embedDim, numHeads, attnMask, keyPaddingMask, causal);
+      const arma::mat outputMinus = NaiveMultiheadAttention(
+          module.Parameters(), input - eps * direction, tgtSeqLen, srcSeqLen,
+          embedDim, numHeads, attnMask, keyPaddingMask, causal);
+      const double inputDeriv = arma::accu(gy % (outputPlus - outputMinus)) /
+          (2 * eps);
+      REQUIRE(arma::accu(g % direction) ==
+          Approx(inputDeriv).epsilon(1e-5).margin(1e-5));
+
+      // Derivative with respect to the parameters.
+      const arma::mat paramDirection = arma::randn(arma::size(weights));
+      const arma::mat paramPlus = NaiveMultiheadAttention(
+          module.Parameters() + eps * paramDirection, input, tgtSeqLen,
+          srcSeqLen, embedDim, numHeads, attnMask, keyPaddingMask, causal);
+      const arma::mat paramMinus = NaiveMultiheadAttention(
+          module.Parameters() - eps * paramDirection, input, tgtSeqLen,
+          srcSeqLen, embedDim, numHeads, attnMask, keyPaddingMask, causal);
+      const double paramDeriv = arma::accu(gy % (paramPlus - paramMinus)) /
+          (2 * eps);
+      REQUIRE(arma::accu(gradient % paramDirection) ==
+          Approx(paramDeriv).epsilon(1e-5).margin(1e-5));
+    }
   }
+}
 
-  // Check when query, key and value are not same.
-  for (size_t i = 0; i < 5; ++i)
+/**
+ * Jacobian MultiheadAttention module test.
+ */
+TEST_CASE("JacobianMultiheadAttentionTest", "[ANNLayerTest]")
+{
+  // Check when query = key = value, when key = value, and when query, key and
+  // value are not same.
+  for (size_t c = 0; c < 3; ++c)
   {
-    const size_t tgtSeqLen = 2;
-    const size_t srcSeqLen = math::RandInt(2, 5);
-    const size_t embedDim = 4;
-    const size_t nHeads = 2;
-    const size_t batchSize = 1;
-
-    arma::mat query = arma::randu(embedDim * tgtSeqLen, batchSize);
-    arma::mat key = 0.091 * arma::randu(embedDim * srcSeqLen, batchSize);
-    arma::mat value = 0.045 * arma::randu(embedDim * srcSeqLen, batchSize);
-    arma::mat input = arma::join_cols(arma::join_cols(query, key), value);
-
-    MultiheadAttention module(tgtSeqLen, srcSeqLen, embedDim, nHeads);
-    module.Parameters().randu();
-
-    double error = JacobianTest(module, input);
-    REQUIRE(error <= 1e-5);
+    for (size_t i = 0; i < 5; ++i)
+    {
+      const size_t tgtSeqLen = 2;
+      const size_t srcSeqLen = (c == 0) ? tgtSeqLen : math::RandInt(2, 5);
+      const size_t embedDim = 4;
+      const size_t nHeads = 2;
+      const size_t batchSize = 1;
+
+      arma::mat query = arma::randu(embedDim * tgtSeqLen, batchSize);
+      arma::mat key = (c == 0) ? query :
+          arma::mat(0.091 * arma::randu(embedDim * srcSeqLen, batchSize));
+      arma::mat value = (c == 2) ?
+          arma::mat(0.045 * arma::randu(embedDim * srcSeqLen, batchSize)) : key;
+      arma::mat input = arma::join_cols(arma::join_cols(query, key), value);
+
+      MultiheadAttention module(tgtSeqLen, srcSeqLen, embedDim, nHeads);
+      module.InputDimensions() = std::vector<size_t>({ embedDim,
+          tgtSeqLen + 2 * srcSeqLen });
+      module.ComputeOutputDimensions();
+      arma::mat weights(module.WeightSize(), 1);
+      module.SetWeights(weights.memptr());
+      module.Parameters().randu();
+
+      double error = CustomJacobianTest(module, input);
+      REQUIRE(error <= 1e-5);
+    }
   }
 }
-*/
 
 /**
  * Numerical gradient test for MultiheadAttention layer.
- *
+ */
 TEST_CASE("GradientMultiheadAttentionTest", "[ANNLayerTest]")
 {
   struct GradientFunction
@@ -6066,41 +6274,20 @@ TEST_CASE("GradientMultiheadAttentionTest", "[ANNLayerTest]")
         srcSeqLen(2),
         embedDim(4),
         nHeads(2),
-        vocabSize(5),
+        outSize(5),
         batchSize(2)
     {
       input = arma::randu(embedDim * (tgtSeqLen + 2 * srcSeqLen), batchSize);
-      target = arma::zeros(vocabSize, batchSize);
-      for (size_t i = 0; i < target.n_elem; ++i)
-      {
-        const size_t label = mlpack::math::RandInt(1, vocabSize);
-        target(i) = label;
-      }
-
-      attnMask = arma::zeros(tgtSeqLen, srcSeqLen);
-      for (size_t i = 0; i < tgtSeqLen; ++i)
-      {
-        for (size_t j = 0; j < srcSeqLen; ++j)
-        {
-          if (i < j)
-            attnMask(i, j) = std::numeric_limits<double>::lowest();
-        }
-      }
+      target = arma::randu(outSize, batchSize);
 
       keyPaddingMask = arma::zeros(1, srcSeqLen);
       keyPaddingMask(srcSeqLen - 1) = std::numeric_limits<double>::lowest();
 
-      model = new FFN<NegativeLogLikelihood, XavierInitialization>();
+      model = new FFN<MeanSquaredError, RandomInitialization>();
       model->ResetData(input, target);
-      // attnModule = new MultiheadAttention(tgtSeqLen, srcSeqLen, embedDim,
-      //     nHeads);
-      // attnModule->AttentionMask() = attnMask;
-      // attnModule->KeyPaddingMask() = keyPaddingMask;
-      // model->Add(attnModule);
       model->Add<MultiheadAttention>(tgtSeqLen, srcSeqLen, embedDim, nHeads,
-          attnMask, keyPaddingMask);
-      model->Add<Linear>(embedDim * tgtSeqLen, vocabSize);
-      model->Add<LogSoftMax>();
+          arma::mat(), keyPaddingMask, true);
+      model->Add<Linear>(outSize);
     }
 
     ~GradientFunction()
@@ -6117,21 +6304,19 @@ TEST_CASE("GradientMultiheadAttentionTest", "[ANNLayerTest]")
 
     arma::mat& Parameters() { return model->Parameters(); }
 
-    FFN<NegativeLogLikelihood, XavierInitialization>* model;
-    // MultiheadAttention* attnModule;
+    FFN<MeanSquaredError, RandomInitialization>* model;
 
-    arma::mat input, target, attnMask, keyPaddingMask;
+    arma::mat input, target, keyPaddingMask;
     const size_t tgtSeqLen;
     const size_t srcSeqLen;
     const size_t embedDim;
     const size_t nHeads;
-    const size_t vocabSize;
+    const size_t outSize;
     const size_t batchSize;
   } function;
 
-  REQUIRE(CheckGradient(function) <= 3e-06);
+  REQUIRE(CheckGradient(function) <= 1e-6);
 }
-*/
 
 /**
  * Simple tests for instance normalization layer.
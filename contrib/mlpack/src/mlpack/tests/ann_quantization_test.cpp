@@ -0,0 +1,222 @@
+/**
+ * @file tests/ann_quantization_test.cpp
+ *
+ * Tests the 8-bit integer kernels and the post-training quantization of
+ * feedforward networks.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+
+#include <mlpack/methods/ann/layer/layer_types.hpp>
+#include <mlpack/methods/ann/ffn.hpp>
+#include <mlpack/methods/ann/quantization/quantize.hpp>
+
+#include "catch.hpp"
+#include "test_catch_tools.hpp"
+#include "serialization.hpp"
+
+using namespace mlpack;
+using namespace mlpack::ann;
+
+/**
+ * Make sure the integer matrix product is exact, for sizes that are and are not
+ * multiples of the vector width.
+ */
+TEST_CASE("Int8GemmTest", "[ANNQuantizationTest]")
+{
+  const size_t sizes[] = { 1, 15, 16, 33, 200 };
+  for (const size_t k : sizes)
+  {
+    const size_t m = 70, n = 9;
+    arma::imat a = arma::randi<arma::imat>(k, m,
+        arma::distr_param(-127, 127));
+    arma::imat b = arma::randi<arma::imat>(k, n,
+        arma::distr_param(-127, 127));
+    std::vector<int8_t> a8(a.begin(), a.end()), b8(b.begin(), b.end());
+
+    std::vector<int32_t> c(m * n);
+    Int8Gemm(a8.data(), b8.data(), c.data(), m, n, k);
+
+    const arma::imat expected = a.t() * b;
+    for (size_t j = 0; j < n; ++j)
+      for (size_t i = 0; i < m; ++i)
+        REQUIRE(c[i + j * m] == expected(i, j));
+  }
+}
+
+/**
+ * Check the weights and the output of a single QuantizedLinear layer against
+ * the float computation.
+ */
+TEST_CASE("QuantizedLinearTest", "[ANNQuantizationTest]")
+{
+  arma::mat weight(12, 40, arma::fill::randn);
+  arma::mat bias(12, 1, arma::fill::randn);
+  arma::mat input(40, 30, arma::fill::randu);
+
+  QuantizedLinear layer(weight, bias, input.max() / 127);
+  layer.InputDimensions() = std::vector<size_t>({ 40 });
+  REQUIRE(layer.OutputSize() == 12);
+
+  // Each weight is off by at most half of the scale of its row.
+  const arma::mat weightError = arma::abs(layer.DequantizedWeight() - weight);
+  for (size_t o = 0; o < weight.n_rows; ++o)
+    REQUIRE(weightError.row(o).max() <= layer.WeightScales()[o] / 2 + 1e-12);
+
+  arma::mat output(12, 30);
+  layer.Forward(input, output);
+
+  arma::mat expected = weight * input;
+  expected.each_col() += bias;
+  REQUIRE(arma::norm(output - expected, "fro") / arma::norm(expected, "fro") <
+      0.02);
+
+  // The layer can't be trained.
+  arma::mat g;
+  REQUIRE_THROWS_AS(layer.Backward(input, output, g), std::logic_error);
+
+  // The input size must match the weights.
+  QuantizedLinear wrongLayer(weight, bias, 1.0);
+  wrongLayer.InputDimensions() = std::vector<size_t>({ 39 });
+  REQUIRE_THROWS_AS(wrongLayer.OutputSize(), std::invalid_argument);
+}
+
+/**
+ * Quantize a multilayer perceptron, and make sure that the quantized layers
+ * are used and that the predictions barely change.
+ */
+TEST_CASE("QuantizeFFNTest", "[ANNQuantizationTest]")
+{
+  FFN<NegativeLogLikelihood, RandomInitialization> model;
+  model.Add<Linear>(64);
+  model.Add<ReLU>();
+  model.Add<Dropout>(0.3);
+  model.Add<LinearNoBias>(32);
+  model.Add<Sigmoid>();
+  model.Add<Linear>(5);
+  model.Add<LogSoftMax>();
+  model.InputDimensions() = std::vector<size_t>({ 20 });
+  model.Reset();
+
+  arma::mat calibrationData(20, 100, arma::fill::randn);
+  arma::mat data(20, 300, arma::fill::randn);
+
+  FFN<NegativeLogLikelihood, RandomInitialization> quantizedModel(model);
+  Quantize(quantizedModel, calibrationData);
+
+  // Only the weights of the float layers are left: none.
+  REQUIRE(quantizedModel.Parameters().n_elem == 0);
+  REQUIRE(dynamic_cast<QuantizedLinear*>(quantizedModel.Network()[0]) !=
+      nullptr);
+  REQUIRE(dynamic_cast<QuantizedLinear*>(quantizedModel.Network()[3]) !=
+      nullptr);
+  REQUIRE(dynamic_cast<QuantizedLinear*>(quantizedModel.Network()[5]) !=
+      nullptr);
+
+  const QuantizationReport report = CompareQuantized(model, quantizedModel,
+      data);
+  REQUIRE(report.meanAbsoluteError <= report.maxAbsoluteError);
+  REQUIRE(report.relativeError < 0.05);
+  REQUIRE(report.agreement > 0.95);
+
+  // The original model is untouched.
+  arma::mat predictions, quantizedPredictions;
+  model.Predict(data, predictions);
+  quantizedModel.Predict(data, quantizedPredictions);
+  REQUIRE(arma::abs(predictions - quantizedPredictions).max() ==
+      Approx(report.maxAbsoluteError));
+
+  // Quantizing without calibration data is an error.
+  REQUIRE_THROWS_AS(Quantize(model, arma::mat(20, 0)), std::invalid_argument);
+}
+
+/**
+ * Quantize a convolutional network in which some layers keep their float
+ * weights, and check that the compiled plan of the quantized network gives the
+ * same predictions.
+ */
+TEST_CASE("QuantizeConvolutionalFFNTest", "[ANNQuantizationTest]")
+{
+  FFN<NegativeLogLikelihood, RandomInitialization> model;
+  model.Add<Convolution>(4, 3, 3, 1, 1, 1, 1);
+  model.Add<ReLU>();
+  model.Add<MaxPooling>(2, 2, 2, 2);
+  model.Add<Convolution>(3, 3, 3, 2, 2);
+  model.Add<LeakyReLU>();
+  model.Add<Linear3D>(2);
+  model.Add<Linear>(3);
+  model.Add<LogSoftMax>();
+  model.InputDimensions() = std::vector<size_t>({ 10, 10, 2 });
+  model.Reset();
+
+  arma::mat calibrationData(200, 64, arma::fill::randu);
+  arma::mat data(200, 100, arma::fill::randu);
+
+  FFN<NegativeLogLikelihood, RandomInitialization> quantizedModel(model);
+  Quantize(quantizedModel, calibrationData, 16);
+
+  REQUIRE(dynamic_cast<QuantizedConvolution*>(quantizedModel.Network()[0]) !=
+      nullptr);
+  REQUIRE(dynamic_cast<QuantizedConvolution*>(quantizedModel.Network()[3]) !=
+      nullptr);
+  REQUIRE(dynamic_cast<QuantizedLinear*>(quantizedModel.Network()[6]) !=
+      nullptr);
+
+  // The Linear3D layer keeps its weights.
+  const Linear3D* linear3D =
+      dynamic_cast<const Linear3D*>(model.Network()[5]);
+  REQUIRE(quantizedModel.Parameters().n_elem == linear3D->WeightSize());
+  CheckMatrices(arma::mat(quantizedModel.Parameters()),
+      arma::vectorise(linear3D->Parameters()));
+
+  const QuantizationReport report = CompareQuantized(model, quantizedModel,
+      data);
+  REQUIRE(report.relativeError < 0.05);
+  REQUIRE(report.agreement > 0.95);
+
+  arma::mat quantizedPredictions, planPredictions;
+  quantizedModel.Predict(data, quantizedPredictions);
+  const InferencePlan<> plan = quantizedModel.CompileForInference(8);
+  plan.Predict(data, planPredictions);
+  CheckMatrices(quantizedPredictions, planPredictions, 1e-8);
+
+  // The quantized model can't be trained.
+  arma::mat labels = arma::randi<arma::mat>(1, 100, arma::distr_param(0, 2));
+  REQUIRE_THROWS_AS(quantizedModel.Train(data, labels), std::logic_error);
+}
+
+/**
+ * Make sure that quantized networks (with their 8-bit weights) can be
+ * serialized.
+ */
+TEST_CASE("QuantizedFFNSerializationTest", "[ANNQuantizationTest]")
+{
+  FFN<NegativeLogLikelihood, RandomInitialization> model;
+  model.Add<Convolution>(2, 3, 3, 1, 1, 1, 1);
+  model.Add<ReLU>();
+  model.Add<Linear>(4);
+  model.Add<LogSoftMax>();
+  model.InputDimensions() = std::vector<size_t>({ 6, 6, 1 });
+  model.Reset();
+
+  arma::mat data(36, 20, arma::fill::randn);
+  Quantize(model, data);
+
+  FFN<NegativeLogLikelihood, RandomInitialization> xmlModel, jsonModel,
+      binaryModel;
+  SerializeObjectAll(model, xmlModel, jsonModel, binaryModel);
+
+  arma::mat predictions, xmlPredictions, jsonPredictions, binaryPredictions;
+  model.Predict(data, predictions);
+  xmlModel.Predict(data, xmlPredictions);
+  jsonModel.Predict(data, jsonPredictions);
+  binaryModel.Predict(data, binaryPredictions);
+
+  CheckMatrices(predictions, xmlPredictions, 1e-10);
+  CheckMatrices(predictions, jsonPredictions, 1e-10);
+  CheckMatrices(predictions, binaryPredictions, 1e-10);
+}
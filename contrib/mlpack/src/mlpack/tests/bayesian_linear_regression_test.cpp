@@ -193,3 +193,52 @@ TEST_CASE("EqualtoRidge", "[BayesianLinearRegressionTest]")
 
   REQUIRE(trial <= 3);
 }
+
+// Check that training on chunks of the data gives the same model as training
+// on all of the data at once.
+TEST_CASE("BayesianLinearRegressionChunkedTrain",
+          "[BayesianLinearRegressionTest]")
+{
+  arma::mat matX;
+  arma::rowvec y;
+
+  GenerateProblem(matX, y, 1000, 10, 1);
+  matX += 50.0;
+
+  for (size_t center = 0; center < 2; ++center)
+  {
+    for (size_t scale = 0; scale < 2; ++scale)
+    {
+      BayesianLinearRegression estimator(center, scale);
+      estimator.Train(matX, y);
+
+      // Serve the data in chunks of (at most) 300 points.
+      size_t begin = 0;
+      auto source = [&](arma::mat& data, arma::rowvec& responses)
+      {
+        if (begin >= matX.n_cols)
+          return false;
+
+        const size_t end = std::min(begin + 300, (size_t) matX.n_cols) - 1;
+        data = matX.cols(begin, end);
+        responses = y.subvec(begin, end);
+        begin = end + 1;
+        return true;
+      };
+
+      BayesianLinearRegression chunked(center, scale);
+      const double rmse = chunked.Train(source);
+
+      REQUIRE(rmse == Approx(estimator.RMSE(matX, y)).epsilon(1e-6));
+      REQUIRE(chunked.Alpha() == Approx(estimator.Alpha()).epsilon(1e-6));
+      REQUIRE(chunked.Beta() == Approx(estimator.Beta()).epsilon(1e-6));
+      REQUIRE(chunked.ResponsesOffset() ==
+          Approx(estimator.ResponsesOffset()).epsilon(1e-8));
+      for (size_t i = 0; i < estimator.Omega().n_elem; ++i)
+      {
+        REQUIRE(chunked.Omega()[i] ==
+            Approx(estimator.Omega()[i]).epsilon(1e-6));
+      }
+    }
+  }
+}
@@ -1399,3 +1399,36 @@ TEST_CASE("DifferentMaximumDepthTest", "[DecisionTreeTest]")
   REQUIRE(d2.Child(0).NumChildren() == 2);
   REQUIRE(d2.Child(1).NumChildren() == 2);
 }
+
+/**
+ * Make sure that the split search over dimensions finds the informative
+ * dimension, and that the chosen split does not depend on the number of
+ * threads used to search the dimensions.
+ */
+TEST_CASE("DecisionStumpParallelSplitSearchTest", "[DecisionTreeTest]")
+{
+  arma::mat dataset(20, 2000, arma::fill::randu);
+  arma::Row<size_t> labels(2000);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    labels[i] = (dataset(13, i) > 0.4) ? 1 : 0;
+  arma::rowvec weights(2000, arma::fill::randu);
+
+  DecisionTree<> d(dataset, labels, 2, weights, 10, 1e-7, 2);
+
+  REQUIRE(d.NumChildren() == 2);
+  REQUIRE(d.SplitDimension() == 13);
+
+  #ifdef HAS_OPENMP
+  const int threads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  DecisionTree<> d1(dataset, labels, 2, weights, 10, 1e-7, 2);
+  omp_set_num_threads(threads);
+
+  REQUIRE(d1.SplitDimension() == d.SplitDimension());
+
+  arma::Row<size_t> predictions, predictions1;
+  d.Classify(dataset, predictions);
+  d1.Classify(dataset, predictions1);
+  REQUIRE(arma::accu(predictions != predictions1) == 0);
+  #endif
+}
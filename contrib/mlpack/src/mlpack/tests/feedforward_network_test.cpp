@@ -1124,3 +1124,511 @@ TEST_CASE("FFNCheckInputShapeTest", "[FeedForwardNetworkTest]")
 
   REQUIRE_THROWS_AS(model.Train(trainData, trainLabels, opt), std::logic_error);
 }
+
+/**
+ * Make sure that the forward and backward passes give the same results no
+ * matter how many threads are used to split the batch.
+ */
+TEST_CASE("FFNNumThreadsTest", "[FeedForwardNetworkTest]")
+{
+  FFN<NegativeLogLikelihood, RandomInitialization> model;
+  model.Add<Padding>(1, 1, 1, 1);
+  model.Add<MaxPooling>(2, 2, 2, 2);
+  model.Add<LeakyReLU>();
+  model.Add<Dropout>(0.3);
+  model.Add<Linear>(10);
+  model.Add<Sigmoid>();
+  model.Add<Linear>(3);
+  model.Add<LogSoftMax>();
+  model.InputDimensions() = std::vector<size_t>({ 8, 8, 2 });
+
+  // Use enough points that the layers split the batch across threads.
+  arma::mat input(128, 256, arma::fill::randn);
+  arma::mat responses = arma::randi<arma::mat>(1, 256,
+      arma::distr_param(0, 2));
+
+  FFN<NegativeLogLikelihood, RandomInitialization> model2 = model;
+  model.NumThreads() = 1;
+  model2.NumThreads() = 4;
+  REQUIRE(model2.NumThreads() == 4);
+
+  model.Reset(128);
+  model2.Reset(128);
+  model2.Parameters() = model.Parameters();
+  model.SetNetworkMode(true);
+  model2.SetNetworkMode(true);
+
+  arma::mat output, output2, gradient, gradient2;
+  math::RandomSeed(3);
+  model.Forward(input, output);
+  const double loss = model.Backward(input, responses, gradient);
+  math::RandomSeed(3);
+  model2.Forward(input, output2);
+  const double loss2 = model2.Backward(input, responses, gradient2);
+
+  CheckMatrices(output, output2);
+  CheckMatrices(gradient, gradient2);
+  REQUIRE(loss == Approx(loss2).epsilon(1e-10));
+
+  // The same holds in prediction mode.
+  model.SetNetworkMode(false);
+  model2.SetNetworkMode(false);
+  model.Predict(input, output);
+  model2.Predict(input, output2);
+  CheckMatrices(output, output2);
+}
+
+/**
+ * Make sure that a compiled inference plan of a fully connected network gives
+ * the same predictions as the network itself.
+ */
+TEST_CASE("FFNCompileForInferenceTest", "[FeedForwardNetworkTest]")
+{
+  FFN<NegativeLogLikelihood, RandomInitialization> model;
+  model.Add<Linear>(20);
+  model.Add<ReLU>();
+  model.Add<Dropout>(0.3);
+  model.Add<Linear>(15);
+  model.Add<Sigmoid>();
+  model.Add<Linear>(10);
+  model.Add<LeakyReLU>(0.1);
+  model.Add<LinearNoBias>(8);
+  model.Add<TanH>();
+  model.Add<Linear>(3);
+  model.Add<LogSoftMax>();
+  model.Reset(12);
+
+  // Make sure the biases are not all zero.
+  model.Parameters().randn();
+
+  arma::mat input(12, 50, arma::fill::randn);
+  arma::mat expected, output;
+  model.Predict(input, expected);
+
+  // Batches that do not divide the input size are processed in blocks.
+  const InferencePlan<> plan = model.CompileForInference(8);
+  REQUIRE(plan.InputSize() == 12);
+  REQUIRE(plan.OutputSize() == 3);
+  REQUIRE(plan.MaxBatchSize() == 8);
+  // Four fused linear layers, the last linear layer and the LogSoftMax layer.
+  REQUIRE(plan.NumSteps() == 6);
+  REQUIRE(plan.NumLayerSteps() == 1);
+
+  InferencePlan<>::Workspace workspace = plan.CreateWorkspace();
+  plan.Predict(input, output, workspace);
+  CheckMatrices(expected, output, 1e-8);
+
+  // Predicting a single point works too.
+  arma::mat single;
+  plan.Predict(input.col(7), single, workspace);
+  CheckMatrices(expected.col(7), single, 1e-8);
+
+  // The plan holds its own copy of the weights.
+  model.Parameters().zeros();
+  plan.Predict(input, output);
+  CheckMatrices(expected, output, 1e-8);
+
+  // The plan rejects input of the wrong size.
+  arma::mat badInput(11, 5, arma::fill::randu);
+  REQUIRE_THROWS_AS(plan.Predict(badInput, output, workspace),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure that a compiled inference plan of a convolutional network gives
+ * the same predictions as the network itself, also when used from many threads
+ * at once.
+ */
+TEST_CASE("FFNCompileForInferenceConvolutionTest", "[FeedForwardNetworkTest]")
+{
+  FFN<NegativeLogLikelihood, RandomInitialization> model;
+  model.Add<Convolution>(4, 3, 3, 1, 1, 1, 1);
+  model.Add<ReLU>();
+  model.Add<MaxPooling>(2, 2, 2, 2);
+  model.Add<Convolution>(3, 3, 3, 2, 2);
+  model.Add<LeakyReLU>();
+  model.Add<Linear>(3);
+  model.Add<LogSoftMax>();
+  model.InputDimensions() = std::vector<size_t>({ 10, 10, 2 });
+  model.Reset();
+  model.Parameters().randn();
+
+  arma::mat input(200, 37, arma::fill::randn);
+  arma::mat expected;
+  model.Predict(input, expected);
+
+  const InferencePlan<> plan = model.CompileForInference(5);
+  // Two fused convolutions, the pooling layer, one linear layer and the
+  // LogSoftMax layer.
+  REQUIRE(plan.NumSteps() == 5);
+  REQUIRE(plan.NumLayerSteps() == 2);
+
+  arma::mat output(3, input.n_cols);
+  #pragma omp parallel
+  {
+    InferencePlan<>::Workspace workspace = plan.CreateWorkspace();
+
+    #pragma omp for
+    for (omp_size_t i = 0; i < (omp_size_t) input.n_cols; ++i)
+    {
+      arma::mat prediction;
+      plan.Predict(input.col(i), prediction, workspace);
+      output.col(i) = prediction;
+    }
+  }
+
+  CheckMatrices(expected, output, 1e-8);
+
+  plan.Predict(input, output);
+  CheckMatrices(expected, output, 1e-8);
+}
+
+/**
+ * Train a network with single-precision data and weights on the thyroid
+ * dataset.
+ */
+TEST_CASE("FFNFloatNetworkTest", "[FeedForwardNetworkTest]")
+{
+  arma::fmat trainData;
+  if (!data::Load("thyroid_train.csv", trainData))
+    FAIL("Cannot open thyroid_train.csv");
+
+  arma::fmat trainLabels = trainData.row(trainData.n_rows - 1);
+  trainData.shed_row(trainData.n_rows - 1);
+  trainLabels -= 1; // Labels should be from 0 to numClasses - 1.
+
+  arma::fmat testData;
+  if (!data::Load("thyroid_test.csv", testData))
+    FAIL("Cannot load dataset thyroid_test.csv");
+
+  arma::fmat testLabels = testData.row(testData.n_rows - 1);
+  testData.shed_row(testData.n_rows - 1);
+  testLabels -= 1; // Labels should be from 0 to numClasses - 1.
+
+  FFN<NegativeLogLikelihoodType<arma::fmat>, RandomInitialization,
+      arma::fmat> model;
+  model.Add<LinearType<arma::fmat>>(8);
+  model.Add<SigmoidType<arma::fmat>>();
+  model.Add<DropoutType<arma::fmat>>(0.1);
+  model.Add<LinearType<arma::fmat>>(3);
+  model.Add<LogSoftMaxType<arma::fmat>>();
+
+  TestNetwork<arma::fmat>(model, trainData, trainLabels, testData, testLabels,
+      10, 0.1);
+}
+
+/**
+ * Make sure that a single-precision network with the same weights as a
+ * double-precision network gives nearly the same predictions, objective and
+ * gradient.
+ */
+TEST_CASE("FFNFloatDoubleAgreementTest", "[FeedForwardNetworkTest]")
+{
+  FFN<NegativeLogLikelihood, RandomInitialization> model;
+  model.Add<Convolution>(3, 3, 3, 1, 1, 1, 1);
+  model.Add<ReLU>();
+  model.Add<MaxPooling>(2, 2, 2, 2);
+  model.Add<Linear3D>(4);
+  model.Add<TanH>();
+  model.Add<LinearNoBias>(6);
+  model.Add<Add>();
+  model.Add<Linear>(3);
+  model.Add<LogSoftMax>();
+  model.InputDimensions() = std::vector<size_t>({ 8, 8, 2 });
+  model.Reset();
+  model.Parameters().randn();
+  model.Parameters() *= 0.3;
+
+  FFN<NegativeLogLikelihoodType<arma::fmat>, RandomInitialization,
+      arma::fmat> floatModel;
+  floatModel.Add<ConvolutionType<Im2ColConvolution<ValidConvolution>,
+      Im2ColConvolution<FullConvolution>, Im2ColConvolution<ValidConvolution>,
+      arma::fmat>>(3, 3, 3, 1, 1, 1, 1);
+  floatModel.Add<ReLUType<arma::fmat>>();
+  floatModel.Add<MaxPoolingType<arma::fmat>>(2, 2, 2, 2);
+  floatModel.Add<Linear3DType<arma::fmat>>(4);
+  floatModel.Add<TanHType<arma::fmat>>();
+  floatModel.Add<LinearNoBiasType<arma::fmat>>(6);
+  floatModel.Add<AddType<arma::fmat>>();
+  floatModel.Add<LinearType<arma::fmat>>(3);
+  floatModel.Add<LogSoftMaxType<arma::fmat>>();
+  floatModel.InputDimensions() = std::vector<size_t>({ 8, 8, 2 });
+  // The weights are set before the first pass, so that the layers use them.
+  floatModel.Parameters() =
+      arma::conv_to<arma::fmat>::from(model.Parameters());
+
+  arma::mat data(128, 30, arma::fill::randu);
+  arma::mat labels = arma::randi<arma::mat>(1, 30, arma::distr_param(0, 2));
+  const arma::fmat floatData = arma::conv_to<arma::fmat>::from(data);
+  const arma::fmat floatLabels = arma::conv_to<arma::fmat>::from(labels);
+
+  arma::mat predictions;
+  arma::fmat floatPredictions;
+  model.Predict(data, predictions);
+  floatModel.Predict(floatData, floatPredictions);
+  CheckMatrices(predictions, arma::conv_to<arma::mat>::from(floatPredictions),
+      1e-3);
+
+  arma::mat gradient;
+  arma::fmat floatGradient;
+  model.ResetData(data, labels);
+  floatModel.ResetData(floatData, floatLabels);
+  const double objective = model.EvaluateWithGradient(model.Parameters(), 0,
+      gradient, 30);
+  const float floatObjective = floatModel.EvaluateWithGradient(
+      floatModel.Parameters(), 0, floatGradient, 30);
+  REQUIRE(floatObjective == Approx(objective).epsilon(1e-4));
+  REQUIRE(arma::norm(arma::conv_to<arma::mat>::from(floatGradient) - gradient)
+      <= 1e-4 * arma::norm(gradient));
+}
+
+/**
+ * Make sure that single-precision networks can be serialized.
+ */
+TEST_CASE("FFNFloatSerializationTest", "[FeedForwardNetworkTest]")
+{
+  typedef FFN<NegativeLogLikelihoodType<arma::fmat>, RandomInitialization,
+      arma::fmat> FloatFFN;
+
+  FloatFFN model;
+  model.Add<ConvolutionType<Im2ColConvolution<ValidConvolution>,
+      Im2ColConvolution<FullConvolution>, Im2ColConvolution<ValidConvolution>,
+      arma::fmat>>(2, 3, 3);
+  model.Add<LeakyReLUType<arma::fmat>>();
+  model.Add<DropConnectType<arma::fmat>>(10);
+  model.Add<SigmoidType<arma::fmat>>();
+  model.Add<LinearType<arma::fmat>>(3);
+  model.Add<LogSoftMaxType<arma::fmat>>();
+  model.InputDimensions() = std::vector<size_t>({ 6, 6, 1 });
+
+  arma::fmat data(36, 40, arma::fill::randu);
+  arma::fmat labels = arma::randi<arma::fmat>(1, 40,
+      arma::distr_param(0, 2));
+  ens::RMSProp opt(0.01, 8, 0.88, 1e-8, 2 * data.n_cols, -1);
+  model.Train(data, labels, opt);
+
+  FloatFFN xmlModel, jsonModel, binaryModel;
+  xmlModel.Add<LinearType<arma::fmat>>(10); // Layer that will get removed.
+
+  SerializeObjectAll(model, xmlModel, jsonModel, binaryModel);
+
+  arma::fmat predictions, xmlPredictions, jsonPredictions, binaryPredictions;
+  model.Predict(data, predictions);
+  xmlModel.Predict(data, xmlPredictions);
+  jsonModel.Predict(data, jsonPredictions);
+  binaryModel.Predict(data, binaryPredictions);
+
+  const arma::mat expected = arma::conv_to<arma::mat>::from(predictions);
+  CheckMatrices(expected, arma::conv_to<arma::mat>::from(xmlPredictions),
+      1e-4);
+  CheckMatrices(expected, arma::conv_to<arma::mat>::from(jsonPredictions),
+      1e-4);
+  CheckMatrices(expected, arma::conv_to<arma::mat>::from(binaryPredictions),
+      1e-4);
+}
+
+/**
+ * Check the memory plan of a small network, with and without checkpoints.
+ */
+TEST_CASE("FFNMemoryPlanTest", "[FeedForwardNetworkTest]")
+{
+  FFN<MeanSquaredError, RandomInitialization> model;
+  model.Add<Linear>(10);
+  model.Add<ReLU>();
+  model.Add<Linear>(20);
+  model.Add<ReLU>();
+  model.Add<Linear>(5);
+  model.InputDimensions() = std::vector<size_t>({ 8 });
+
+  // Without checkpoints, all outputs but the last are kept, and the errors
+  // share two buffers of the largest size.
+  MemoryPlan<> plan = model.PlanMemory();
+  REQUIRE(plan.NumRecomputed() == 0);
+  REQUIRE(plan.OutputSize() == 60);
+  REQUIRE(plan.DeltaSize() == 40);
+  REQUIRE(plan.PredictionSize() == 40);
+  REQUIRE(plan.UnplannedSize() == 133);
+  REQUIRE(plan.PeakBytes(4) == 100 * 4 * sizeof(double));
+
+  // With an interval of 2, only the outputs of the second and fourth layers
+  // are kept; the others share one buffer.
+  model.CheckpointInterval(2);
+  plan = model.PlanMemory();
+  REQUIRE(plan.NumRecomputed() == 2);
+  REQUIRE(plan.Kept() == std::vector<bool>({ false, true, false, true, true }));
+  REQUIRE(plan.SegmentStarts() == std::vector<size_t>({ 0, 0, 2, 2, 4 }));
+  REQUIRE(plan.OutputSize() == 50);
+  REQUIRE(plan.DeltaSize() == 40);
+  REQUIRE(plan.PeakBytes(4) < plan.UnplannedBytes(4));
+}
+
+/**
+ * Make sure that the gradient is the same whether or not the outputs of the
+ * layers are recomputed during the backward pass, also with a dropout layer.
+ */
+TEST_CASE("FFNCheckpointGradientTest", "[FeedForwardNetworkTest]")
+{
+  FFN<NegativeLogLikelihood, RandomInitialization> model;
+  model.Add<Linear>(10);
+  model.Add<ReLU>();
+  model.Add<Linear>(20);
+  model.Add<Dropout>(0.3);
+  model.Add<Linear>(15);
+  model.Add<TanH>();
+  model.Add<Linear>(6);
+  model.Add<Sigmoid>();
+  model.Add<Linear>(3);
+  model.Add<LogSoftMax>();
+  model.InputDimensions() = std::vector<size_t>({ 8 });
+  model.Reset();
+
+  arma::mat data(8, 50, arma::fill::randu);
+  arma::mat labels = arma::randi<arma::mat>(1, 50, arma::distr_param(0, 2));
+  model.ResetData(data, labels);
+
+  math::RandomSeed(5);
+  arma::mat gradient;
+  const double objective = model.EvaluateWithGradient(model.Parameters(), 0,
+      gradient, 50);
+
+  for (size_t interval = 1; interval < 5; ++interval)
+  {
+    model.CheckpointInterval(interval);
+
+    math::RandomSeed(5);
+    arma::mat checkpointGradient;
+    const double checkpointObjective = model.EvaluateWithGradient(
+        model.Parameters(), 0, checkpointGradient, 50);
+
+    REQUIRE(checkpointObjective == Approx(objective).epsilon(1e-10));
+    CheckMatrices(gradient, checkpointGradient, 1e-8);
+
+    // Forward() followed by Backward() must give the same gradient.
+    math::RandomSeed(5);
+    arma::mat output, backwardGradient;
+    model.Forward(data, output);
+    model.Backward(data, labels, backwardGradient);
+    CheckMatrices(gradient, backwardGradient, 1e-8);
+  }
+}
+
+/**
+ * Make sure that training with checkpoints gives the same model as training
+ * without, and that the predictions of the model are the same as the output of
+ * Forward().
+ */
+TEST_CASE("FFNCheckpointTrainTest", "[FeedForwardNetworkTest]")
+{
+  FFN<NegativeLogLikelihood, RandomInitialization> model;
+  model.Add<Linear>(12);
+  model.Add<LeakyReLU>();
+  model.Add<Linear>(12);
+  model.Add<Sigmoid>();
+  model.Add<Linear>(12);
+  model.Add<TanH>();
+  model.Add<Linear>(3);
+  model.Add<LogSoftMax>();
+  model.InputDimensions() = std::vector<size_t>({ 5 });
+  model.Reset();
+
+  FFN<NegativeLogLikelihood, RandomInitialization> checkpointModel(model);
+  checkpointModel.CheckpointInterval(3);
+
+  arma::mat data(5, 100, arma::fill::randu);
+  arma::mat labels = arma::randi<arma::mat>(1, 100, arma::distr_param(0, 2));
+
+  ens::StandardSGD opt(0.01, 10, 300, -100, false);
+  model.Train(data, labels, opt);
+  checkpointModel.Train(data, labels, opt);
+
+  CheckMatrices(model.Parameters(), checkpointModel.Parameters(), 1e-8);
+
+  arma::mat predictions, output;
+  checkpointModel.Predict(data, predictions, 16);
+  checkpointModel.Forward(data, output);
+  CheckMatrices(predictions, output, 1e-8);
+}
+
+/**
+ * Make sure that splitting each batch across workers gives the same objective
+ * and gradient as one worker, for output layers that sum or average over the
+ * points of a batch.
+ */
+TEST_CASE("FFNDataParallelGradientTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data(6, 37, arma::fill::randu);
+  arma::mat labels = arma::randi<arma::mat>(1, 37, arma::distr_param(0, 2));
+  arma::mat responses(2, 37, arma::fill::randu);
+
+  FFN<NegativeLogLikelihood, RandomInitialization> model;
+  model.Add<Linear>(7);
+  model.Add<TanH>();
+  model.Add<Linear>(3);
+  model.Add<LogSoftMax>();
+  model.ResetData(data, labels);
+
+  FFN<MeanSquaredError, RandomInitialization> meanModel(MeanSquaredError(false));
+  meanModel.Add<Linear>(5);
+  meanModel.Add<Sigmoid>();
+  meanModel.Add<Linear>(2);
+  meanModel.ResetData(data, responses);
+
+  arma::mat gradient, meanGradient;
+  const double objective = model.EvaluateWithGradient(model.Parameters(), 2,
+      gradient, 35);
+  const double meanObjective = meanModel.EvaluateWithGradient(
+      meanModel.Parameters(), 2, meanGradient, 35);
+
+  for (size_t workers = 2; workers < 6; ++workers)
+  {
+    model.NumWorkers() = workers;
+    meanModel.NumWorkers() = workers;
+
+    arma::mat parallelGradient, parallelMeanGradient;
+    REQUIRE(model.EvaluateWithGradient(model.Parameters(), 2, parallelGradient,
+        35) == Approx(objective).epsilon(1e-10));
+    REQUIRE(meanModel.EvaluateWithGradient(meanModel.Parameters(), 2,
+        parallelMeanGradient, 35) == Approx(meanObjective).epsilon(1e-10));
+    CheckMatrices(gradient, parallelGradient, 1e-8);
+    CheckMatrices(meanGradient, parallelMeanGradient, 1e-8);
+  }
+
+  // More workers than points.
+  arma::mat smallGradient, parallelSmallGradient;
+  model.NumWorkers() = 1;
+  const double smallObjective = model.EvaluateWithGradient(model.Parameters(),
+      0, smallGradient, 3);
+  model.NumWorkers() = 8;
+  REQUIRE(model.EvaluateWithGradient(model.Parameters(), 0,
+      parallelSmallGradient, 3) == Approx(smallObjective).epsilon(1e-10));
+  CheckMatrices(smallGradient, parallelSmallGradient, 1e-8);
+}
+
+/**
+ * Make sure that training with several workers gives the same model as
+ * training with one.
+ */
+TEST_CASE("FFNDataParallelTrainTest", "[FeedForwardNetworkTest]")
+{
+  FFN<NegativeLogLikelihood, RandomInitialization> model;
+  model.Add<Linear>(10);
+  model.Add<ReLU>();
+  model.Add<Linear>(10);
+  model.Add<Sigmoid>();
+  model.Add<Linear>(3);
+  model.Add<LogSoftMax>();
+  model.InputDimensions() = std::vector<size_t>({ 4 });
+  model.Reset();
+
+  FFN<NegativeLogLikelihood, RandomInitialization> parallelModel(model);
+  parallelModel.NumWorkers() = 4;
+
+  arma::mat data(4, 200, arma::fill::randu);
+  arma::mat labels = arma::randi<arma::mat>(1, 200, arma::distr_param(0, 2));
+
+  ens::StandardSGD opt(0.01, 32, 1000, -100, false);
+  model.Train(data, labels, opt);
+  parallelModel.Train(data, labels, opt);
+
+  CheckMatrices(model.Parameters(), parallelModel.Parameters(), 1e-6);
+}
@@ -0,0 +1,155 @@
+/**
+ * @file tests/hogwild_sgd_test.cpp
+ *
+ * Test the HogwildSGD optimizer with the linear classifiers.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/optimizers/hogwild_sgd.hpp>
+#include <mlpack/methods/logistic_regression/logistic_regression.hpp>
+#include <mlpack/methods/softmax_regression/softmax_regression.hpp>
+#include <mlpack/methods/linear_svm/linear_svm.hpp>
+
+#include "catch.hpp"
+
+using namespace mlpack;
+using namespace mlpack::optimization;
+using namespace mlpack::regression;
+using namespace mlpack::svm;
+using namespace mlpack::distribution;
+
+/**
+ * Generate a sparse dataset where each class uses its own set of features,
+ * with a few noise features shared by all classes.
+ */
+static void SparseClassData(const size_t numClasses,
+                            const size_t numPoints,
+                            arma::sp_mat& data,
+                            arma::Row<size_t>& labels)
+{
+  const size_t featuresPerClass = 50;
+  data.set_size(featuresPerClass * (numClasses + 1), numPoints);
+  labels.set_size(numPoints);
+  for (size_t i = 0; i < numPoints; ++i)
+  {
+    labels[i] = i % numClasses;
+    for (size_t k = 0; k < 3; ++k)
+    {
+      data(labels[i] * featuresPerClass + math::RandInt(featuresPerClass),
+          i) = 1.0;
+      data(numClasses * featuresPerClass + math::RandInt(featuresPerClass),
+          i) = 1.0;
+    }
+  }
+}
+
+/**
+ * Train logistic regression with HogwildSGD on a two-Gaussian dataset.
+ */
+TEST_CASE("HogwildSGDLogisticRegressionGaussianTest", "[HogwildSGDTest]")
+{
+  GaussianDistribution g1(arma::vec("1.0 1.0 1.0"), arma::eye<arma::mat>(3, 3));
+  GaussianDistribution g2(arma::vec("9.0 9.0 9.0"), arma::eye<arma::mat>(3, 3));
+
+  arma::mat data(3, 1000);
+  arma::Row<size_t> responses(1000);
+  for (size_t i = 0; i < 500; ++i)
+  {
+    data.col(i) = g1.Random();
+    responses[i] = 0;
+  }
+  for (size_t i = 500; i < 1000; ++i)
+  {
+    data.col(i) = g2.Random();
+    responses[i] = 1;
+  }
+
+  HogwildSGD hogwild(0.01, 20, 1e-8);
+  LogisticRegression<> lr(data.n_rows, 0.0);
+  lr.Train(data, responses, hogwild);
+
+  REQUIRE(lr.ComputeAccuracy(data, responses) ==
+      Approx(100.0).epsilon(0.005));
+}
+
+/**
+ * Train each of the linear classifiers with HogwildSGD on sparse data.
+ */
+TEST_CASE("HogwildSGDSparseLinearClassifiersTest", "[HogwildSGDTest]")
+{
+  arma::sp_mat data;
+  arma::Row<size_t> labels;
+
+  HogwildSGD hogwild(0.1, 10, 1e-8);
+
+  SparseClassData(2, 1000, data, labels);
+  LogisticRegression<arma::sp_mat> lr(data.n_rows, 0.0001);
+  lr.Train(data, labels, hogwild);
+  REQUIRE(lr.ComputeAccuracy(data, labels) >= 99.0);
+
+  SparseClassData(4, 1000, data, labels);
+  SoftmaxRegression sr(data.n_rows, 4, true);
+  sr.Lambda() = 0.0001;
+  sr.Train(data, labels, 4, hogwild);
+  REQUIRE(sr.ComputeAccuracy(data, labels) >= 99.0);
+
+  LinearSVM<arma::sp_mat> svm(4, 0.0001);
+  svm.Train(data, labels, 4, hogwild);
+  REQUIRE(svm.ComputeAccuracy(data, labels) >= 0.99);
+}
+
+/**
+ * With a single thread, HogwildSGD is deterministic given its seed, and does
+ * not depend on the global random number generator.
+ */
+TEST_CASE("HogwildSGDDeterministicSeedTest", "[HogwildSGDTest]")
+{
+  arma::sp_mat data;
+  arma::Row<size_t> labels;
+  SparseClassData(2, 500, data, labels);
+
+  HogwildSGD hogwild(0.1, 5, 1e-8, true, 42, 1);
+
+  math::RandomSeed(1);
+  LogisticRegression<arma::sp_mat> lr1(data.n_rows, 0.0001);
+  lr1.Train(data, labels, hogwild);
+
+  math::RandomSeed(2);
+  LogisticRegression<arma::sp_mat> lr2(data.n_rows, 0.0001);
+  lr2.Train(data, labels, hogwild);
+
+  REQUIRE(arma::approx_equal(lr1.Parameters(), lr2.Parameters(), "absdiff",
+      0.0));
+
+  // A different seed should visit the points in a different order.
+  hogwild.Seed() = 43;
+  LogisticRegression<arma::sp_mat> lr3(data.n_rows, 0.0001);
+  lr3.Train(data, labels, hogwild);
+
+  REQUIRE(!arma::approx_equal(lr1.Parameters(), lr3.Parameters(), "absdiff",
+      0.0));
+}
+
+/**
+ * Multiple threads should reach the same accuracy as a single thread.
+ */
+TEST_CASE("HogwildSGDMultipleThreadsTest", "[HogwildSGDTest]")
+{
+  arma::sp_mat data;
+  arma::Row<size_t> labels;
+  SparseClassData(3, 2000, data, labels);
+
+  HogwildSGD hogwild(0.1, 10, 1e-8, true, 0, 4);
+  LinearSVM<arma::sp_mat> svm(3, 0.0001);
+  svm.Train(data, labels, 3, hogwild);
+  REQUIRE(svm.ComputeAccuracy(data, labels) >= 0.99);
+
+  hogwild.NumThreads() = 1;
+  LinearSVM<arma::sp_mat> svm1(3, 0.0001);
+  svm1.Train(data, labels, 3, hogwild);
+  REQUIRE(svm1.ComputeAccuracy(data, labels) >= 0.99);
+}
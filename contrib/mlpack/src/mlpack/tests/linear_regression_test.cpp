@@ -266,3 +266,56 @@ TEST_CASE("LinearRegressionTrainReturnObjective", "[LinearRegressionTest]")
 
   REQUIRE(std::isfinite(error) == true);
 }
+
+/**
+ * Test that training on chunks of the data gives the same model as training on
+ * all of the data at once, with and without weights and an intercept.
+ */
+TEST_CASE("LinearRegressionChunkedTrainTest", "[LinearRegressionTest]")
+{
+  // Use data that is far from the origin, so that the accumulation has to be
+  // numerically careful.
+  arma::mat dataset = arma::randu<arma::mat>(6, 2500) + 100.0;
+  arma::rowvec responses = arma::randu<arma::rowvec>(2500);
+  arma::rowvec weights = arma::randu<arma::rowvec>(2500);
+
+  for (size_t weighted = 0; weighted < 2; ++weighted)
+  {
+    for (size_t intercept = 0; intercept < 2; ++intercept)
+    {
+      const arma::rowvec w = weighted ? weights : arma::rowvec();
+
+      LinearRegression lr;
+      lr.Lambda() = 0.3;
+      lr.Train(dataset, responses, w, intercept);
+
+      // Serve the data in chunks of (at most) 700 points.
+      size_t begin = 0;
+      auto source = [&](arma::mat& chunkData, arma::rowvec& chunkResponses,
+                        arma::rowvec& chunkWeights)
+      {
+        if (begin >= dataset.n_cols)
+          return false;
+
+        const size_t end = std::min(begin + 700, (size_t) dataset.n_cols) - 1;
+        chunkData = dataset.cols(begin, end);
+        chunkResponses = responses.subvec(begin, end);
+        chunkWeights = weighted ? arma::rowvec(weights.subvec(begin, end)) :
+            arma::rowvec();
+        begin = end + 1;
+        return true;
+      };
+
+      LinearRegression lrChunked;
+      lrChunked.Lambda() = 0.3;
+      lrChunked.Train(source, intercept);
+
+      REQUIRE(lr.Parameters().n_elem == lrChunked.Parameters().n_elem);
+      for (size_t i = 0; i < lr.Parameters().n_elem; ++i)
+      {
+        REQUIRE(lr.Parameters()[i] ==
+            Approx(lrChunked.Parameters()[i]).epsilon(1e-6));
+      }
+    }
+  }
+}
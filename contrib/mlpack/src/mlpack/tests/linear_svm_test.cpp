@@ -892,6 +892,65 @@ TEST_CASE("LinearSVMSparseLBFGSTest", "[LinearSVMTest]")
   }
 }
 
+/**
+ * Make sure that the sparse gradient of a batch matches the dense gradient on
+ * every feature that receives a hinge loss gradient in the batch (and the
+ * intercept), and is zero everywhere else.  Points with no margin violations
+ * contribute nothing, so a feature can appear in the batch and still have no
+ * gradient.
+ */
+TEST_CASE("LinearSVMSparseGradientTest", "[LinearSVMTest]")
+{
+  const size_t numClasses = 3;
+  arma::sp_mat dataset;
+  dataset.sprandu(100, 200, 0.02);
+  arma::Row<size_t> labels(200);
+  for (size_t i = 0; i < 200; ++i)
+    labels[i] = math::RandInt(0, numClasses);
+
+  LinearSVMFunction<arma::sp_mat> svmf(dataset, labels, numClasses, 0.5, 1.0,
+      true);
+  arma::mat parameters = arma::randu<arma::mat>(101, numClasses);
+
+  const size_t firstId = 30;
+  const size_t batchSize = 16;
+  const arma::vec touched(arma::sum(arma::abs(dataset.cols(firstId,
+      firstId + batchSize - 1)), 1));
+
+  arma::mat denseGradient;
+  arma::sp_mat sparseGradient;
+  const double denseObjective = svmf.EvaluateWithGradient(parameters, firstId,
+      denseGradient, batchSize);
+  const double sparseObjective = svmf.EvaluateWithGradient(parameters, firstId,
+      sparseGradient, batchSize);
+
+  REQUIRE(sparseObjective == Approx(denseObjective).epsilon(1e-7));
+  REQUIRE(sparseGradient.n_rows == denseGradient.n_rows);
+  REQUIRE(sparseGradient.n_cols == denseGradient.n_cols);
+  for (size_t c = 0; c < numClasses; ++c)
+  {
+    for (size_t j = 0; j < touched.n_elem; ++j)
+    {
+      if (sparseGradient(j, c) != 0.0)
+      {
+        REQUIRE(touched[j] > 0);
+        REQUIRE(sparseGradient(j, c) ==
+            Approx(denseGradient(j, c)).epsilon(1e-7));
+      }
+      else
+      {
+        // Only the regularization term is left in the dense gradient.
+        REQUIRE(denseGradient(j, c) ==
+            Approx(0.5 * parameters(j, c)).epsilon(1e-7));
+      }
+    }
+
+    // The intercept is always updated.
+    REQUIRE(sparseGradient(100, c) ==
+        Approx(denseGradient(100, c)).epsilon(1e-7));
+  }
+}
+
 /**
  * Test training of linear svm for multiple classes on a complex gaussian
  * dataset using L-BFGS optimizer.
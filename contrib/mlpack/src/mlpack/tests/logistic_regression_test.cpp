@@ -835,6 +835,56 @@ TEST_CASE("LogisticRegressionSparseSGDTest", "[LogisticRegressionTest]")
         Approx(lrSparse.Parameters()[i]).epsilon(1e-5));
 }
 
+/**
+ * Make sure that the sparse gradient of a batch matches the dense gradient on
+ * every feature that appears in the batch, and is zero everywhere else.
+ */
+TEST_CASE("LogisticRegressionSparseGradientTest", "[LogisticRegressionTest]")
+{
+  arma::sp_mat dataset;
+  dataset.sprandu(100, 200, 0.02);
+  arma::Row<size_t> labels(200);
+  for (size_t i = 0; i < 200; ++i)
+    labels[i] = math::RandInt(0, 2);
+
+  LogisticRegressionFunction<arma::sp_mat> lrf(dataset, labels, 0.5);
+  arma::mat parameters(arma::randu<arma::rowvec>(101));
+
+  const size_t begin = 20;
+  const size_t batchSize = 16;
+  const arma::vec touched(arma::sum(arma::abs(dataset.cols(begin,
+      begin + batchSize - 1)), 1));
+
+  arma::mat denseGradient;
+  arma::sp_mat sparseGradient;
+  lrf.Gradient(parameters, begin, denseGradient, batchSize);
+  lrf.Gradient(parameters, begin, sparseGradient, batchSize);
+
+  REQUIRE(sparseGradient.n_rows == denseGradient.n_rows);
+  REQUIRE(sparseGradient.n_cols == denseGradient.n_cols);
+  REQUIRE(sparseGradient(0, 0) == Approx(denseGradient(0, 0)).epsilon(1e-7));
+  for (size_t j = 0; j < touched.n_elem; ++j)
+  {
+    if (touched[j] > 0)
+    {
+      REQUIRE(sparseGradient(0, j + 1) ==
+          Approx(denseGradient(0, j + 1)).epsilon(1e-7));
+    }
+    else
+    {
+      REQUIRE(sparseGradient(0, j + 1) == 0.0);
+    }
+  }
+
+  // The objective should not depend on the gradient type.
+  const double denseObjective = lrf.EvaluateWithGradient(parameters, begin,
+      denseGradient, batchSize);
+  const double sparseObjective = lrf.EvaluateWithGradient(parameters, begin,
+      sparseGradient, batchSize);
+  REQUIRE(sparseObjective == Approx(denseObjective).epsilon(1e-7));
+  REQUIRE(sparseGradient(0, 0) == Approx(denseGradient(0, 0)).epsilon(1e-7));
+}
+
 /**
  * Test multi-point classification (Classify()).
  */
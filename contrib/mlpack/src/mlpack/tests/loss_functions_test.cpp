@@ -1280,3 +1280,60 @@ TEST_CASE("NegativeLogLikelihoodLossTest", "[LossFunctionsTest]")
   REQUIRE(output.n_cols == input.n_cols);
   CheckMatrices(output, expectedOutput, 0.1);
 }
+
+/**
+ * Compute the loss and its gradient in single and double precision, and make
+ * sure they agree.
+ */
+template<template<typename> class LossType>
+void CheckFloatLoss(const arma::mat& input, const arma::mat& target)
+{
+  LossType<arma::mat> module;
+  LossType<arma::fmat> floatModule;
+
+  arma::mat output;
+  arma::fmat floatOutput;
+  const double loss = module.Forward(input, target);
+  const float floatLoss = floatModule.Forward(
+      arma::conv_to<arma::fmat>::from(input),
+      arma::conv_to<arma::fmat>::from(target));
+  module.Backward(input, target, output);
+  floatModule.Backward(arma::conv_to<arma::fmat>::from(input),
+      arma::conv_to<arma::fmat>::from(target), floatOutput);
+
+  REQUIRE(floatLoss == Approx(loss).epsilon(1e-4));
+  CheckMatrices(output, arma::conv_to<arma::mat>::from(floatOutput), 1e-2);
+}
+
+/**
+ * Simple test for the loss functions with single-precision matrices.
+ */
+TEST_CASE("FloatLossFunctionsTest", "[LossFunctionsTest]")
+{
+  const arma::mat input = arma::randu<arma::mat>(4, 10) * 0.8 + 0.1;
+  const arma::mat target = arma::randu<arma::mat>(4, 10) * 0.8 + 0.1;
+  const arma::mat signs = arma::sign(arma::randn<arma::mat>(4, 10));
+
+  CheckFloatLoss<BCELossType>(input, arma::round(target));
+  CheckFloatLoss<DiceLossType>(input, target);
+  CheckFloatLoss<EarthMoverDistanceType>(input, target);
+  CheckFloatLoss<HingeLossType>(input, signs);
+  CheckFloatLoss<HuberLossType>(input, target);
+  CheckFloatLoss<KLDivergenceType>(input, target);
+  CheckFloatLoss<L1LossType>(input, target);
+  CheckFloatLoss<LogCoshLossType>(input, target);
+  CheckFloatLoss<MeanAbsolutePercentageErrorType>(input, target);
+  CheckFloatLoss<MeanBiasErrorType>(input, target);
+  CheckFloatLoss<MeanSquaredErrorType>(input, target);
+  CheckFloatLoss<MeanSquaredLogarithmicErrorType>(input, target);
+  CheckFloatLoss<MultiLabelSoftMarginLossType>(input, arma::round(target));
+  CheckFloatLoss<PoissonNLLLossType>(input, arma::round(target * 4));
+  CheckFloatLoss<SigmoidCrossEntropyErrorType>(input, arma::round(target));
+  CheckFloatLoss<SoftMarginLossType>(input, signs);
+
+  // The margin ranking loss takes the two inputs stacked, and one target row.
+  CheckFloatLoss<MarginRankingLossType>(input.rows(0, 1),
+      signs.row(0));
+  // The triplet margin loss takes the anchor and the positive samples stacked.
+  CheckFloatLoss<TripletMarginLossType>(input, target.rows(0, 1));
+}
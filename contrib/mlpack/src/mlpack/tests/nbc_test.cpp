@@ -398,3 +398,81 @@ TEST_CASE("NaiveBayesClassifierHighDimensionsTest", "[NBCTest]")
   for (size_t i = 0; i < calcVec.n_cols; ++i)
     REQUIRE(calcVec(i) == testLabels(i));
 }
+
+/**
+ * Make sure that training incrementally on two halves of the data gives the
+ * same model as training on all of it at once.
+ */
+TEST_CASE("SeparateTrainBatchIncrementalTest", "[NBCTest]")
+{
+  arma::mat trainData;
+  if (!data::Load("trainSet.csv", trainData))
+    FAIL("Cannot load dataset");
+
+  arma::Row<size_t> labels(trainData.n_cols);
+  for (size_t i = 0; i < trainData.n_cols; ++i)
+    labels[i] = trainData(trainData.n_rows - 1, i);
+  trainData.shed_row(trainData.n_rows - 1);
+
+  NaiveBayesClassifier<> nbc(trainData, labels, 2);
+
+  const size_t half = trainData.n_cols / 2;
+  NaiveBayesClassifier<> nbcTrain(trainData.n_rows, 2);
+  nbcTrain.Train(trainData.cols(0, half - 1), labels.subvec(0, half - 1), 2,
+      true);
+  nbcTrain.Train(trainData.cols(half, trainData.n_cols - 1),
+      labels.subvec(half, trainData.n_cols - 1), 2, true);
+
+  REQUIRE(arma::approx_equal(nbc.Means(), nbcTrain.Means(), "both", 1e-7,
+      1e-7));
+  REQUIRE(arma::approx_equal(nbc.Variances(), nbcTrain.Variances(), "both",
+      1e-7, 1e-7));
+  REQUIRE(arma::approx_equal(nbc.Probabilities(), nbcTrain.Probabilities(),
+      "both", 1e-7, 1e-7));
+}
+
+/**
+ * Make sure that training from a source of chunks gives the same model as
+ * training on all of the data at once.
+ */
+TEST_CASE("NaiveBayesClassifierChunkedTrainTest", "[NBCTest]")
+{
+  arma::mat trainData;
+  arma::Row<size_t> trainLabels;
+  if (!data::Load("nbc_high_dim_train.csv", trainData))
+    FAIL("Cannot load dataset");
+  if (!data::Load("nbc_high_dim_train_labels.csv", trainLabels))
+    FAIL("Cannot load dataset");
+
+  NaiveBayesClassifier<> nbc(trainData, trainLabels, 5);
+
+  // Hand out the data in uneven chunks.
+  size_t begin = 0;
+  auto source = [&](arma::mat& chunk, arma::Row<size_t>& chunkLabels)
+  {
+    if (begin == trainData.n_cols)
+      return false;
+
+    const size_t end = std::min(begin + 37, (size_t) trainData.n_cols);
+    chunk = trainData.cols(begin, end - 1);
+    chunkLabels = trainLabels.subvec(begin, end - 1);
+    begin = end;
+    return true;
+  };
+
+  NaiveBayesClassifier<> nbcChunked;
+  nbcChunked.Train(source, 5);
+
+  REQUIRE(arma::approx_equal(nbc.Means(), nbcChunked.Means(), "both", 1e-7,
+      1e-7));
+  REQUIRE(arma::approx_equal(nbc.Variances(), nbcChunked.Variances(), "both",
+      1e-7, 1e-7));
+  REQUIRE(arma::approx_equal(nbc.Probabilities(), nbcChunked.Probabilities(),
+      "both", 1e-7, 1e-7));
+
+  // The predictions should then be the same too.
+  arma::Row<size_t> predictions, chunkedPredictions;
+  nbc.Classify(trainData, predictions);
+  nbcChunked.Classify(trainData, chunkedPredictions);
+  REQUIRE(arma::all(predictions == chunkedPredictions));
+}
@@ -29,6 +29,7 @@
 #include <mlpack/methods/reinforcement_learning/environment/acrobot.hpp>
 #include <mlpack/methods/reinforcement_learning/environment/cart_pole.hpp>
 #include <mlpack/methods/reinforcement_learning/environment/double_pole_cart.hpp>
+#include <mlpack/methods/reinforcement_learning/environment/vectorized_environment.hpp>
 #include <mlpack/methods/reinforcement_learning/policy/greedy_policy.hpp>
 #include <mlpack/methods/reinforcement_learning/training_config.hpp>
 
@@ -437,6 +438,53 @@ TEST_CASE("CartPoleWithNStepDQN", "[QLearningTest]")
   REQUIRE(converged);
 }
 
+//! Test DQN in Cart Pole task, with several copies of the environment stepped
+//! in lockstep.
+TEST_CASE("CartPoleWithVectorizedDQN", "[QLearningTest]")
+{
+  // Set up the network.
+  SimpleDQN<> network(4, 128, 128, 2);
+
+  // Set up the policy and replay method.
+  GreedyPolicy<CartPole> policy(1.0, 1000, 0.1, 0.99);
+  RandomReplay<CartPole> replayMethod(10, 10000);
+
+  // Setting all training hyperparameters.
+  TrainingConfig config;
+  config.StepSize() = 0.01;
+  config.Discount() = 0.9;
+  config.TargetNetworkSyncInterval() = 100;
+  config.ExplorationSteps() = 100;
+  config.StepLimit() = 200;
+
+  // Set up DQN agent.
+  QLearning<CartPole, decltype(network), AdamUpdate, decltype(policy)>
+      agent(config, network, policy, replayMethod);
+
+  VectorizedEnvironment<CartPole> environments(4);
+
+  bool converged = false;
+  std::vector<double> returnList;
+  size_t rollouts = 0;
+  while (!converged && rollouts < 200)
+  {
+    const std::vector<double> returns = agent.Rollout(environments, 50);
+    ++rollouts;
+
+    returnList.insert(returnList.end(), returns.begin(), returns.end());
+    if (returnList.size() > 50)
+      returnList.erase(returnList.begin(), returnList.end() - 50);
+
+    const double averageReturn = std::accumulate(returnList.begin(),
+        returnList.end(), 0.0) / returnList.size();
+    converged = (returnList.size() == 50 && averageReturn > 40);
+  }
+
+  // Each rollout takes 50 steps in each of the 4 environments.
+  REQUIRE(agent.TotalSteps() == rollouts * 200);
+  REQUIRE(converged);
+}
+
 //! Test N-step Prioritized DQN in Cart Pole task.
 TEST_CASE("CartPoleWithNStepPrioritizedDQN", "[QLearningTest]")
 {
@@ -21,6 +21,7 @@
 
 #include "catch.hpp"
 #include "serialization.hpp"
+#include "ann_test_tools.hpp"
 
 using namespace mlpack;
 using namespace mlpack::ann;
@@ -877,3 +878,141 @@ TEST_CASE("RNNFFNTest", "[RecurrentNetworkTest]")
   // Now, the weights should be the same!
   CheckMatrices(ffn.Parameters(), rnn.Parameters());
 }
+
+/**
+ * Make sure that passing a whole sequence through an LSTM layer at once gives
+ * the same outputs, errors and gradients as passing it one time step at a time.
+ */
+void CheckLSTMSequence(const size_t outSize, const size_t batchSize)
+{
+  const size_t steps = 7;
+
+  LSTM layer(outSize);
+  layer.InputDimensions() = std::vector<size_t>({ 5 });
+  layer.ComputeOutputDimensions();
+  arma::mat weights(layer.WeightSize(), 1, arma::fill::randn);
+  weights *= 0.5;
+  layer.SetWeights(weights.memptr());
+
+  arma::mat input(5, batchSize * steps, arma::fill::randn);
+  arma::mat gy(outSize, batchSize * steps, arma::fill::randn);
+
+  // Pass the time steps one at a time.
+  layer.ClearRecurrentState(steps, batchSize);
+  arma::mat stepOutputs(outSize, batchSize * steps);
+  for (size_t s = 0; s < steps; ++s)
+  {
+    layer.CurrentStep() = s;
+    layer.PreviousStep() = (s == 0) ? size_t(-1) : s - 1;
+
+    arma::mat output(outSize, batchSize);
+    layer.Forward(input.cols(s * batchSize, (s + 1) * batchSize - 1), output);
+    stepOutputs.cols(s * batchSize, (s + 1) * batchSize - 1) = output;
+  }
+
+  // Now pass them all at once.
+  layer.ClearRecurrentState(steps, batchSize);
+  layer.CurrentStep() = 0;
+  layer.PreviousStep() = size_t(-1);
+  arma::mat output(outSize, batchSize * steps);
+  layer.ForwardSequence(input, output, steps, true);
+
+  REQUIRE(layer.PreviousStep() == steps - 1);
+  CheckMatrices(stepOutputs, output, 1e-8);
+
+  // Backpropagate one step at a time (with the default implementation of the
+  // base class) and all at once.
+  arma::mat stepG(5, batchSize * steps), g(5, batchSize * steps);
+  arma::mat stepGradient(layer.WeightSize(), 1);
+  arma::mat gradient(layer.WeightSize(), 1);
+  layer.PreviousStep() = size_t(-1);
+  layer.RecurrentLayer<arma::mat>::BackwardSequence(input, output, gy, stepG,
+      stepGradient, steps);
+  layer.BackwardSequence(input, output, gy, g, gradient, steps);
+
+  CheckMatrices(stepG, g, 1e-8);
+  CheckMatrices(stepGradient, gradient, 1e-8);
+}
+
+TEST_CASE("LSTMSequenceTest", "[RecurrentNetworkTest]")
+{
+  // All the steps fit in one block.
+  CheckLSTMSequence(4, 3);
+  // The steps are processed in several blocks.
+  CheckLSTMSequence(64, 40);
+}
+
+/**
+ * Check the gradient of an RNN with an LSTM layer numerically, on a batch that
+ * is not the whole dataset, with one response per time step or with a single
+ * response per sequence.
+ */
+TEST_CASE("GradientLSTMRNNTest", "[RecurrentNetworkTest]")
+{
+  struct GradientFunction
+  {
+    GradientFunction(const bool single) :
+        model(6, single)
+    {
+      model.Add<Linear>(5);
+      model.Add<LSTM>(4);
+      model.Add<TanH>();
+      model.Add<Linear>(2);
+
+      model.ResetData(arma::randn<arma::cube>(3, 8, 6),
+          arma::randn<arma::cube>(2, 8, single ? 1 : 6));
+      model.Reset(3);
+    }
+
+    double Gradient(arma::mat& gradient)
+    {
+      return model.EvaluateWithGradient(model.Parameters(), 2, gradient, 5);
+    }
+
+    arma::mat& Parameters() { return model.Parameters(); }
+
+    RNN<MeanSquaredError> model;
+  };
+
+  GradientFunction function(false);
+  REQUIRE(CheckGradient(function) <= 1e-5);
+
+  GradientFunction singleFunction(true);
+  REQUIRE(CheckGradient(singleFunction) <= 1e-5);
+}
+
+/**
+ * Make sure that truncating BPTT doesn't change the objective, and that it
+ * matches the objective computed without the gradient.
+ */
+TEST_CASE("TruncatedBPTTObjectiveTest", "[RecurrentNetworkTest]")
+{
+  RNN<MeanSquaredError> model(20);
+  model.Add<LSTM>(6);
+  model.Add<Linear>(2);
+
+  model.ResetData(arma::randn<arma::cube>(3, 10, 20),
+      arma::randn<arma::cube>(2, 10, 20));
+  model.Reset(3);
+
+  arma::mat gradient;
+  const double fullObjective = model.EvaluateWithGradient(model.Parameters(),
+      0, gradient, 10);
+  const double objective = model.Evaluate(model.Parameters(), 0, 10);
+  REQUIRE(objective == Approx(fullObjective).epsilon(1e-10));
+
+  // With shorter truncations, the first time steps are passed through the
+  // network in several chunks.
+  const size_t truncations[] = { 1, 3, 7 };
+  for (const size_t bpttSteps : truncations)
+  {
+    model.BPTTSteps() = bpttSteps;
+    arma::mat truncatedGradient;
+    const double truncatedObjective = model.EvaluateWithGradient(
+        model.Parameters(), 0, truncatedGradient, 10);
+
+    REQUIRE(truncatedObjective == Approx(fullObjective).epsilon(1e-10));
+    REQUIRE(truncatedGradient.n_elem == gradient.n_elem);
+    REQUIRE(arma::norm(truncatedGradient - gradient) > 0.0);
+  }
+}
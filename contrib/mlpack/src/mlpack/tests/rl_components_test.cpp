@@ -20,6 +20,7 @@
 #include <mlpack/methods/reinforcement_learning/environment/continuous_double_pole_cart.hpp>
 #include <mlpack/methods/reinforcement_learning/environment/acrobot.hpp>
 #include <mlpack/methods/reinforcement_learning/environment/pendulum.hpp>
+#include <mlpack/methods/reinforcement_learning/environment/vectorized_environment.hpp>
 #include <mlpack/methods/reinforcement_learning/replay/random_replay.hpp>
 #include <mlpack/methods/reinforcement_learning/policy/greedy_policy.hpp>
 
@@ -271,6 +272,124 @@ TEST_CASE("RandomReplayTest", "[RLComponentsTest]")
   }
 }
 
+/**
+ * Check that storing the transitions of several environments at once gives the
+ * same memory as storing them one at a time, each environment with its own
+ * memory for n-step transitions.
+ */
+TEST_CASE("RandomReplayBatchStoreTest", "[RLComponentsTest]")
+{
+  const size_t numEnvironments = 3;
+  for (size_t nSteps = 1; nSteps <= 3; nSteps += 2)
+  {
+    RandomReplay<CartPole> batchReplay(1, 10 * numEnvironments, nSteps);
+    std::vector<RandomReplay<CartPole>> replays(numEnvironments,
+        RandomReplay<CartPole>(1, 10, nSteps));
+
+    VectorizedEnvironment<CartPole> envs(numEnvironments);
+    std::vector<CartPole::Action> actions(numEnvironments);
+    // Take enough steps to fill the memory and write over some of it.
+    for (size_t step = 0; step < 15; ++step)
+    {
+      for (size_t i = 0; i < numEnvironments; ++i)
+        actions[i].action = (CartPole::Action::actions) math::RandInt(2);
+      envs.Step(actions);
+
+      batchReplay.Store(envs.PreviousStates(), actions, envs.Rewards(),
+          envs.NextStates(), envs.IsTerminal(), 0.9);
+      for (size_t i = 0; i < numEnvironments; ++i)
+      {
+        replays[i].Store(envs.PreviousStates()[i], actions[i],
+            envs.Rewards()[i], envs.NextStates()[i], envs.IsTerminal()[i],
+            0.9);
+      }
+    }
+
+    REQUIRE(batchReplay.Size() == 10 * numEnvironments);
+
+    // Every transition of the batch memory is in the memory of one
+    // environment.
+    arma::mat sampledStates, sampledNextStates;
+    std::vector<CartPole::Action> sampledActions;
+    arma::rowvec sampledRewards;
+    arma::irowvec sampledTerminal;
+    for (size_t t = 0; t < 20; ++t)
+    {
+      batchReplay.Sample(sampledStates, sampledActions, sampledRewards,
+          sampledNextStates, sampledTerminal);
+
+      bool found = false;
+      for (size_t i = 0; i < numEnvironments && !found; ++i)
+      {
+        for (size_t u = 0; u < 200 && !found; ++u)
+        {
+          arma::mat states, nextStates;
+          std::vector<CartPole::Action> a;
+          arma::rowvec rewards;
+          arma::irowvec terminal;
+          replays[i].Sample(states, a, rewards, nextStates, terminal);
+          found = arma::approx_equal(states, sampledStates, "absdiff", 1e-12) &&
+              arma::approx_equal(nextStates, sampledNextStates, "absdiff",
+              1e-12) && (a[0].action == sampledActions[0].action) &&
+              (std::abs(rewards[0] - sampledRewards[0]) < 1e-12) &&
+              (terminal[0] == sampledTerminal[0]);
+        }
+      }
+      REQUIRE(found);
+    }
+  }
+}
+
+/**
+ * Check that a VectorizedEnvironment steps each copy as the environment itself
+ * does, and resets the copies whose episode ends.
+ */
+TEST_CASE("VectorizedEnvironmentTest", "[RLComponentsTest]")
+{
+  const size_t numEnvironments = 5;
+  VectorizedEnvironment<CartPole> envs(numEnvironments, CartPole(20));
+  REQUIRE(envs.NumEnvironments() == numEnvironments);
+  REQUIRE(envs.EncodedStates().n_rows == CartPole::State::dimension);
+  REQUIRE(envs.EncodedStates().n_cols == numEnvironments);
+
+  CartPole reference(20);
+  std::vector<CartPole::Action> actions(numEnvironments);
+  size_t episodes = 0;
+  for (size_t step = 0; step < 100; ++step)
+  {
+    for (size_t i = 0; i < numEnvironments; ++i)
+      actions[i].action = (CartPole::Action::actions) ((step + i) % 2);
+    envs.Step(actions);
+
+    for (size_t i = 0; i < numEnvironments; ++i)
+    {
+      CartPole::State nextState;
+      const double reward = reference.Sample(envs.PreviousStates()[i],
+          actions[i], nextState);
+      CheckMatrices(nextState.Encode(), envs.NextStates()[i].Encode());
+      REQUIRE(reward == Approx(envs.Rewards()[i]).epsilon(1e-12));
+
+      if (envs.IsTerminal()[i])
+      {
+        // The copy must have been reset.
+        REQUIRE(envs.Environments()[i].StepsPerformed() == 0);
+      }
+      else
+      {
+        CheckMatrices(nextState.Encode(), envs.States()[i].Encode());
+      }
+      CheckMatrices(envs.States()[i].Encode(), envs.EncodedStates().col(i));
+    }
+
+    episodes += envs.EpisodeReturns().size();
+    REQUIRE(envs.EpisodeReturns().size() ==
+        (size_t) arma::accu(envs.IsTerminal()));
+  }
+
+  // With at most 20 steps per episode, each copy finished at least 5 episodes.
+  REQUIRE(episodes >= 5 * numEnvironments);
+}
+
 /**
  * Construct a greedy policy instance and check if it works as
  * it should be.
@@ -286,3 +405,38 @@ TEST_CASE("GreedyPolicyTest", "[RLComponentsTest]")
   REQUIRE(actionValue[action.action] ==
       Approx(actionValue.max()).epsilon(1e-7));
 }
+
+/**
+ * Check that the batch version of GreedyPolicy::Sample() selects the best
+ * action of each column when it does not explore.
+ */
+TEST_CASE("GreedyPolicyBatchTest", "[RLComponentsTest]")
+{
+  GreedyPolicy<Acrobot> policy(1.0, 10, 0.0, 0.99);
+  const size_t numActions = Acrobot::Action::size;
+  arma::mat actionValues = arma::randn<arma::mat>(numActions, 50);
+  std::vector<Acrobot::Action> actions;
+
+  // With epsilon = 1, the actions are random, but valid.
+  policy.Sample(actionValues, actions);
+  REQUIRE(actions.size() == 50);
+  for (size_t i = 0; i < actions.size(); ++i)
+    REQUIRE((size_t) actions[i].action < numActions);
+
+  // Deterministic sampling is greedy.
+  policy.Sample(actionValues, actions, true);
+  for (size_t i = 0; i < actions.size(); ++i)
+  {
+    REQUIRE(actionValues(actions[i].action, i) ==
+        Approx(actionValues.col(i).max()).epsilon(1e-12));
+  }
+
+  for (size_t i = 0; i < 15; ++i)
+    policy.Anneal();
+  policy.Sample(actionValues, actions);
+  for (size_t i = 0; i < actions.size(); ++i)
+  {
+    REQUIRE(actions[i].action ==
+        policy.Sample(arma::colvec(actionValues.col(i))).action);
+  }
+}
@@ -35,7 +35,7 @@ TEST_CASE("SoftmaxRegressionFunctionEvaluate", "[SoftmaxRegressionTest]")
     labels(i) = math::RandInt(0, numClasses);
 
   // Create a SoftmaxRegressionFunction. Regularization term ignored.
-  SoftmaxRegressionFunction srf(data, labels, numClasses, 0);
+  SoftmaxRegressionFunction<> srf(data, labels, numClasses, 0);
 
   // Run a number of trials.
   for (size_t i = 0; i < trials; ++i)
@@ -82,9 +82,9 @@ TEST_CASE("SoftmaxRegressionFunctionRegularizationEvaluate",
     labels(i) = math::RandInt(0, numClasses);
 
   // 3 objects for comparing regularization costs.
-  SoftmaxRegressionFunction srfNoReg(data, labels, numClasses, 0);
-  SoftmaxRegressionFunction srfSmallReg(data, labels, numClasses, 1);
-  SoftmaxRegressionFunction srfBigReg(data, labels, numClasses, 20);
+  SoftmaxRegressionFunction<> srfNoReg(data, labels, numClasses, 0);
+  SoftmaxRegressionFunction<> srfSmallReg(data, labels, numClasses, 1);
+  SoftmaxRegressionFunction<> srfBigReg(data, labels, numClasses, 20);
 
   // Run a number of trials.
   for (size_t i = 0; i < trials; ++i)
@@ -125,8 +125,8 @@ TEST_CASE("SoftmaxRegressionFunctionGradient",
 
   // 2 objects for 2 terms in the cost function. Each term contributes towards
   // the gradient and thus need to be checked independently.
-  SoftmaxRegressionFunction srf1(data, labels, numClasses, 0);
-  SoftmaxRegressionFunction srf2(data, labels, numClasses, 20);
+  SoftmaxRegressionFunction<> srf1(data, labels, numClasses, 0);
+  SoftmaxRegressionFunction<> srf2(data, labels, numClasses, 20);
 
   // Create a random set of parameters.
   arma::mat parameters;
@@ -171,6 +171,57 @@ TEST_CASE("SoftmaxRegressionFunctionGradient",
   }
 }
 
+/**
+ * Make sure that the sparse gradient of a batch matches the dense gradient on
+ * every feature that appears in the batch (and the intercept), and is zero
+ * everywhere else.
+ */
+TEST_CASE("SoftmaxRegressionFunctionSparseGradient", "[SoftmaxRegressionTest]")
+{
+  const size_t numClasses = 4;
+  arma::sp_mat data;
+  data.sprandu(100, 200, 0.02);
+  arma::Row<size_t> labels(200);
+  for (size_t i = 0; i < 200; ++i)
+    labels[i] = math::RandInt(0, numClasses);
+
+  SoftmaxRegressionFunction<arma::sp_mat> srf(data, labels, numClasses, 0.5,
+      true);
+  arma::mat parameters = arma::randu<arma::mat>(numClasses, 101);
+
+  const size_t begin = 50;
+  const size_t batchSize = 16;
+  const arma::vec touched(arma::sum(arma::abs(data.cols(begin,
+      begin + batchSize - 1)), 1));
+
+  arma::mat denseGradient;
+  arma::sp_mat sparseGradient;
+  srf.Gradient(parameters, begin, denseGradient, batchSize);
+  srf.Gradient(parameters, begin, sparseGradient, batchSize);
+
+  REQUIRE(sparseGradient.n_rows == denseGradient.n_rows);
+  REQUIRE(sparseGradient.n_cols == denseGradient.n_cols);
+  for (size_t c = 0; c < numClasses; ++c)
+  {
+    // The intercept is always updated.
+    REQUIRE(sparseGradient(c, 0) ==
+        Approx(denseGradient(c, 0)).epsilon(1e-7));
+
+    for (size_t j = 0; j < touched.n_elem; ++j)
+    {
+      if (touched[j] > 0)
+      {
+        REQUIRE(sparseGradient(c, j + 1) ==
+            Approx(denseGradient(c, j + 1)).epsilon(1e-7));
+      }
+      else
+      {
+        REQUIRE(sparseGradient(c, j + 1) == 0.0);
+      }
+    }
+  }
+}
+
 TEST_CASE("SoftmaxRegressionTwoClasses", "[SoftmaxRegressionTest]")
 {
   const size_t points = 1000;